@@ -0,0 +1,29 @@
+#include "Elite/Log.hpp"
+
+#include <iostream>
+
+using namespace ELITE;
+
+// Print the decoded messages in the same layout as the default log handler
+class PrintLogHandler : public LogHandler {
+   public:
+    void log(const char* file, int line, LogLevel loglevel, const char* log) override {
+        static const char* const LEVEL_NAMES[] = {"DEBUG", "INFO", "WARN", "ERROR", "FATAL", "NONE"};
+        int index = (int)loglevel;
+        const char* name = (index >= 0 && index <= (int)LogLevel::ELI_NONE) ? LEVEL_NAMES[index] : "UNKNOWN";
+        std::cout << "[" << name << "] " << file << ":" << line << ": " << log << "\n";
+    }
+};
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cout << "Usage: " << argv[0] << " <binary log file>" << std::endl;
+        return 1;
+    }
+    PrintLogHandler handler;
+    if (!decodeBinaryLog(argv[1], handler)) {
+        std::cout << "Could not decode the whole file: " << argv[1] << std::endl;
+        return 1;
+    }
+    return 0;
+}
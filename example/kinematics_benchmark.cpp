@@ -0,0 +1,102 @@
+#include <Elite/CartesianSpeedConverter.hpp>
+#include <Elite/Kinematics.hpp>
+#include <Elite/PrimaryPortInterface.hpp>
+#include <Elite/RobotConfPackage.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+
+using namespace std::chrono;
+
+// Measure the forward and inverse kinematics throughput of the scalar and the batch path,
+// and the cost of one speedl to speedj conversion.
+// Usage: kinematics_benchmark [robot_ip]. Without an IP, nominal DH parameters are used.
+
+static const int POINT_COUNT = 100000;
+static const int ROUNDS = 20;
+
+int main(int argc, const char** argv) {
+    const double pi = std::acos(-1.0);
+    ELITE::vector6d_t dh_a = {0, -0.427, -0.3905, 0, 0, 0};
+    ELITE::vector6d_t dh_d = {0.1632, 0, 0, 0.1545, 0.1165, 0.1035};
+    ELITE::vector6d_t dh_alpha = {pi / 2, 0, 0, pi / 2, -pi / 2, 0};
+    if (argc > 1) {
+        auto primary = std::make_unique<ELITE::PrimaryPortInterface>();
+        auto kin = std::make_shared<ELITE::KinematicsInfo>();
+        if (!primary->connect(argv[1], 30001) || !primary->getPackage(kin, 200)) {
+            std::cout << "Read DH parameters from " << argv[1] << " fail" << std::endl;
+            return 1;
+        }
+        primary->disconnect();
+        dh_a = kin->dh_a_;
+        dh_d = kin->dh_d_;
+        dh_alpha = kin->dh_alpha_;
+    }
+    ELITE::Kinematics kinematics(dh_a, dh_d, dh_alpha);
+
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<double> dist(-pi, pi);
+    ELITE::Vector6dBatch joints(POINT_COUNT);
+    for (auto& column : joints.values) {
+        for (auto& q : column) {
+            q = dist(rng);
+        }
+    }
+
+    // Keep the results alive so the loops are not optimized out
+    double checksum = 0;
+    auto start = steady_clock::now();
+    for (int round = 0; round < ROUNDS; round++) {
+        for (int i = 0; i < POINT_COUNT; i++) {
+            checksum += kinematics.forward(joints.get(i))[0];
+        }
+    }
+    double scalar_s = duration<double>(steady_clock::now() - start).count();
+
+    ELITE::Vector6dBatch poses;
+    start = steady_clock::now();
+    for (int round = 0; round < ROUNDS; round++) {
+        kinematics.forward(joints, poses);
+        checksum += poses.values[0][round];
+    }
+    double batch_s = duration<double>(steady_clock::now() - start).count();
+
+    double total = (double)POINT_COUNT * ROUNDS;
+    std::cout << "Forward scalar: " << total / scalar_s / 1e6 << " M points/s" << std::endl;
+    std::cout << "Forward batch:  " << total / batch_s / 1e6 << " M points/s" << std::endl;
+
+    if (kinematics.isAnalyticInverseSupported()) {
+        ELITE::vector6d_t result;
+        start = steady_clock::now();
+        for (int i = 0; i < POINT_COUNT; i++) {
+            if (kinematics.inverse(poses.get(i), joints.get(i), result)) {
+                checksum += result[0];
+            }
+        }
+        double inverse_scalar_s = duration<double>(steady_clock::now() - start).count();
+
+        // The poses are random, so the branch selection between points is the worst case
+        ELITE::Vector6dBatch solved;
+        start = steady_clock::now();
+        size_t count = kinematics.inverse(poses, joints.get(0), solved);
+        double inverse_batch_s = duration<double>(steady_clock::now() - start).count();
+        checksum += count;
+
+        std::cout << "Inverse scalar: " << POINT_COUNT / inverse_scalar_s / 1e6 << " M points/s" << std::endl;
+        std::cout << "Inverse batch:  " << POINT_COUNT / inverse_batch_s / 1e6 << " M points/s" << std::endl;
+    }
+    ELITE::CartesianSpeedConverter converter(kinematics);
+    start = steady_clock::now();
+    for (int i = 0; i < POINT_COUNT; i++) {
+        checksum += converter.toJointSpeed(joints.get(i), {0.05, 0, 0.02, 0, 0, 0.1})[0];
+    }
+    double convert_s = duration<double>(steady_clock::now() - start).count();
+    std::cout << "Speed conversion: " << convert_s / POINT_COUNT * 1e6 << " us" << std::endl;
+
+    std::cout << "(checksum " << checksum << ")" << std::endl;
+    return 0;
+}
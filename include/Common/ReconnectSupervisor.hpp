@@ -0,0 +1,76 @@
+#ifndef __RECONNECT_SUPERVISOR_HPP__
+#define __RECONNECT_SUPERVISOR_HPP__
+
+#include "DataType.hpp"
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+
+namespace ELITE
+{
+
+/**
+ * @brief 
+ *      Keeps the state of a connection and retries the reconnect with backoff.
+ *      The retry runs in the caller thread, usually the receive thread of the connection.
+ */
+class ReconnectSupervisor {
+private:
+    mutable std::mutex mutex_;
+    bool enabled_;
+    ReconnectOptions options_;
+    ReconnectMetrics metrics_;
+    std::function<void(LinkState)> state_cb_;
+    std::atomic<LinkState> state_;
+
+    void callStateCallback(LinkState state);
+
+public:
+    ReconnectSupervisor();
+    ~ReconnectSupervisor() = default;
+
+    /**
+     * @brief Enable or disable the automatic reconnect
+     * 
+     * @param enable Enable
+     * @param options Backoff settings
+     */
+    void setEnabled(bool enable, const ReconnectOptions& options);
+
+    bool isEnabled() const;
+
+    ReconnectOptions getOptions() const;
+
+    /**
+     * @brief Set the callback called when the state changes
+     * 
+     * @param cb The callback
+     */
+    void setStateCallback(std::function<void(LinkState)> cb);
+
+    /**
+     * @brief Change the state and call the callback if the state is different
+     * 
+     * @param state The new state
+     */
+    void setState(LinkState state);
+
+    LinkState getState() const { return state_; }
+
+    ReconnectMetrics getMetrics() const;
+
+    /**
+     * @brief Call attempt() until it returns true. The wait between two attempts grows by the backoff.
+     * 
+     * @param attempt Try once to restore the connection
+     * @param keep_running Checked during the wait, stop retrying if it returns false
+     * @return true The connection is restored
+     * @return false Disabled, stopped, or the attempts ran out. The state is DISCONNECTED.
+     */
+    bool run(const std::function<bool()>& attempt, const std::function<bool()>& keep_running);
+};
+
+} // namespace ELITE
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef __TCP_SERVER_HPP__
 #define __TCP_SERVER_HPP__
 
+#include "Log.hpp"
+
 #include <boost/asio.hpp>
 #include <memory>
 #include <functional>
@@ -16,6 +18,8 @@ private:
     int port_;
     std::unique_ptr<std::thread> server_thread_;
     std::function<void (std::shared_ptr<boost::asio::ip::tcp::socket>)> new_connect_function_;
+    // The server loop retries after an error
+    LogThrottle error_log_throttle_;
 
     /**
      * @brief TCP server loop. Run boost library async interface.
@@ -4,6 +4,9 @@
 #include "TcpServer.hpp"
 #include "ControlMode.hpp"
 #include "DataType.hpp"
+#include "AdaptiveTimeout.hpp"
+#include "ReverseLatencyMonitor.hpp"
+#include "Log.hpp"
 
 #include <boost/asio.hpp>
 #include <mutex>
@@ -24,6 +27,22 @@ private:
     std::unique_ptr<TcpServer> server_;
     std::shared_ptr<boost::asio::ip::tcp::socket> client_;
     std::mutex client_mutex_;
+    // Set when the timeout of the streaming commands adapts to the send intervals
+    std::unique_ptr<AdaptiveTimeout> adaptive_timeout_;
+    // The mode of the last frame, a change restarts the interval measurement
+    ControlMode last_mode_ = ControlMode::MODE_UNINITIALIZED;
+    // Set when the frames carry a sequence number for the script to echo
+    std::unique_ptr<ReverseLatencyMonitor> latency_monitor_;
+    // Echo bytes received but not yet a whole echo
+    std::vector<uint8_t> echo_bytes_;
+    // A closed socket fails every write until the robot reconnects
+    LogThrottle write_log_throttle_;
+
+    /**
+     * @brief Parse the echoes of the script in the received bytes
+     * 
+     */
+    void receiveEchoes(const uint8_t* data, size_t size);
 
     /**
      * @brief Not real read data. Check connection state.
@@ -38,8 +57,24 @@ private:
      */
     int write(int32_t buffer[], int size);
 
+    /**
+     * @brief Get the timeout to send with a frame, adapted in the streaming modes (servoj, speedj and trajectory).
+     *  Called with client_mutex_ locked.
+     *
+     * @param mode The mode of the frame
+     * @param timeout The timeout given by the caller
+     * @return int The timeout to send
+     */
+    int adaptTimeout(ControlMode mode, int timeout);
+
 public:
-    static const int REVERSE_DATA_SIZE = 8;
+    static const int REVERSE_DATA_SIZE = 9;
+    // Index of the control mode in a frame
+    static const int REVERSE_MODE_INDEX = 7;
+    // Index of the sequence number in a frame, 0 if the frame is not to be echoed
+    static const int REVERSE_SEQUENCE_INDEX = 8;
+    // An echo of the script: sequence number, controller cycle, cycle time (us)
+    static const int REVERSE_ECHO_SIZE = 3;
 
     ReverseInterface() = delete;
 
@@ -95,6 +130,43 @@ public:
      */
     bool isRobotConnect();
 
+    /**
+     * @brief Derive the timeout of the joint commands from the measured send intervals instead of the timeout given
+     *  with each command. The timeout given is sent until enough intervals are measured.
+     * 
+     * @param options The settings
+     * @throw EliteException ILLEGAL_PARAM if the options are invalid
+     */
+    void enableAdaptiveTimeout(const AdaptiveTimeoutOptions& options);
+
+    /**
+     * @brief Send the timeout given with each command again
+     * 
+     */
+    void disableAdaptiveTimeout();
+
+    /**
+     * @brief Get the statistics of the adaptive timeout
+     * 
+     * @return AdaptiveTimeoutStatistics Empty if the adaptive timeout is not enabled
+     */
+    AdaptiveTimeoutStatistics getAdaptiveTimeoutStatistics();
+
+    /**
+     * @brief Send a sequence number with the joint commands and trajectory actions, which the script echoes with its
+     *  controller cycle, to measure the latency of the channel.
+     * 
+     * @param enable Enable or disable. Enabling again clears the statistics.
+     */
+    void setLatencyMeasurement(bool enable);
+
+    /**
+     * @brief Get the latency statistics
+     * 
+     * @return ReverseLatencyStatistics Empty if the measurement is not enabled
+     */
+    ReverseLatencyStatistics getLatencyStatistics();
+
 };
 
 
@@ -3,6 +3,7 @@
 
 #include "TcpServer.hpp"
 #include "DataType.hpp"
+#include "Log.hpp"
 
 #include <memory>
 #include <boost/asio.hpp>
@@ -19,11 +20,14 @@ private:
         SET_TOOL_VOLTAGE = 2,
         START_FORCE_MODE = 3,
         END_FORCE_MODE = 4,
+        SET_SERVO_PARAMS = 5,
     };
 
     std::unique_ptr<TcpServer> server_;
     std::shared_ptr<boost::asio::ip::tcp::socket> client_;
     std::mutex client_mutex_;
+    // A closed socket fails every write until the robot reconnects
+    LogThrottle write_log_throttle_;
 
     /**
      * @brief Send socket data to client
@@ -117,6 +121,17 @@ public:
      */
     bool endForceMode();
 
+    /**
+     * @brief Set the parameters of servoj(), the script applies them from the next servo cycle.
+     * 
+     * @param time The duration of servoj motion
+     * @param lookahead_time Lookahead time
+     * @param gain Servo gain
+     * @return true success
+     * @return false fail
+     */
+    bool setServojParams(float time, float lookahead_time, int gain);
+
     /**
      * @brief Is robot connect to server.
      * 
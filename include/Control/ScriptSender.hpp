@@ -6,6 +6,7 @@
 #include <boost/asio.hpp>
 #include <string>
 #include <memory>
+#include <mutex>
 
 namespace ELITE
 {
@@ -14,7 +15,8 @@ class ScriptSender {
 private:
     const std::string PROGRAM_REQUEST_ = std::string("request_program");
     std::unique_ptr<TcpServer> server_;
-    const std::string& program_;
+    std::string program_;
+    std::mutex program_mutex_;
     std::shared_ptr<boost::asio::ip::tcp::socket> client_;
     boost::asio::streambuf recv_request_buffer_;
 
@@ -23,6 +25,13 @@ private:
 public:
     ScriptSender(int port, const std::string& program);
     ~ScriptSender();
+
+    /**
+     * @brief Replace the program sent on the next request
+     * 
+     * @param program The program
+     */
+    void setProgram(const std::string& program);
 };
 
 
@@ -0,0 +1,73 @@
+#ifndef __SCRIPT_TEMPLATE_HPP__
+#define __SCRIPT_TEMPLATE_HPP__
+
+#include <string>
+#include <vector>
+
+namespace ELITE
+{
+
+/**
+ * @brief
+ *      A script parsed once into literal segments and {{NAME}} placeholder slots.
+ *      Rendering writes the segments and the slot values into a presized string in one pass,
+ *      so the script can be rendered again cheaply when a value changes.
+ */
+class ScriptTemplate {
+private:
+    struct Segment {
+        // Literal text, or the placeholder name if slot >= 0
+        std::string text;
+        int slot;
+    };
+    std::vector<Segment> segments_;
+    // Placeholder names and values, indexed by slot
+    std::vector<std::string> slot_names_;
+    std::vector<std::string> slot_values_;
+    std::vector<bool> slot_set_;
+    std::vector<int> slot_uses_;
+    size_t literal_size_;
+    size_t line_count_;
+
+    void appendIndented(std::string& out, const std::string& text, const std::string& indent, bool& line_start) const;
+
+public:
+    static constexpr const char* PLACEHOLDER_BEGIN = "{{";
+    static constexpr const char* PLACEHOLDER_END = "}}";
+
+    /**
+     * @brief Parse the script
+     *
+     * @param script Script text with {{NAME}} placeholders
+     */
+    explicit ScriptTemplate(const std::string& script);
+    ~ScriptTemplate() = default;
+
+    /**
+     * @brief Set the value of a placeholder
+     *
+     * @param name Placeholder name without braces, e.g. "SERVER_IP_REPLACE"
+     * @param value The value
+     * @return true success
+     * @return false The script has no such placeholder
+     */
+    bool setValue(const std::string& name, const std::string& value);
+
+    /**
+     * @brief Render the script. Placeholders without value are kept as they are.
+     *
+     * @param indent Inserted at the beginning of every line
+     * @return std::string The script
+     */
+    std::string render(const std::string& indent = std::string()) const;
+
+    /**
+     * @brief Number of placeholder names in the script
+     *
+     */
+    size_t slotCount() const { return slot_names_.size(); }
+};
+
+} // namespace ELITE
+
+#endif
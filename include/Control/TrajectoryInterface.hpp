@@ -3,6 +3,7 @@
 
 #include "TcpServer.hpp"
 #include "DataType.hpp"
+#include "Log.hpp"
 #include <memory>
 #include <functional>
 
@@ -16,6 +17,13 @@ enum class TrajectoryMotionType : int
     SPLINE = 2      // spline
 };
 
+// Polynomial of a spline segment, sent in the blend radius slot of a SPLINE point
+enum class TrajectorySplineType : int
+{
+    CUBIC = 1,      // positions and velocities
+    QUINTIC = 2     // positions, velocities and accelerations
+};
+
 class TrajectoryInterface
 {
 public:
@@ -56,6 +64,33 @@ public:
      */
     bool writeTrajectoryPoint(const vector6d_t& positions, float time, float blend_radius, bool cartesian);
 
+    /**
+     * @brief Writes a cubic spline point onto the dedicated socket.
+     *  The robot moves from the end of the previous spline point, or from where it is, with a cubic polynomial
+     *  that reaches the positions and velocities at the given time.
+     * 
+     * @param positions Desired joint positions
+     * @param velocities Desired joint velocities at the point
+     * @param time Time for the robot to reach this point, must be greater than 0
+     * @return true 
+     * @return false 
+     */
+    bool writeTrajectorySplinePoint(const vector6d_t& positions, const vector6d_t& velocities, float time);
+
+    /**
+     * @brief Writes a quintic spline point onto the dedicated socket.
+     *  Same as the cubic one, but the polynomial also reaches the accelerations.
+     * 
+     * @param positions Desired joint positions
+     * @param velocities Desired joint velocities at the point
+     * @param accelerations Desired joint accelerations at the point
+     * @param time Time for the robot to reach this point, must be greater than 0
+     * @return true 
+     * @return false 
+     */
+    bool writeTrajectorySplinePoint(const vector6d_t& positions, const vector6d_t& velocities,
+                                    const vector6d_t& accelerations, float time);
+
     /**
      * @brief Is robot connect to server.
      * 
@@ -70,6 +105,8 @@ private:
     std::function<void(TrajectoryMotionResult)> motion_result_func_;
     std::mutex client_mutex_;
     TrajectoryMotionResult motion_result_;
+    // A closed socket fails every write until the robot reconnects
+    LogThrottle write_log_throttle_;
     
     int write(int32_t buffer[], int size);
     void receiveResult();
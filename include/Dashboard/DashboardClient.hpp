@@ -1,19 +1,72 @@
 #ifndef __DASHBOARDCLIENT_HPP__
 #define __DASHBOARDCLIENT_HPP__
 
+#include <Elite/DashboardExecutor.hpp>
 #include <Elite/DataType.hpp>
 #include <Elite/EliteException.hpp>
 #include <Elite/EliteOptions.hpp>
+#include <Elite/RobotStateMonitor.hpp>
 
+#include <atomic>
 #include <chrono>
+#include <functional>
+#include <future>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace ELITE {
 
+/**
+ * @brief Token to cancel asynchronous dashboard operations, one token can be shared by several operations.
+ *  Create it by DashboardClient::makeCancelToken().
+ */
+using DashboardCancelToken = std::shared_ptr<std::atomic<bool>>;
+
+/**
+ * @brief Options of an asynchronous dashboard operation.
+ *
+ */
+struct DashboardAsyncOptions {
+    /// Deadline of the whole operation. 0 means the default of the operation: 10s for a request and 30s for an
+    /// operation that waits for a robot state (e.g. powerOnAsync()).
+    std::chrono::milliseconds timeout{0};
+    /// Operation can be cancelled by DashboardClient::cancel(cancel_token). Can be nullptr.
+    DashboardCancelToken cancel_token;
+};
+
 class DashboardClient {
    public:
+    /**
+     * @brief Callback of a pipelined dashboard command.
+     *  success: false if the connection dropped before the response arrived.
+     *  response: The response line of the command (include "\r\n").
+     */
+    using ResponseCallback = std::function<void(bool success, const std::string& response)>;
+
+    /// Default maximum number of commands that can wait for a response at the same time.
+    static constexpr size_t DEFAULT_PIPELINE_DEPTH = 8;
+
+    /// Default deadline of a request (ms)
+    static constexpr int DEFAULT_REQUEST_TIMEOUT_MS = 10000;
+
+    /// Default deadline of an operation that waits for a robot state (ms)
+    static constexpr int DEFAULT_STATE_TIMEOUT_MS = 30000;
+
+    /**
+     * @brief Construct a client, the socket is driven by the thread that calls the functions of this class.
+     *
+     */
     ELITE_EXPORT explicit DashboardClient();
+
+    /**
+     * @brief Construct a client which is driven by a shared executor.
+     *  The asynchronous operations complete in the executor threads, the blocking functions wait for them.
+     *
+     * @param executor The executor, can be shared by many clients
+     * @note Don't call the blocking functions in a completion callback, which is run by the executor.
+     */
+    ELITE_EXPORT explicit DashboardClient(std::shared_ptr<DashboardExecutor> executor);
     ELITE_EXPORT virtual ~DashboardClient();
 
     /**
@@ -23,6 +76,7 @@ class DashboardClient {
      * @param port The IP of dashboard server port
      * @return true connected success
      * @return false connected fail
+     * @throw EliteException SOCKET_CONNECT_FAIL if the socket can not be opened or the IP is invalid
      */
     ELITE_EXPORT bool connect(const std::string& ip, int port = 29999);
 
@@ -289,16 +343,395 @@ class DashboardClient {
      */
     ELITE_EXPORT std::string sendAndReceive(const std::string& cmd);
 
+    /**
+     * @brief Send a dashboard command without waiting for the response.
+     *  The dashboard server answers commands in order, so the responses are matched to the commands in FIFO order.
+     *  If the number of commands waiting for a response reaches the pipeline depth, the command is queued and written
+     * when the response of an older command arrives.
+     *
+     * @param cmd Dashboard command
+     * @param cb Callback function that will be triggered when the response is received
+     * @return std::future<std::string> The future of the response. If the connection dropped, the future holds an
+     * EliteException.
+     * @note Without an executor, the responses are read by the thread that calls waitPipeline() or any blocking function
+     * of this class.
+     */
+    ELITE_EXPORT std::future<std::string> pipelineCommand(const std::string& cmd, ResponseCallback cb = nullptr);
+
+    /**
+     * @brief Read responses until all pipelined commands have been answered.
+     *
+     * @return true All responses received
+     * @return false The connection dropped
+     */
+    ELITE_EXPORT bool waitPipeline();
+
+    /**
+     * @brief Write all commands back-to-back and collect the responses.
+     *
+     * @param cmds Dashboard commands
+     * @return std::vector<std::string> Responses, in the same order as the commands
+     */
+    ELITE_EXPORT std::vector<std::string> sendAndReceivePipelined(const std::vector<std::string>& cmds);
+
+    /**
+     * @brief Set the maximum number of commands that can wait for a response at the same time.
+     *
+     * @param depth Pipeline depth, at least 1
+     */
+    ELITE_EXPORT void setPipelineDepth(size_t depth);
+
+    /**
+     * @brief Get the number of commands which are waiting for a response.
+     *
+     * @return size_t Number of commands
+     */
+    ELITE_EXPORT size_t pipelineInFlight();
+
+    /**
+     * @brief Set a state monitor which is updated by a data stream (e.g. RtsiIOInterface::setStateMonitor()).
+     *  While the monitor is updating, powerOn(), powerOff(), brakeRelease(), safetySystemRestart(), playProgram(),
+     * pauseProgram() and stopProgram() wait for the state change event instead of polling the dashboard. If the monitor
+     * stops updating, these functions fall back to polling.
+     *
+     * @param monitor State monitor. Pass nullptr to always poll the dashboard.
+     */
+    ELITE_EXPORT void setStateMonitor(std::shared_ptr<RobotStateMonitor> monitor);
+
+    /**
+     * @brief Create a token to cancel asynchronous operations.
+     *
+     * @return DashboardCancelToken The token
+     */
+    ELITE_EXPORT static DashboardCancelToken makeCancelToken();
+
+    /**
+     * @brief Cancel all asynchronous operations that use the token. Their futures hold an EliteException with code
+     * SOCKET_OPT_CANCEL. A command which has been written is still answered by the robot, the response is dropped.
+     *
+     * @param token Cancel token
+     */
+    ELITE_EXPORT void cancel(const DashboardCancelToken& token);
+
+    /**
+     * @brief Cancel all pending asynchronous operations of this client.
+     *
+     */
+    ELITE_EXPORT void cancelAll();
+
+    /*
+     * Asynchronous functions.
+     * They never block the calling thread. If the operation fails, the future holds an EliteException:
+     *  SOCKET_FAIL: not connected or connection dropped
+     *  TIMEOUT: the deadline of the operation expired
+     *  SOCKET_OPT_CANCEL: cancelled by cancel() or cancelAll()
+     *  DASHBOARD_NOT_EXPECT_RECIVE: the robot responded unexpectedly
+     */
+
+    /**
+     * @brief Asynchronous version of connect()
+     *
+     * @param ip The IP of dashboard server
+     * @param port The port of dashboard server
+     * @param options Deadline and cancel token
+     * @return std::future<bool> true after the welcome message is received, false if connect fail. If the socket can not
+     * be opened or the IP is invalid, the future holds an EliteException SOCKET_CONNECT_FAIL, same as connect().
+     */
+    ELITE_EXPORT std::future<bool> connectAsync(const std::string& ip, int port = 29999,
+                                                const DashboardAsyncOptions& options = DashboardAsyncOptions());
+
+    /**
+     * @brief Asynchronous version of brakeRelease()
+     *
+     * @param options Deadline and cancel token
+     * @return std::future<bool> true if the robot is running before the deadline
+     */
+    ELITE_EXPORT std::future<bool> brakeReleaseAsync(const DashboardAsyncOptions& options = DashboardAsyncOptions());
+
+    /**
+     * @brief Asynchronous version of closeSafetyDialog()
+     *
+     * @param options Deadline and cancel token
+     * @return std::future<bool> Result
+     */
+    ELITE_EXPORT std::future<bool> closeSafetyDialogAsync(const DashboardAsyncOptions& options = DashboardAsyncOptions());
+
+    /**
+     * @brief Asynchronous version of echo()
+     *
+     * @param options Deadline and cancel token
+     * @return std::future<bool> Result
+     */
+    ELITE_EXPORT std::future<bool> echoAsync(const DashboardAsyncOptions& options = DashboardAsyncOptions());
+
+    /**
+     * @brief Asynchronous version of help()
+     *
+     * @param cmd The command need help
+     * @param options Deadline and cancel token
+     * @return std::future<std::string> The help string of command
+     */
+    ELITE_EXPORT std::future<std::string> helpAsync(const std::string& cmd,
+                                                    const DashboardAsyncOptions& options = DashboardAsyncOptions());
+
+    /**
+     * @brief Asynchronous version of log()
+     *
+     * @param message Log content
+     * @param options Deadline and cancel token
+     * @return std::future<bool> Result
+     */
+    ELITE_EXPORT std::future<bool> logAsync(const std::string& message,
+                                            const DashboardAsyncOptions& options = DashboardAsyncOptions());
+
+    /**
+     * @brief Asynchronous version of popup()
+     *
+     * @param arg "-c" close message box, "-s" pop up message box
+     * @param message Message
+     * @param options Deadline and cancel token
+     * @return std::future<bool> Result
+     */
+    ELITE_EXPORT std::future<bool> popupAsync(const std::string& arg, const std::string& message = "",
+                                              const DashboardAsyncOptions& options = DashboardAsyncOptions());
+
+    /**
+     * @brief Asynchronous version of quit(), disconnect after the response
+     *
+     * @param options Deadline and cancel token
+     * @return std::future<void> Ready after the response
+     */
+    ELITE_EXPORT std::future<void> quitAsync(const DashboardAsyncOptions& options = DashboardAsyncOptions());
+
+    /**
+     * @brief Asynchronous version of reboot(), disconnect after the response
+     *
+     * @param options Deadline and cancel token
+     * @return std::future<void> Ready after the response
+     */
+    ELITE_EXPORT std::future<void> rebootAsync(const DashboardAsyncOptions& options = DashboardAsyncOptions());
+
+    /**
+     * @brief Asynchronous version of robot()
+     *
+     * @param options Deadline and cancel token
+     * @return std::future<std::string> Robot type
+     */
+    ELITE_EXPORT std::future<std::string> robotAsync(const DashboardAsyncOptions& options = DashboardAsyncOptions());
+
+    /**
+     * @brief Asynchronous version of powerOn()
+     *
+     * @param options Deadline and cancel token
+     * @return std::future<bool> true if the robot is idle or running before the deadline
+     */
+    ELITE_EXPORT std::future<bool> powerOnAsync(const DashboardAsyncOptions& options = DashboardAsyncOptions());
+
+    /**
+     * @brief Asynchronous version of powerOff()
+     *
+     * @param options Deadline and cancel token
+     * @return std::future<bool> true if the robot is powered off before the deadline
+     */
+    ELITE_EXPORT std::future<bool> powerOffAsync(const DashboardAsyncOptions& options = DashboardAsyncOptions());
+
+    /**
+     * @brief Asynchronous version of shutdown(), disconnect after the response
+     *
+     * @param options Deadline and cancel token
+     * @return std::future<void> Ready after the response
+     */
+    ELITE_EXPORT std::future<void> shutdownAsync(const DashboardAsyncOptions& options = DashboardAsyncOptions());
+
+    /**
+     * @brief Asynchronous version of speedScaling()
+     *
+     * @param options Deadline and cancel token
+     * @return std::future<int> Robot speed scaling percentage
+     */
+    ELITE_EXPORT std::future<int> speedScalingAsync(const DashboardAsyncOptions& options = DashboardAsyncOptions());
+
+    /**
+     * @brief Asynchronous version of robotMode()
+     *
+     * @param options Deadline and cancel token
+     * @return std::future<RobotMode> Robot mode
+     */
+    ELITE_EXPORT std::future<RobotMode> robotModeAsync(const DashboardAsyncOptions& options = DashboardAsyncOptions());
+
+    /**
+     * @brief Asynchronous version of safetyMode()
+     *
+     * @param options Deadline and cancel token
+     * @return std::future<SafetyMode> Safety mode
+     */
+    ELITE_EXPORT std::future<SafetyMode> safetyModeAsync(const DashboardAsyncOptions& options = DashboardAsyncOptions());
+
+    /**
+     * @brief Asynchronous version of safetySystemRestart()
+     *
+     * @param options Deadline and cancel token
+     * @return std::future<bool> true if the safety mode is normal before the deadline
+     */
+    ELITE_EXPORT std::future<bool> safetySystemRestartAsync(const DashboardAsyncOptions& options = DashboardAsyncOptions());
+
+    /**
+     * @brief Asynchronous version of runningStatus()
+     *
+     * @param options Deadline and cancel token
+     * @return std::future<TaskStatus> Task status
+     */
+    ELITE_EXPORT std::future<TaskStatus> runningStatusAsync(const DashboardAsyncOptions& options = DashboardAsyncOptions());
+
+    /**
+     * @brief Asynchronous version of unlockProtectiveStop()
+     *
+     * @param options Deadline and cancel token
+     * @return std::future<bool> Result
+     */
+    ELITE_EXPORT std::future<bool> unlockProtectiveStopAsync(const DashboardAsyncOptions& options = DashboardAsyncOptions());
+
+    /**
+     * @brief Asynchronous version of usage()
+     *
+     * @param cmd Command
+     * @param options Deadline and cancel token
+     * @return std::future<std::string> Command usage
+     */
+    ELITE_EXPORT std::future<std::string> usageAsync(const std::string& cmd,
+                                                     const DashboardAsyncOptions& options = DashboardAsyncOptions());
+
+    /**
+     * @brief Asynchronous version of version()
+     *
+     * @param options Deadline and cancel token
+     * @return std::future<std::string> Dashboard version infomation
+     */
+    ELITE_EXPORT std::future<std::string> versionAsync(const DashboardAsyncOptions& options = DashboardAsyncOptions());
+
+    /**
+     * @brief Asynchronous version of loadConfiguration()
+     *
+     * @param path Configuration path
+     * @param options Deadline and cancel token
+     * @return std::future<bool> true if the configuration is loaded before the deadline
+     */
+    ELITE_EXPORT std::future<bool> loadConfigurationAsync(const std::string& path,
+                                                          const DashboardAsyncOptions& options = DashboardAsyncOptions());
+
+    /**
+     * @brief Asynchronous version of configurationPath()
+     *
+     * @param options Deadline and cancel token
+     * @return std::future<std::string> The path of configuration
+     */
+    ELITE_EXPORT std::future<std::string> configurationPathAsync(const DashboardAsyncOptions& options = DashboardAsyncOptions());
+
+    /**
+     * @brief Asynchronous version of isConfigurationModify()
+     *
+     * @param options Deadline and cancel token
+     * @return std::future<bool> true if modified
+     */
+    ELITE_EXPORT std::future<bool> isConfigurationModifyAsync(const DashboardAsyncOptions& options = DashboardAsyncOptions());
+
+    /**
+     * @brief Asynchronous version of playProgram()
+     *
+     * @param options Deadline and cancel token
+     * @return std::future<bool> true if the task is running before the deadline
+     */
+    ELITE_EXPORT std::future<bool> playProgramAsync(const DashboardAsyncOptions& options = DashboardAsyncOptions());
+
+    /**
+     * @brief Asynchronous version of pauseProgram()
+     *
+     * @param options Deadline and cancel token
+     * @return std::future<bool> true if the task is paused before the deadline
+     */
+    ELITE_EXPORT std::future<bool> pauseProgramAsync(const DashboardAsyncOptions& options = DashboardAsyncOptions());
+
+    /**
+     * @brief Asynchronous version of stopProgram()
+     *
+     * @param options Deadline and cancel token
+     * @return std::future<bool> true if the task is stopped before the deadline
+     */
+    ELITE_EXPORT std::future<bool> stopProgramAsync(const DashboardAsyncOptions& options = DashboardAsyncOptions());
+
+    /**
+     * @brief Asynchronous version of setSpeedScaling()
+     *
+     * @param scaling Speed scaling percentage
+     * @param options Deadline and cancel token
+     * @return std::future<bool> Result
+     */
+    ELITE_EXPORT std::future<bool> setSpeedScalingAsync(int scaling,
+                                                        const DashboardAsyncOptions& options = DashboardAsyncOptions());
+
+    /**
+     * @brief Asynchronous version of getTaskPath()
+     *
+     * @param options Deadline and cancel token
+     * @return std::future<std::string> Task relative path
+     */
+    ELITE_EXPORT std::future<std::string> getTaskPathAsync(const DashboardAsyncOptions& options = DashboardAsyncOptions());
+
+    /**
+     * @brief Asynchronous version of loadTask()
+     *
+     * @param path Task path
+     * @param options Deadline and cancel token
+     * @return std::future<bool> true if the task is loaded before the deadline
+     */
+    ELITE_EXPORT std::future<bool> loadTaskAsync(const std::string& path,
+                                                 const DashboardAsyncOptions& options = DashboardAsyncOptions());
+
+    /**
+     * @brief Asynchronous version of getTaskStatus()
+     *
+     * @param options Deadline and cancel token
+     * @return std::future<TaskStatus> Task status
+     */
+    ELITE_EXPORT std::future<TaskStatus> getTaskStatusAsync(const DashboardAsyncOptions& options = DashboardAsyncOptions());
+
+    /**
+     * @brief Asynchronous version of taskIsRunning()
+     *
+     * @param options Deadline and cancel token
+     * @return std::future<bool> true if running
+     */
+    ELITE_EXPORT std::future<bool> taskIsRunningAsync(const DashboardAsyncOptions& options = DashboardAsyncOptions());
+
+    /**
+     * @brief Asynchronous version of isTaskSaved()
+     *
+     * @param options Deadline and cancel token
+     * @return std::future<bool> true if saved
+     */
+    ELITE_EXPORT std::future<bool> isTaskSavedAsync(const DashboardAsyncOptions& options = DashboardAsyncOptions());
+
+    /**
+     * @brief Asynchronous version of sendAndReceive()
+     *
+     * @param cmd Dashboard command
+     * @param cb Callback function that will be triggered when the operation completes, in an executor thread
+     * (or the thread that drives this client)
+     * @param options Deadline and cancel token
+     * @return std::future<std::string> Response
+     */
+    ELITE_EXPORT std::future<std::string> sendAndReceiveAsync(const std::string& cmd, ResponseCallback cb = nullptr,
+                                                              const DashboardAsyncOptions& options = DashboardAsyncOptions());
+
    private:
     class Impl;
     std::unique_ptr<Impl> impl_;
 
-    std::string asyncReadLine(unsigned timeout_ms = 10000);
-    void sendCommand(const std::string& cmd);
-
     std::string sendAndRequest(const std::string& cmd, const std::string& expected = "");
     bool waitForReply(const std::string& cmd, const std::string& expected,
                       const std::chrono::duration<double> timeout = std::chrono::seconds(30));
+    bool waitForState(const std::function<bool(RobotStateMonitor&, int)>& event_wait, const std::string& cmd,
+                      const std::string& expected, const std::chrono::milliseconds timeout = std::chrono::seconds(30));
 };
 
 }  // namespace ELITE
@@ -0,0 +1,48 @@
+#ifndef __DASHBOARD_EXECUTOR_HPP__
+#define __DASHBOARD_EXECUTOR_HPP__
+
+#include <Elite/EliteOptions.hpp>
+
+#include <memory>
+
+namespace ELITE {
+
+/**
+ * @brief
+ *      Threads that drive the asynchronous operations of DashboardClient.
+ *      One executor can be shared by the dashboard clients of many robots,
+ *      so a single thread serves all of their sessions.
+ *
+ */
+class DashboardExecutor {
+   public:
+    /**
+     * @brief Start the executor threads
+     *
+     * @param thread_count Number of threads, at least 1
+     */
+    ELITE_EXPORT explicit DashboardExecutor(int thread_count = 1);
+
+    /**
+     * @brief Stop and join the executor threads
+     *
+     * @note Must not be destroyed in a completion handler or callback run by this executor.
+     */
+    ELITE_EXPORT ~DashboardExecutor();
+
+    /**
+     * @brief Is the calling thread one of the executor threads
+     *
+     * @return true The calling thread is an executor thread
+     */
+    ELITE_EXPORT bool runningInThisThread();
+
+   private:
+    friend class DashboardClient;
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace ELITE
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef __ELITE__ADAPTIVE_TIMEOUT_HPP__
+#define __ELITE__ADAPTIVE_TIMEOUT_HPP__
+
+#include <Elite/EliteOptions.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace ELITE {
+
+/// Adaptive reverse channel timeout settings
+struct AdaptiveTimeoutOptions {
+    /// Fraction of the send intervals the timeout covers
+    double percentile = 0.999;
+    /// The timeout is the percentile interval * scale + margin_ms
+    double scale = 1.5;
+    int margin_ms = 5;
+    /// Bounds of the timeout (ms)
+    int min_timeout_ms = 10;
+    int max_timeout_ms = 1000;
+    /// The distribution is taken over this many most recent intervals
+    size_t window = 10000;
+    /// Until this many intervals are measured, the timeout given by the caller is sent
+    size_t min_samples = 200;
+};
+
+/// The measured send intervals and the timeout derived from them
+struct AdaptiveTimeoutStatistics {
+    /// Intervals measured since the last reset
+    uint64_t intervals = 0;
+    /// Intervals longer than the timeout sent with the frame before, the robot would have stopped on them
+    uint64_t late = 0;
+    std::chrono::microseconds last_interval{0};
+    /// Over the window
+    std::chrono::microseconds mean_interval{0};
+    std::chrono::microseconds max_interval{0};
+    std::chrono::microseconds percentile_interval{0};
+    /// The timeout sent with the last frame
+    int timeout_ms = 0;
+    /// The timeout follows the measurement, otherwise the one given by the caller is sent
+    bool adapted = false;
+};
+
+/**
+ * @brief Derives the read timeout of the reverse channel from the measured intervals between sends. The timeout sent
+ *  with a frame is how long the robot script waits for the next one, so it is set to a percentile of the recent
+ *  intervals, scaled, plus a margin: short enough to detect a stalled host quickly, long enough not to stop on normal
+ *  jitter. The intervals are kept in a histogram of 0.1 ms bins over a sliding window.
+ *
+ */
+class AdaptiveTimeout {
+   public:
+    ELITE_EXPORT explicit AdaptiveTimeout(const AdaptiveTimeoutOptions& options = AdaptiveTimeoutOptions());
+
+    /**
+     * @brief Record a send and get the timeout to send with it
+     *
+     * @param now Time of the send
+     * @param requested_ms The timeout given by the caller, sent until enough intervals are measured.
+     *  0 or less, a blocking read, is returned as is and the interval to the next send is not measured.
+     * @return int The timeout (ms)
+     */
+    ELITE_EXPORT int update(std::chrono::steady_clock::time_point now, int requested_ms);
+
+    /**
+     * @brief Do not measure the interval to the next send, e.g. after a change of control mode or a reconnection.
+     *  The distribution is kept.
+     *
+     */
+    ELITE_EXPORT void restart();
+
+    /**
+     * @brief Clear the distribution and the statistics
+     *
+     */
+    ELITE_EXPORT void reset();
+
+    ELITE_EXPORT AdaptiveTimeoutStatistics getStatistics() const;
+
+   private:
+    AdaptiveTimeoutOptions options_;
+    // Interval count per 0.1 ms bin, the last bin holds the longer ones
+    std::vector<uint32_t> histogram_;
+    // The intervals of the window (us), oldest at ring_next_ once full
+    std::vector<uint32_t> ring_;
+    size_t ring_next_ = 0;
+    uint64_t window_sum_us_ = 0;
+    // Sends until the percentile is computed again
+    int until_refresh_ = 0;
+    bool has_previous_ = false;
+    std::chrono::steady_clock::time_point previous_;
+    int previous_timeout_ms_ = 0;
+    // The timeout derived from the last refresh
+    int adapted_timeout_ms_ = 0;
+    AdaptiveTimeoutStatistics statistics_;
+
+    void refresh();
+};
+
+}  // namespace ELITE
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef __ELITE__CARTESIAN_SPEED_CONVERTER_HPP__
+#define __ELITE__CARTESIAN_SPEED_CONVERTER_HPP__
+
+#include <Elite/DataType.hpp>
+#include <Elite/EliteOptions.hpp>
+#include <Elite/Kinematics.hpp>
+
+namespace ELITE {
+
+/// Settings of CartesianSpeedConverter
+struct CartesianSpeedOptions {
+    /// Damping starts when the manipulability |det J| falls below this
+    double manipulability_threshold = 0.005;
+    /// Damping factor at manipulability 0. 0: plain inverse, which is unbounded at a singularity
+    double max_damping = 0.05;
+    /// Joint speed limits (rad/s). A faster result is scaled down as a whole, so the direction of the motion is kept.
+    /// 0: no limit for that joint
+    vector6d_t max_joint_speed = {0, 0, 0, 0, 0, 0};
+};
+
+/// How close a configuration is to a singularity. The wrist, elbow and shoulder terms are for the CS geometry.
+struct SingularityMetrics {
+    /// |det J|, 0 at any singularity
+    double manipulability = 0;
+    /// |sin(q5)|, 0 when the axes of joints 4 and 6 line up
+    double wrist = 0;
+    /// |sin(q3)|, 0 with the arm stretched or folded
+    double elbow = 0;
+    /// Distance of the wrist from the plane through the axis of joint 1 that holds the arm (m), 0 at the shoulder singularity
+    double shoulder = 0;
+    /// The damping factor used by toJointSpeed()
+    double damping = 0;
+    /// The factor toJointSpeed() applied for the joint speed limits, 1 if none was reached
+    double speed_scale = 1;
+};
+
+/**
+ * @brief Converts TCP velocities to joint velocities on the host, so a speedl() style command can be sent with
+ *  EliteDriver::writeSpeedj(). The damped least-squares solution q' = J^T (J J^T + l^2 I)^-1 v stays bounded near
+ *  singularities, and the joint speed limits are applied before sending. One conversion takes a few microseconds, fine
+ *  for every control cycle.
+ *
+ */
+class CartesianSpeedConverter {
+   public:
+    /**
+     * @brief Construct a new converter
+     *
+     * @param kinematics The arm, e.g. from the KinematicsInfo package, with its TCP offset. It is copied.
+     * @param options Damping and limits
+     */
+    ELITE_EXPORT explicit CartesianSpeedConverter(const Kinematics& kinematics,
+                                                  const CartesianSpeedOptions& options = CartesianSpeedOptions());
+
+    /**
+     * @brief Joint velocities for a TCP velocity
+     *
+     * @param joints Current joint positions (rad)
+     * @param tcp_speed [vx, vy, vz, wx, wy, wz] in the base frame, the argument of speedl()
+     * @param metrics If not null, the singularity metrics of the configuration, the damping and the speed scale
+     * @return vector6d_t Joint velocities (rad/s) for writeSpeedj()
+     */
+    ELITE_EXPORT vector6d_t toJointSpeed(const vector6d_t& joints, const vector6d_t& tcp_speed,
+                                         SingularityMetrics* metrics = nullptr) const;
+
+    /**
+     * @brief The singularity metrics of a configuration. damping and speed_scale are left at their defaults.
+     *
+     * @param joints Joint positions (rad)
+     * @return SingularityMetrics
+     */
+    ELITE_EXPORT SingularityMetrics singularity(const vector6d_t& joints) const;
+
+    const Kinematics& getKinematics() const { return kinematics_; }
+    const CartesianSpeedOptions& getOptions() const { return options_; }
+
+   private:
+    Kinematics kinematics_;
+    CartesianSpeedOptions options_;
+
+    SingularityMetrics singularity(const vector6d_t& joints, const Matrix6d& jacobian) const;
+};
+
+}  // namespace ELITE
+
+#endif
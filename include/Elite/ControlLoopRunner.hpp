@@ -0,0 +1,146 @@
+#ifndef __ELITE__CONTROL_LOOP_RUNNER_HPP__
+#define __ELITE__CONTROL_LOOP_RUNNER_HPP__
+
+#include <Elite/DataType.hpp>
+#include <Elite/EliteOptions.hpp>
+#include <Elite/RtsiHub.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ELITE {
+
+class EliteDriver;
+
+/// What the control loop sends on the reverse channel in this cycle
+enum class ControlLoopAction {
+    /// Send nothing
+    NONE,
+    /// EliteDriver::writeServoj()
+    SERVOJ,
+    /// EliteDriver::writeSpeedj()
+    SPEEDJ,
+    /// EliteDriver::writeSpeedl()
+    SPEEDL,
+    /// EliteDriver::writePose()
+    POSE,
+    /// Send idle and stop the loop
+    STOP,
+};
+
+/// The setpoint returned by the control loop callback
+struct ControlLoopCommand {
+    ControlLoopAction action = ControlLoopAction::NONE;
+    vector6d_t target{};
+};
+
+/// Control loop settings
+struct ControlLoopOptions {
+    /// A cycle overruns if the command is sent later than this after the sample was received
+    int deadline_us = 2000;
+    /// Timeout of the command sent on the reverse channel, the robot stops if no new command arrives in time
+    int command_timeout_ms = 100;
+    /// Stop the loop after this many consecutive overruns. 0: never
+    int max_consecutive_overruns = 0;
+};
+
+/// The statistics of the control loop
+struct ControlLoopStatistics {
+    /// Upper bounds (us) of the latency histogram buckets, the last bucket holds the rest
+    static constexpr std::array<int, 9> LATENCY_BUCKETS_US = {{50, 100, 200, 500, 1000, 2000, 4000, 8000, 16000}};
+
+    /// Number of callbacks
+    uint64_t cycles = 0;
+    /// Number of cycles later than the deadline
+    uint64_t overruns = 0;
+    /// Number of commands the reverse channel failed to send
+    uint64_t send_failures = 0;
+    /// Sample received to command sent
+    std::chrono::microseconds last_latency{0};
+    std::chrono::microseconds max_latency{0};
+    std::chrono::microseconds mean_latency{0};
+    /// Cycle count per latency bucket, LATENCY_BUCKETS_US.size() + 1 buckets
+    std::array<uint64_t, LATENCY_BUCKETS_US.size() + 1> latency_histogram{};
+
+    /**
+     * @brief Upper bound of the latency bucket that holds the given fraction of the cycles
+     *
+     * @param fraction e.g. 0.99
+     * @return std::chrono::microseconds Bucket upper bound, or max_latency for the last bucket
+     */
+    ELITE_EXPORT std::chrono::microseconds percentile(double fraction) const;
+};
+
+/**
+ * @brief Run a control callback in the receive thread of an RtsiHub, as soon as each sample is decoded.
+ *  The callback returns the next setpoint, which is sent on the reverse channel in the same cycle,
+ *  so there is no polling thread and no sleep between the state and the command.
+ *
+ */
+class ControlLoopRunner {
+   private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+
+   public:
+    /// Called with the fresh state every cycle. Must not block.
+    using Callback = std::function<ControlLoopCommand(const RtsiSample& state)>;
+    /// Send a command on the reverse channel
+    using Sender = std::function<bool(const ControlLoopCommand& command, int timeout_ms)>;
+
+    /**
+     * @brief Send the commands with the driver
+     *
+     * @param hub The hub that delivers the samples. It must outlive the runner.
+     * @param driver The driver. It must outlive the runner.
+     */
+    ELITE_EXPORT ControlLoopRunner(RtsiHub& hub, EliteDriver& driver);
+
+    /**
+     * @brief Send the commands with a custom sender
+     *
+     * @param hub The hub that delivers the samples. It must outlive the runner.
+     * @param sender Command sender
+     */
+    ELITE_EXPORT ControlLoopRunner(RtsiHub& hub, Sender sender);
+
+    ELITE_EXPORT ~ControlLoopRunner();
+
+    /**
+     * @brief Subscribe to the hub and run the callback for every sample
+     *
+     * @param fields Output recipe fields the callback reads
+     * @param cb Control callback
+     * @param options Settings
+     * @return true success
+     * @return false Already running
+     */
+    ELITE_EXPORT bool start(const std::vector<std::string>& fields, Callback cb,
+                            const ControlLoopOptions& options = ControlLoopOptions());
+
+    /**
+     * @brief Unsubscribe and wait for the cycle already running. No command is sent after it returns.
+     *
+     */
+    ELITE_EXPORT void stop();
+
+    /**
+     * @brief Is the loop running
+     *
+     * @return false Not started, stopped, the callback returned STOP, or too many consecutive overruns
+     */
+    ELITE_EXPORT bool isRunning();
+
+    ELITE_EXPORT ControlLoopStatistics getStatistics();
+
+    ELITE_EXPORT void resetStatistics();
+};
+
+}  // namespace ELITE
+
+#endif
@@ -13,6 +13,7 @@
 #include <Elite/EliteOptions.hpp>
 
 #include <array>
+#include <chrono>
 #include <cstdint>
 
 #if (ELITE_SDK_COMPILE_STANDARD >= 17)
@@ -143,6 +144,39 @@ enum class ForceMode : int {
     TCP,
 };
 
+/// The state of a connection which can reconnect automatically
+enum class LinkState : int {
+    DISCONNECTED,
+    CONNECTED,
+    /// The connection is lost and being restored
+    RECONNECTING,
+};
+
+/// Automatic reconnect settings
+struct ReconnectOptions {
+    /// The wait before the first attempt
+    int initial_delay_ms = 10;
+    /// The wait is multiplied by backoff after each failed attempt, up to max_delay_ms
+    double backoff = 2.0;
+    int max_delay_ms = 2000;
+    /// 0: Retry until disconnect() is called
+    int max_attempts = 0;
+    /// The primary port connection is considered lost if nothing is received for this time.
+    /// RTSI uses the receive timeout of the data package (1s).
+    int silence_timeout_ms = 1000;
+};
+
+/// The statistics of automatic reconnect
+struct ReconnectMetrics {
+    /// Number of restored connections
+    uint32_t reconnects = 0;
+    /// Number of failed attempts
+    uint32_t failed_attempts = 0;
+    /// From the connection lost being detected to the connection being restored
+    std::chrono::microseconds last_duration{0};
+    std::chrono::microseconds max_duration{0};
+};
+
 using vector3d_t = std::array<double, 3>;
 using vector6d_t = std::array<double, 6>;
 using vector6int32_t = std::array<int32_t, 6>;
@@ -2,7 +2,9 @@
 #define __ELITE__DEFATULT_LOG_HPP__
 
 #include "Log.hpp"
+#include <cstring>
 #include <iostream>
+#include <string>
 
 namespace ELITE
 {
@@ -16,28 +18,34 @@ public:
     ~DefaultLogHandler() = default;
 
     void log(const char* file, int line, LogLevel level, const char* log) {
+        const char* tag = nullptr;
         switch (level) {
         case LogLevel::ELI_DEBUG:
-            std::cout << "[DEBUG] " << file << ":" << line << ": " << log << std::endl;
+            tag = "[DEBUG] ";
             break;
         case LogLevel::ELI_INFO:
-            std::cout << "[INFO] " << file << ":" << line << ": " << log << std::endl;
+            tag = "[INFO] ";
             break;
         case LogLevel::ELI_WARN:
-            std::cout << "[WARN] " << file << ":" << line << ": " << log << std::endl;
+            tag = "[WARN] ";
             break;
         case LogLevel::ELI_ERROR:
-            std::cout << "[ERROR] " << file << ":" << line << ": " << log << std::endl;
+            tag = "[ERROR] ";
             break;
         case LogLevel::ELI_FATAL:
-            std::cout << "[FATAL] " << file << ":" << line << ": " << log << std::endl;
+            tag = "[FATAL] ";
             break;
         case LogLevel::ELI_NONE:
-            std::cout << "[NONE] " << file << ":" << line << ": " << log << std::endl;
+            tag = "[NONE] ";
             break;
         default:
-            break;
+            return;
         }
+        // Write the whole line at once, the logger flushes the stream.
+        std::string message;
+        message.reserve(64 + std::strlen(log));
+        message.append(tag).append(file).append(":").append(std::to_string(line)).append(": ").append(log).append("\n");
+        std::cout << message;
     }
 
 };
@@ -10,16 +10,34 @@
 #ifndef __ELITE_DRIVER_HPP__
 #define __ELITE_DRIVER_HPP__
 
+#include <Elite/AdaptiveTimeout.hpp>
 #include <Elite/DataType.hpp>
 #include <Elite/EliteOptions.hpp>
 #include <Elite/PrimaryPackage.hpp>
+#include <Elite/ReverseLatencyMonitor.hpp>
 
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <string>
 
 namespace ELITE {
 
+/**
+ * @brief The time spent by each phase of the EliteDriver construction
+ *
+ */
+struct EliteDriverStartupTimings {
+    // Reverse, trajectory and script command servers
+    std::chrono::microseconds servers{0};
+    // Primary port connection, which runs concurrently with the servers and the script rendering
+    std::chrono::microseconds primary_port{0};
+    // Render the script, then send it (headless mode) or start the script sender
+    std::chrono::microseconds script{0};
+    // The whole construction
+    std::chrono::microseconds total{0};
+};
+
 /**
  * @brief This is the main class for interfacing the driver.
  *  It sets up all the necessary socket connections and handles the data exchange with the robot.
@@ -72,6 +90,32 @@ class EliteDriver {
      */
     ELITE_EXPORT bool writeServoj(const vector6d_t& pos, int timeout_ms);
 
+    /**
+     * @brief Change the servoj() parameters while the control script is running.
+     *  The parameters are sent over the script command channel and used from the next servo cycle,
+     *  the script is not restarted. The parameters are also used when the script is sent again.
+     *
+     * @param servoj_time The duration of servoj motion.
+     * @param servoj_lookhead_time Time [S], range [0.03,0.2] smoothens the trajectory with this lookahead time
+     * @param servoj_gain servo gain.
+     * @return true success
+     * @return false The parameters are invalid or the robot is not connected
+     */
+    ELITE_EXPORT bool setServojParams(float servoj_time, float servoj_lookhead_time, int servoj_gain);
+
+    /**
+     * @brief Write a Cartesian servo target to robot.
+     *  The script converts the pose to joints with the inverse kinematics of the controller, seeded with the last target,
+     *  and servos to them like writeServoj(): the same servoj() parameters, and the same extrapolation when no new target
+     *  arrives in a control cycle.
+     *
+     * @param pose TCP pose ([x, y, z, rx, ry, rz]) in the base frame
+     * @param timeout_ms The read timeout configuration for the reverse socket running in the external control script on the robot.
+     * @return true
+     * @return false
+     */
+    ELITE_EXPORT bool writePose(const vector6d_t& pose, int timeout_ms);
+
     /**
      * @brief Write speedl() velocity to robot
      *
@@ -114,6 +158,34 @@ class EliteDriver {
      */
     ELITE_EXPORT bool writeTrajectoryPoint(const vector6d_t& positions, float time, float blend_radius, bool cartesian);
 
+    /**
+     * @brief Writes a cubic spline point onto the dedicated socket.
+     *  The segment starts at the end of the previous spline point, or at the current position if the previous point is not
+     *  a spline point, and reaches the positions and velocities at the given time. A smooth path needs far fewer spline
+     *  points than blended movej points.
+     *
+     * @param positions Desired joint positions
+     * @param velocities Desired joint velocities at the point
+     * @param time Time for the robot to reach this point, must be greater than 0
+     * @return true
+     * @return false
+     */
+    ELITE_EXPORT bool writeTrajectorySplinePoint(const vector6d_t& positions, const vector6d_t& velocities, float time);
+
+    /**
+     * @brief Writes a quintic spline point onto the dedicated socket. Same as the cubic one, but the segment also reaches the
+     *  accelerations.
+     *
+     * @param positions Desired joint positions
+     * @param velocities Desired joint velocities at the point
+     * @param accelerations Desired joint accelerations at the point
+     * @param time Time for the robot to reach this point, must be greater than 0
+     * @return true
+     * @return false
+     */
+    ELITE_EXPORT bool writeTrajectorySplinePoint(const vector6d_t& positions, const vector6d_t& velocities,
+                                                 const vector6d_t& accelerations, float time);
+
     /**
      * @brief Writes a control message in trajectory forward mode.
      *
@@ -266,6 +338,49 @@ class EliteDriver {
      * @return false fail
      */
     ELITE_EXPORT bool primaryReconnect();
+
+    /**
+     * @brief Get the time spent by each phase of the construction
+     *
+     * @return EliteDriverStartupTimings The timings
+     */
+    ELITE_EXPORT EliteDriverStartupTimings getStartupTimings();
+
+    /**
+     * @brief Derive the timeout of the streaming commands, writeServoj(), writeSpeedj() and
+     *  writeTrajectoryControlAction(), from the measured intervals between the calls of the same mode, instead of the
+     *  timeout_ms given with each call. The given timeout_ms is sent until enough intervals are measured, and a
+     *  timeout_ms of 0 or less (block) is always sent as given. A change of mode restarts the measurement. The other
+     *  commands keep their timeout_ms.
+     *
+     * @param enable Enable or disable
+     * @param options The settings
+     * @throw EliteException ILLEGAL_PARAM if the options are invalid
+     */
+    ELITE_EXPORT void setAdaptiveTimeout(bool enable, const AdaptiveTimeoutOptions& options = AdaptiveTimeoutOptions());
+
+    /**
+     * @brief Get the measured send intervals and the adaptive timeout
+     *
+     * @return AdaptiveTimeoutStatistics Empty if the adaptive timeout is not enabled
+     */
+    ELITE_EXPORT AdaptiveTimeoutStatistics getAdaptiveTimeoutStatistics();
+
+    /**
+     * @brief Send a sequence number with each reverse channel command, which the control script echoes with the
+     *  controller cycle in which it read the command, to measure the round trip, the one-way latencies and the
+     *  commands lost or skipped by the script.
+     *
+     * @param enable Enable or disable. Enabling again clears the statistics.
+     */
+    ELITE_EXPORT void setLatencyMeasurement(bool enable);
+
+    /**
+     * @brief Get the reverse channel latency statistics
+     *
+     * @return ReverseLatencyStatistics Empty if the measurement is not enabled
+     */
+    ELITE_EXPORT ReverseLatencyStatistics getLatencyStatistics();
 };
 
 }  // namespace ELITE
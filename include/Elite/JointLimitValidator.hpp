@@ -0,0 +1,128 @@
+#ifndef __ELITE__JOINT_LIMIT_VALIDATOR_HPP__
+#define __ELITE__JOINT_LIMIT_VALIDATOR_HPP__
+
+#include <Elite/DataType.hpp>
+#include <Elite/EliteOptions.hpp>
+#include <Elite/Kinematics.hpp>
+#include <Elite/RobotConfPackage.hpp>
+#include <Elite/TrajectoryCompressor.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace ELITE {
+
+/// The first limit violation of a joint target sequence
+struct LimitViolation {
+    enum class Type {
+        NONE,
+        POSITION,
+        VELOCITY,
+        ACCELERATION,
+    };
+    Type type = Type::NONE;
+    /// Index of the offending point
+    size_t index = 0;
+    /// The offending joint, -1 if none
+    int joint = -1;
+    /// The position, velocity or acceleration of the joint, and the limit it exceeds
+    double value = 0;
+    double limit = 0;
+
+    bool isValid() const { return type == Type::NONE; }
+};
+
+/**
+ * @brief Checks joint targets against the limits of the controller before they are sent, so a servo stream or a
+ *  trajectory is not rejected by the robot. Velocities and accelerations are finite differences of consecutive points.
+ *  Lists are checked in blocks with branch-free loops over the joint columns; only a block that fails is checked point
+ *  by point to find the first violation.
+ *
+ */
+class JointLimitValidator {
+   public:
+    /**
+     * @brief Construct from the limits read from the primary port
+     *
+     * @param info The JointLimitsInfo package
+     */
+    ELITE_EXPORT explicit JointLimitValidator(const JointLimitsInfo& info);
+
+    /**
+     * @brief Construct from limits
+     *
+     * @param limit_min Position lower limits (rad)
+     * @param limit_max Position upper limits (rad)
+     * @param max_velocity Velocity limits (rad/s)
+     * @param max_acc Acceleration limits (rad/s^2). 0: not checked
+     */
+    ELITE_EXPORT JointLimitValidator(const vector6d_t& limit_min, const vector6d_t& limit_max, const vector6d_t& max_velocity,
+                                     const vector6d_t& max_acc);
+
+    /**
+     * @brief Check a servo stream, one point per period
+     *
+     * @param points Joint targets
+     * @param period Time between points (s)
+     * @return LimitViolation The first violation, or type NONE
+     */
+    ELITE_EXPORT LimitViolation validate(const Vector6dBatch& points, double period) const;
+
+    /**
+     * @brief Check a servo stream that starts from the current joint positions
+     *
+     * @param points Joint targets
+     * @param period Time between points (s). The first point is one period after start.
+     * @param start Current joint positions
+     * @return LimitViolation The first violation, or type NONE
+     */
+    ELITE_EXPORT LimitViolation validate(const Vector6dBatch& points, double period, const vector6d_t& start) const;
+
+    /**
+     * @brief Check the joint points of writeTrajectoryPoint(), each point reached after its time
+     *
+     * @param points Joint trajectory points
+     * @param start Current joint positions
+     * @return LimitViolation The first violation, or type NONE. A point with no time is a velocity violation.
+     */
+    ELITE_EXPORT LimitViolation validate(const std::vector<TrajectoryWaypoint>& points, const vector6d_t& start) const;
+
+    /**
+     * @brief Start checking servo frames one by one from the current joint positions
+     *
+     * @param current Current joint positions
+     */
+    ELITE_EXPORT void reset(const vector6d_t& current);
+
+    /**
+     * @brief Check the next servo frame against the previous ones since reset(). A frame that fails is not remembered,
+     *  so the next one is checked against the last accepted frame, like the robot script does.
+     *
+     * @param target Joint target
+     * @param period Time since the previous frame (s)
+     * @return LimitViolation The violation, its index the number of frames accepted since reset(), or type NONE
+     */
+    ELITE_EXPORT LimitViolation checkServo(const vector6d_t& target, double period);
+
+    const vector6d_t& getLimitMin() const { return limit_min_; }
+    const vector6d_t& getLimitMax() const { return limit_max_; }
+    const vector6d_t& getMaxVelocity() const { return max_velocity_; }
+    const vector6d_t& getMaxAcc() const { return max_acc_; }
+
+   private:
+    vector6d_t limit_min_;
+    vector6d_t limit_max_;
+    vector6d_t max_velocity_;
+    vector6d_t max_acc_;
+
+    // State of checkServo()
+    vector6d_t servo_last_{};
+    vector6d_t servo_velocity_{};
+    double servo_period_ = 0;
+    bool servo_has_velocity_ = false;
+    size_t servo_count_ = 0;
+};
+
+}  // namespace ELITE
+
+#endif
@@ -0,0 +1,203 @@
+#ifndef __ELITE__KINEMATICS_HPP__
+#define __ELITE__KINEMATICS_HPP__
+
+#include <Elite/DataType.hpp>
+#include <Elite/EliteOptions.hpp>
+#include <Elite/RobotConfPackage.hpp>
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace ELITE {
+
+/// A homogeneous transform without the last row, row-major: [r00 r01 r02 x; r10 r11 r12 y; r20 r21 r22 z]
+using Transform3d = std::array<double, 12>;
+
+/// A 6x6 matrix, row-major
+using Matrix6d = std::array<double, 36>;
+
+/**
+ * @brief Many joint configurations or poses in structure-of-arrays layout: values[j][i] is element j of entry i.
+ *  The batch functions of Kinematics read and write whole columns, so the compiler can vectorize them.
+ *
+ */
+struct Vector6dBatch {
+    std::array<std::vector<double>, 6> values;
+
+    Vector6dBatch() = default;
+    explicit Vector6dBatch(size_t count) { resize(count); }
+
+    void resize(size_t count) {
+        for (auto& column : values) {
+            column.resize(count);
+        }
+    }
+
+    size_t size() const { return values[0].size(); }
+
+    void set(size_t i, const vector6d_t& v) {
+        for (size_t j = 0; j < 6; j++) {
+            values[j][i] = v[j];
+        }
+    }
+
+    vector6d_t get(size_t i) const {
+        vector6d_t v;
+        for (size_t j = 0; j < 6; j++) {
+            v[j] = values[j][i];
+        }
+        return v;
+    }
+};
+
+/**
+ * @brief Kinematics of the 6-axis arm from the DH parameters of the controller (standard DH, the same as KinematicsInfo).
+ *  Poses are [x, y, z, rx, ry, rz] in the base frame, the orientation a rotation vector, as in the robot script.
+ *
+ */
+class Kinematics {
+   public:
+    /**
+     * @brief Construct from the DH parameters read from the primary port
+     *
+     * @param info The KinematicsInfo package
+     */
+    ELITE_EXPORT explicit Kinematics(const KinematicsInfo& info);
+
+    /**
+     * @brief Construct from DH parameters
+     *
+     * @param dh_a Link lengths (m)
+     * @param dh_d Link offsets (m)
+     * @param dh_alpha Link twists (rad)
+     */
+    ELITE_EXPORT Kinematics(const vector6d_t& dh_a, const vector6d_t& dh_d, const vector6d_t& dh_alpha);
+
+    /**
+     * @brief Set the TCP offset from the flange. By default the TCP is the flange.
+     *
+     * @param tcp_offset [x, y, z, rx, ry, rz] in the flange frame
+     */
+    ELITE_EXPORT void setTcpOffset(const vector6d_t& tcp_offset);
+
+    /**
+     * @brief Forward kinematics of one configuration
+     *
+     * @param joints Joint positions (rad)
+     * @return vector6d_t The TCP pose
+     */
+    ELITE_EXPORT vector6d_t forward(const vector6d_t& joints) const;
+
+    /**
+     * @brief Forward kinematics of one configuration
+     *
+     * @param joints Joint positions (rad)
+     * @return Transform3d The TCP frame in the base frame
+     */
+    ELITE_EXPORT Transform3d forwardTransform(const vector6d_t& joints) const;
+
+    /**
+     * @brief Forward kinematics of many configurations
+     *
+     * @param joints Joint positions (rad)
+     * @param poses Output, resized to the number of configurations
+     */
+    ELITE_EXPORT void forward(const Vector6dBatch& joints, Vector6dBatch& poses) const;
+
+    /**
+     * @brief The geometric Jacobian at the TCP: TCP velocity [vx, vy, vz, wx, wy, wz] in the base frame (the velocity of
+     *  speedl()) = J * joint velocities
+     *
+     * @param joints Joint positions (rad)
+     * @return Matrix6d J, row-major
+     */
+    ELITE_EXPORT Matrix6d jacobian(const vector6d_t& joints) const;
+
+    /// At most this many inverse kinematics solutions per pose
+    static constexpr int MAX_IK_SOLUTIONS = 8;
+
+    /**
+     * @brief Is the arm geometry solved in closed form by inverse(). That is the CS geometry: link twists of
+     *  [pi/2, 0, 0, pi/2, -pi/2, 0] and no link lengths after the elbow.
+     *
+     */
+    ELITE_EXPORT bool isAnalyticInverseSupported() const;
+
+    /**
+     * @brief All inverse kinematics solutions of a pose, in closed form
+     *
+     * @param pose The TCP pose
+     * @return std::vector<vector6d_t> Up to 8 solutions, angles in [-pi, pi]. Empty if the pose is not reachable.
+     *  At a wrist singularity the last joint is 0.
+     * @throw EliteException ILLEGAL_PARAM if isAnalyticInverseSupported() is false
+     */
+    ELITE_EXPORT std::vector<vector6d_t> inverse(const vector6d_t& pose) const;
+
+    /**
+     * @brief The inverse kinematics solution nearest to a seed. Each joint is shifted by multiples of 2 pi to the one
+     *  nearest the seed, so the result may leave [-pi, pi].
+     *
+     * @param pose The TCP pose
+     * @param seed Reference joint positions, e.g. the current ones. At a wrist singularity the last joint keeps its seed.
+     * @param joints Output
+     * @return true success
+     * @return false The pose is not reachable
+     * @throw EliteException ILLEGAL_PARAM if isAnalyticInverseSupported() is false
+     */
+    ELITE_EXPORT bool inverse(const vector6d_t& pose, const vector6d_t& seed, vector6d_t& joints) const;
+
+    /**
+     * @brief Inverse kinematics of a path. Every point takes the solution nearest to the previous point, the first one the
+     *  solution nearest to the seed, so the path stays on one branch. The solutions of all points are computed in
+     *  parallel, the selection runs after.
+     *
+     * @param poses The TCP poses of the path
+     * @param seed Reference joint positions of the first point
+     * @param joints Output, resized to the number of poses
+     * @param threads Number of threads. 0: hardware concurrency
+     * @return size_t Number of points solved from the start. Less than poses.size() if a point is not reachable.
+     * @throw EliteException ILLEGAL_PARAM if isAnalyticInverseSupported() is false
+     */
+    ELITE_EXPORT size_t inverse(const Vector6dBatch& poses, const vector6d_t& seed, Vector6dBatch& joints,
+                                unsigned threads = 0) const;
+
+    /**
+     * @brief Convert a pose to a transform
+     *
+     * @param pose [x, y, z, rx, ry, rz]
+     * @return Transform3d
+     */
+    ELITE_EXPORT static Transform3d poseToTransform(const vector6d_t& pose);
+
+    /**
+     * @brief Convert a transform to a pose
+     *
+     * @param transform The transform, the rotation part must be orthonormal
+     * @return vector6d_t [x, y, z, rx, ry, rz], the rotation angle in [0, pi]
+     */
+    ELITE_EXPORT static vector6d_t transformToPose(const Transform3d& transform);
+
+    const vector6d_t& getDhA() const { return dh_a_; }
+    const vector6d_t& getDhD() const { return dh_d_; }
+    const vector6d_t& getDhAlpha() const { return dh_alpha_; }
+
+   private:
+    vector6d_t dh_a_;
+    vector6d_t dh_d_;
+    vector6d_t dh_alpha_;
+    // sin and cos of alpha, computed once
+    vector6d_t sin_alpha_;
+    vector6d_t cos_alpha_;
+    Transform3d tcp_;
+    // Inverse of tcp_
+    Transform3d tcp_inverse_;
+    bool has_tcp_ = false;
+
+    int solveInverse(const vector6d_t& pose, double singular_q6, vector6d_t* solutions) const;
+    void checkAnalyticInverse() const;
+};
+
+}  // namespace ELITE
+
+#endif
@@ -10,18 +10,112 @@
 #ifndef __ELITE__LOG_HPP__
 #define __ELITE__LOG_HPP__
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <string>
+#include <type_traits>
 #include <Elite/EliteOptions.hpp>
 
 #ifndef __REL_FILE__
 #define __REL_FILE__ __FILE__
 #endif
 
-#define ELITE_LOG_DEBUG(...) ELITE::log(__REL_FILE__, __LINE__, ELITE::LogLevel::ELI_DEBUG, __VA_ARGS__)
-#define ELITE_LOG_WARN(...) ELITE::log(__REL_FILE__, __LINE__, ELITE::LogLevel::ELI_WARN, __VA_ARGS__)
-#define ELITE_LOG_INFO(...) ELITE::log(__REL_FILE__, __LINE__, ELITE::LogLevel::ELI_INFO, __VA_ARGS__)
-#define ELITE_LOG_ERROR(...) ELITE::log(__REL_FILE__, __LINE__, ELITE::LogLevel::ELI_ERROR, __VA_ARGS__)
-#define ELITE_LOG_FATAL(...) ELITE::log(__REL_FILE__, __LINE__, ELITE::LogLevel::ELI_FATAL, __VA_ARGS__)
+// The minimum log level compiled in. Define it before including this file to override the SDK build option.
+#ifndef ELITE_LOG_COMPILE_LEVEL
+#define ELITE_LOG_COMPILE_LEVEL ELITE_SDK_LOG_MIN_LEVEL
+#endif
+
+// The first argument of the log macros must be a format string literal: in asynchronous or binary mode only its
+// pointer is stored and the message is formatted later. The "" pasted in front of it rejects anything else at compile
+// time, log a runtime string with ELITE_LOG_INFO("%s", msg.c_str()) instead.
+// The arguments are not evaluated if the level is disabled at runtime
+#define ELITE_LOG_AT_LEVEL(level, ...)                                             \
+    do {                                                                           \
+        if ((level) >= ELITE::getLogLevel()) {                                     \
+            ELITE::logFormat(__REL_FILE__, __LINE__, (level), "" __VA_ARGS__);     \
+        }                                                                          \
+    } while (0)
+
+// Log at most once per period_ms through the LogThrottle 'throttle'. The number of suppressed messages is logged with the
+// next one.
+#define ELITE_LOG_THROTTLE_AT_LEVEL(level, throttle, period_ms, ...)                                            \
+    do {                                                                                                        \
+        uint64_t elite_log_suppressed = 0;                                                                      \
+        if ((level) >= ELITE::getLogLevel() && (throttle).allow((period_ms), elite_log_suppressed)) {           \
+            ELITE::logFormat(__REL_FILE__, __LINE__, (level), "" __VA_ARGS__);                                  \
+            if (elite_log_suppressed > 0) {                                                                     \
+                ELITE::logFormat(__REL_FILE__, __LINE__, (level), "The message above was suppressed %llu times", \
+                                 (unsigned long long)elite_log_suppressed);                                     \
+            }                                                                                                   \
+        }                                                                                                       \
+    } while (0)
+
+// Log only the first time this call site is reached
+#define ELITE_LOG_ONCE_AT_LEVEL(level, ...)                                                                     \
+    do {                                                                                                        \
+        static std::atomic<bool> elite_log_done(false);                                                         \
+        if ((level) >= ELITE::getLogLevel() && !elite_log_done.exchange(true, std::memory_order_relaxed)) {     \
+            ELITE::logFormat(__REL_FILE__, __LINE__, (level), "" __VA_ARGS__);                                  \
+        }                                                                                                       \
+    } while (0)
+
+#if ELITE_LOG_COMPILE_LEVEL <= 0
+#define ELITE_LOG_DEBUG(...) ELITE_LOG_AT_LEVEL(ELITE::LogLevel::ELI_DEBUG, __VA_ARGS__)
+#define ELITE_LOG_DEBUG_THROTTLE(throttle, period_ms, ...) \
+    ELITE_LOG_THROTTLE_AT_LEVEL(ELITE::LogLevel::ELI_DEBUG, throttle, period_ms, __VA_ARGS__)
+#define ELITE_LOG_DEBUG_ONCE(...) ELITE_LOG_ONCE_AT_LEVEL(ELITE::LogLevel::ELI_DEBUG, __VA_ARGS__)
+#else
+#define ELITE_LOG_DEBUG(...) ((void)0)
+#define ELITE_LOG_DEBUG_THROTTLE(throttle, period_ms, ...) ((void)0)
+#define ELITE_LOG_DEBUG_ONCE(...) ((void)0)
+#endif
+
+#if ELITE_LOG_COMPILE_LEVEL <= 1
+#define ELITE_LOG_INFO(...) ELITE_LOG_AT_LEVEL(ELITE::LogLevel::ELI_INFO, __VA_ARGS__)
+#define ELITE_LOG_INFO_THROTTLE(throttle, period_ms, ...) \
+    ELITE_LOG_THROTTLE_AT_LEVEL(ELITE::LogLevel::ELI_INFO, throttle, period_ms, __VA_ARGS__)
+#define ELITE_LOG_INFO_ONCE(...) ELITE_LOG_ONCE_AT_LEVEL(ELITE::LogLevel::ELI_INFO, __VA_ARGS__)
+#else
+#define ELITE_LOG_INFO(...) ((void)0)
+#define ELITE_LOG_INFO_THROTTLE(throttle, period_ms, ...) ((void)0)
+#define ELITE_LOG_INFO_ONCE(...) ((void)0)
+#endif
+
+#if ELITE_LOG_COMPILE_LEVEL <= 2
+#define ELITE_LOG_WARN(...) ELITE_LOG_AT_LEVEL(ELITE::LogLevel::ELI_WARN, __VA_ARGS__)
+#define ELITE_LOG_WARN_THROTTLE(throttle, period_ms, ...) \
+    ELITE_LOG_THROTTLE_AT_LEVEL(ELITE::LogLevel::ELI_WARN, throttle, period_ms, __VA_ARGS__)
+#define ELITE_LOG_WARN_ONCE(...) ELITE_LOG_ONCE_AT_LEVEL(ELITE::LogLevel::ELI_WARN, __VA_ARGS__)
+#else
+#define ELITE_LOG_WARN(...) ((void)0)
+#define ELITE_LOG_WARN_THROTTLE(throttle, period_ms, ...) ((void)0)
+#define ELITE_LOG_WARN_ONCE(...) ((void)0)
+#endif
+
+#if ELITE_LOG_COMPILE_LEVEL <= 3
+#define ELITE_LOG_ERROR(...) ELITE_LOG_AT_LEVEL(ELITE::LogLevel::ELI_ERROR, __VA_ARGS__)
+#define ELITE_LOG_ERROR_THROTTLE(throttle, period_ms, ...) \
+    ELITE_LOG_THROTTLE_AT_LEVEL(ELITE::LogLevel::ELI_ERROR, throttle, period_ms, __VA_ARGS__)
+#define ELITE_LOG_ERROR_ONCE(...) ELITE_LOG_ONCE_AT_LEVEL(ELITE::LogLevel::ELI_ERROR, __VA_ARGS__)
+#else
+#define ELITE_LOG_ERROR(...) ((void)0)
+#define ELITE_LOG_ERROR_THROTTLE(throttle, period_ms, ...) ((void)0)
+#define ELITE_LOG_ERROR_ONCE(...) ((void)0)
+#endif
+
+#if ELITE_LOG_COMPILE_LEVEL <= 4
+#define ELITE_LOG_FATAL(...) ELITE_LOG_AT_LEVEL(ELITE::LogLevel::ELI_FATAL, __VA_ARGS__)
+#define ELITE_LOG_FATAL_THROTTLE(throttle, period_ms, ...) \
+    ELITE_LOG_THROTTLE_AT_LEVEL(ELITE::LogLevel::ELI_FATAL, throttle, period_ms, __VA_ARGS__)
+#define ELITE_LOG_FATAL_ONCE(...) ELITE_LOG_ONCE_AT_LEVEL(ELITE::LogLevel::ELI_FATAL, __VA_ARGS__)
+#else
+#define ELITE_LOG_FATAL(...) ((void)0)
+#define ELITE_LOG_FATAL_THROTTLE(throttle, period_ms, ...) ((void)0)
+#define ELITE_LOG_FATAL_ONCE(...) ((void)0)
+#endif
 
 namespace ELITE
 {
@@ -93,6 +187,220 @@ ELITE_EXPORT void log(const char* file, int line, LogLevel level, const char* fm
  */
 ELITE_EXPORT void setLogLevel(LogLevel level);
 
+/**
+ * @brief Get the current log level.
+ * 
+ * @return LogLevel The log level
+ */
+ELITE_EXPORT LogLevel getLogLevel();
+
+/**
+ * @brief A raw log argument captured by the log macros, used internally.
+ * 
+ */
+struct LogArg {
+    enum class Type : uint8_t { INT, UINT, DOUBLE, STRING, POINTER };
+    Type type;
+    union {
+        int64_t i;
+        uint64_t u;
+        double d;
+        const char* s;
+        const void* p;
+    };
+};
+
+namespace detail {
+
+template <typename T, typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value, int>::type = 0>
+inline LogArg makeLogArg(T value) {
+    LogArg arg;
+    arg.type = LogArg::Type::INT;
+    arg.i = value;
+    return arg;
+}
+
+template <typename T, typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value, int>::type = 0>
+inline LogArg makeLogArg(T value) {
+    LogArg arg;
+    arg.type = LogArg::Type::UINT;
+    arg.u = value;
+    return arg;
+}
+
+template <typename T, typename std::enable_if<std::is_enum<T>::value, int>::type = 0>
+inline LogArg makeLogArg(T value) {
+    LogArg arg;
+    arg.type = LogArg::Type::INT;
+    arg.i = static_cast<int64_t>(value);
+    return arg;
+}
+
+template <typename T, typename std::enable_if<std::is_floating_point<T>::value, int>::type = 0>
+inline LogArg makeLogArg(T value) {
+    LogArg arg;
+    arg.type = LogArg::Type::DOUBLE;
+    arg.d = value;
+    return arg;
+}
+
+inline LogArg makeLogArg(const char* value) {
+    LogArg arg;
+    arg.type = LogArg::Type::STRING;
+    arg.s = value;
+    return arg;
+}
+
+inline LogArg makeLogArg(char* value) { return makeLogArg(static_cast<const char*>(value)); }
+
+template <typename T>
+inline LogArg makeLogArg(T* value) {
+    LogArg arg;
+    arg.type = LogArg::Type::POINTER;
+    arg.p = value;
+    return arg;
+}
+
+inline LogArg makeLogArg(std::nullptr_t) { return makeLogArg(static_cast<const void*>(nullptr)); }
+
+}  // namespace detail
+
+/**
+ * @brief The state of a throttled log message, passed to the ELITE_LOG_<LEVEL>_THROTTLE macros.
+ *  Keep one per object and message, e.g. a member of the class whose loop logs the message,
+ *  so that one instance does not suppress the messages of another. It is lock-free.
+ * 
+ */
+class LogThrottle {
+   public:
+    constexpr LogThrottle() : next_ns_(0), suppressed_(0) {}
+
+    /**
+     * @brief Check whether the call site may log now.
+     * 
+     * @param period_ms Minimum interval between two messages
+     * @param suppressed Set to the number of messages suppressed since the last one, if allowed
+     * @return true Log the message
+     * @return false The message is suppressed
+     */
+    bool allow(int64_t period_ms, uint64_t& suppressed) {
+        int64_t now =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        int64_t next = next_ns_.load(std::memory_order_relaxed);
+        if (now >= next && next_ns_.compare_exchange_strong(next, now + period_ms * 1000000, std::memory_order_relaxed)) {
+            suppressed = suppressed_.exchange(0, std::memory_order_relaxed);
+            return true;
+        }
+        suppressed_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+   private:
+    std::atomic<int64_t> next_ns_;
+    std::atomic<uint64_t> suppressed_;
+};
+
+/**
+ * @brief Check whether the log macros capture raw arguments (asynchronous or binary mode), used internally.
+ * 
+ */
+ELITE_EXPORT bool isLogCaptureEnabled();
+
+/**
+ * @brief Log a message with captured raw arguments, used internally by logFormat().
+ *  The format string and the source file must be string literals, only the pointers are stored.
+ *  String arguments are copied.
+ * 
+ */
+ELITE_EXPORT void logCaptured(const char* file, int line, LogLevel level, const char* fmt, const LogArg* args, int count);
+
+/**
+ * @brief Log a message, this is used internally by the macros.
+ *  In asynchronous or binary mode the raw arguments are captured and the formatting is done later,
+ *  otherwise the message is formatted immediately.
+ * 
+ */
+template <typename... Args>
+inline void logFormat(const char* file, int line, LogLevel level, const char* fmt, Args... args) {
+    if (isLogCaptureEnabled()) {
+        const LogArg captured[sizeof...(Args) + 1] = {detail::makeLogArg(args)..., LogArg()};
+        logCaptured(file, line, level, fmt, captured, static_cast<int>(sizeof...(Args)));
+    } else {
+        log(file, line, level, fmt, args...);
+    }
+}
+
+/// Default number of records in the asynchronous log ring
+constexpr size_t DEFAULT_ASYNC_LOG_CAPACITY = 1024;
+
+/**
+ * @brief Enable asynchronous logging.
+ *  The messages are stored in a preallocated ring of fixed-size records (at most 479 characters, longer
+ *  messages are truncated), and a background thread passes them to the log handler. The logging thread never
+ *  blocks on I/O. If the ring is full, the message is dropped and counted by getDroppedLogCount().
+ *
+ * @param capacity Number of records in the ring, rounded up to a power of two
+ * @note The log handler is called in the background thread.
+ * @note The log macros store only the pointer of the format string and format the message in the background thread,
+ *  so the format string must be a string literal, which the macros check at compile time. String arguments are copied.
+ */
+ELITE_EXPORT void enableAsyncLog(size_t capacity = DEFAULT_ASYNC_LOG_CAPACITY);
+
+/**
+ * @brief Disable asynchronous logging, the messages in the ring are handled before return.
+ * 
+ */
+ELITE_EXPORT void disableAsyncLog();
+
+/**
+ * @brief Wait until all messages in the asynchronous log ring have been handled.
+ * 
+ */
+ELITE_EXPORT void flushLog();
+
+/**
+ * @brief Get the number of messages dropped because the asynchronous log ring was full.
+ * 
+ * @return uint64_t Number of dropped messages
+ */
+ELITE_EXPORT uint64_t getDroppedLogCount();
+
+/**
+ * @brief Enable binary logging.
+ *  The log macros store the format string pointer and the raw arguments in the asynchronous log ring, and a
+ *  background thread writes them to a binary file without formatting. Each format string and source file is written
+ *  to the file once. The file is decoded offline by decodeBinaryLog(). The log handler is not called in this mode.
+ *  Messages logged by log() directly are stored as preformatted text.
+ *
+ * @param path The binary log file, truncated if it exists
+ * @param capacity Number of records in the ring, rounded up to a power of two
+ * @return true success
+ * @return false fail to open the file
+ * @note The file uses the byte order of the machine that wrote it.
+ * @note The format string is identified by its pointer, so it must be a string literal, which the log macros check at
+ *  compile time.
+ */
+ELITE_EXPORT bool enableBinaryLog(const std::string& path, size_t capacity = DEFAULT_ASYNC_LOG_CAPACITY);
+
+/**
+ * @brief Disable binary logging, the messages in the ring are written and the file is closed.
+ *  The logging returns to synchronous mode.
+ * 
+ */
+ELITE_EXPORT void disableBinaryLog();
+
+/**
+ * @brief Decode a binary log file written in binary logging mode.
+ *  The messages are formatted and passed to the handler in order. The timestamp of each message
+ *  (seconds since epoch) is prepended to the message.
+ *
+ * @param path The binary log file
+ * @param handler Receives the decoded messages
+ * @return true The whole file is decoded
+ * @return false Fail to open the file, or the file is broken (messages before the broken part are decoded)
+ */
+ELITE_EXPORT bool decodeBinaryLog(const std::string& path, LogHandler& handler);
+
 } // namespace ELITE
 
 
@@ -0,0 +1,70 @@
+#ifndef __ELITE__LOG_CAPTURE_HPP__
+#define __ELITE__LOG_CAPTURE_HPP__
+
+#include "Log.hpp"
+#include "LogRingBuffer.hpp"
+
+#include <cstdio>
+#include <string>
+#include <unordered_set>
+
+namespace ELITE {
+
+/**
+ * @brief Encoding and deferred formatting of captured log arguments, used internal.
+ *  Encoded layout: u8 count, then for each argument u8 type followed by 8 bytes value,
+ *  or for a string u16 length followed by the characters.
+ */
+namespace LogCapture {
+
+/**
+ * @brief Encode the raw arguments. Strings that do not fit are truncated, arguments that do not fit are dropped.
+ *
+ * @param args Raw arguments
+ * @param count Number of arguments
+ * @param buffer Output buffer
+ * @param capacity Size of the output buffer
+ * @return size_t Bytes written
+ */
+size_t encodeArgs(const LogArg* args, int count, char* buffer, size_t capacity);
+
+/**
+ * @brief Format the encoded arguments with a printf-style format string.
+ *
+ * @param fmt Format string
+ * @param encoded Encoded arguments
+ * @param size Bytes of the encoded arguments
+ * @return std::string The message
+ */
+std::string format(const char* fmt, const char* encoded, size_t size);
+
+}  // namespace LogCapture
+
+/**
+ * @brief Writes log records to a binary log file, used by the asynchronous log thread.
+ *
+ */
+class BinaryLogWriter {
+   public:
+    BinaryLogWriter();
+    ~BinaryLogWriter();
+
+    bool open(const std::string& path);
+
+    void close();
+
+    void write(const LogRingBuffer::Record& record);
+
+    void flush();
+
+   private:
+    FILE* file_;
+    // Strings already written to the file, keyed by address
+    std::unordered_set<const void*> defined_;
+
+    void define(const char* str);
+};
+
+}  // namespace ELITE
+
+#endif
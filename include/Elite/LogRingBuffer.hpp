@@ -0,0 +1,113 @@
+#ifndef __ELITE__LOG_RING_BUFFER_HPP__
+#define __ELITE__LOG_RING_BUFFER_HPP__
+
+#include "Log.hpp"
+
+#include <atomic>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace ELITE {
+
+/**
+ * @brief
+ *      Bounded multi-producer single-consumer ring of fixed-size log records, used internal.
+ *      The records are preallocated, producers format the message in place and never block or allocate.
+ *      Each slot carries a sequence number (Vyukov's bounded queue), so a producer only does one CAS to claim a slot.
+ */
+class LogRingBuffer {
+   public:
+    /// Message longer than this is truncated
+    static constexpr size_t MESSAGE_SIZE = 480;
+
+    struct Record {
+        const char* file;
+        int line;
+        LogLevel level;
+        // Nanoseconds since epoch
+        int64_t timestamp_ns;
+        // Not null for a captured record, the message holds the encoded arguments
+        const char* fmt;
+        // Bytes of the encoded arguments
+        uint16_t size;
+        char message[MESSAGE_SIZE];
+    };
+
+    /**
+     * @brief Allocate the ring
+     *
+     * @param capacity Number of records, rounded up to a power of two
+     */
+    explicit LogRingBuffer(size_t capacity);
+    ~LogRingBuffer() = default;
+
+    /**
+     * @brief Format a message into a free record. Called by any thread.
+     *
+     * @param file The log message comes from this file, must be a string literal
+     * @param line The log message comes from this line
+     * @param level Level of the log message
+     * @param fmt Format string
+     * @param args Format arguments
+     * @return true pushed
+     * @return false the ring is full, the message is dropped
+     */
+    bool push(const char* file, int line, LogLevel level, const char* fmt, va_list args);
+
+    /**
+     * @brief Store the format string pointer and the encoded raw arguments into a free record. Called by any thread.
+     *
+     * @param file The log message comes from this file, must be a string literal
+     * @param line The log message comes from this line
+     * @param level Level of the log message
+     * @param fmt Format string, must be a string literal
+     * @param args Raw arguments
+     * @param count Number of arguments
+     * @return true pushed
+     * @return false the ring is full, the message is dropped
+     */
+    bool pushCaptured(const char* file, int line, LogLevel level, const char* fmt, const LogArg* args, int count);
+
+    /**
+     * @brief Get the oldest record. Called by the consumer thread only.
+     *
+     * @return const Record* The record, or nullptr if empty
+     */
+    const Record* front();
+
+    /**
+     * @brief Release the record got by front(). Called by the consumer thread only.
+     *
+     */
+    void pop();
+
+    /**
+     * @return true No record is waiting for the consumer
+     */
+    bool empty() const { return dequeue_pos_.load(std::memory_order_acquire) == enqueue_pos_.load(std::memory_order_acquire); }
+
+    size_t capacity() const { return mask_ + 1; }
+
+   private:
+    struct Cell;
+
+    // Claim a free cell, return nullptr if the ring is full
+    Cell* claim(size_t& pos);
+
+    struct Cell {
+        std::atomic<size_t> sequence;
+        Record record;
+    };
+
+    size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+    // Keep the producer and consumer positions on different cache lines
+    alignas(64) std::atomic<size_t> enqueue_pos_;
+    alignas(64) std::atomic<size_t> dequeue_pos_;
+};
+
+}  // namespace ELITE
+
+#endif
@@ -3,6 +3,14 @@
 
 #include "Log.hpp"
 #include "DefaultLogHandler.hpp"
+#include "LogRingBuffer.hpp"
+#include "LogCapture.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdarg>
+#include <mutex>
+#include <thread>
 
 
 namespace ELITE
@@ -10,40 +18,85 @@ namespace ELITE
 
 class Logger {
 private:
-    LogLevel level_;
+    std::atomic<LogLevel> level_;
+    std::mutex handler_mutex_;
     std::unique_ptr<LogHandler> handler_;
 
-public:
-    Logger() { 
-        level_ = LogLevel::ELI_INFO;
-        handler_.reset(new DefaultLogHandler);
-    };
+    // Asynchronous mode
+    std::mutex async_mutex_;
+    std::unique_ptr<LogRingBuffer> ring_;
+    std::atomic<LogRingBuffer*> active_ring_;
+    std::atomic<int> active_producers_;
+    std::atomic<uint64_t> dropped_;
+    std::atomic<bool> worker_alive_;
+    std::atomic<bool> worker_sleeping_;
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+    std::unique_ptr<std::thread> worker_;
+    // Binary mode, the worker writes the records to the file instead of calling the handler
+    std::unique_ptr<BinaryLogWriter> binary_writer_;
+
+    void dispatch(const char* file, int line, LogLevel level, const char* log);
+    void drain(LogRingBuffer* ring);
+    void workerLoop(LogRingBuffer* ring);
+    void stopWorker();
+    // Called with async_mutex_ locked
+    void startAsync(size_t capacity);
+    void stopAsync();
 
-    ~Logger() = default;
+public:
+    Logger();
+    ~Logger();
 
     void setLevel(LogLevel level) {
         level_ = level;
     }
 
     void registerHandler(std::unique_ptr<LogHandler>& handler) {
+        std::lock_guard<std::mutex> lock(handler_mutex_);
         handler_ = std::move(handler);
     }
 
     void unregisterHandler() {
+        std::lock_guard<std::mutex> lock(handler_mutex_);
         handler_.reset(new DefaultLogHandler);
     }
 
-    void log(const char* file, int line, LogLevel level, const char* log) {
-        if (!handler_) {
-            handler_.reset(new DefaultLogHandler());
-        }
-        handler_->log(file, line, level, log);
+    /**
+     * @brief Log a formatted message. In asynchronous mode the message is put into the ring.
+     *
+     */
+    void log(const char* file, int line, LogLevel level, const char* fmt, va_list args);
+
+    /**
+     * @brief Log a message with captured raw arguments. The formatting is done by the worker thread,
+     *  or by the decoder in binary mode.
+     *
+     */
+    void logCaptured(const char* file, int line, LogLevel level, const char* fmt, const LogArg* args, int count);
+
+    bool isCaptureEnabled() {
+        return active_ring_.load(std::memory_order_acquire) != nullptr;
     }
 
     LogLevel getLogLevel() {
         return level_;
     }
 
+    void enableAsync(size_t capacity);
+
+    void disableAsync();
+
+    bool enableBinary(const std::string& path, size_t capacity);
+
+    void disableBinary();
+
+    void flush();
+
+    uint64_t getDroppedCount() {
+        return dropped_;
+    }
+
 };
 
 Logger& getLogger();
@@ -0,0 +1,142 @@
+#ifndef __ELITE__REVERSE_LATENCY_MONITOR_HPP__
+#define __ELITE__REVERSE_LATENCY_MONITOR_HPP__
+
+#include <Elite/EliteOptions.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <utility>
+#include <vector>
+
+namespace ELITE {
+
+/// A latency distribution
+struct LatencyHistogram {
+    /// Upper bounds (us) of the buckets, the last bucket holds the rest
+    static constexpr std::array<int, 10> BUCKETS_US = {{100, 200, 500, 1000, 2000, 4000, 8000, 16000, 32000, 64000}};
+
+    /// Sample count per bucket, BUCKETS_US.size() + 1 buckets
+    std::array<uint64_t, BUCKETS_US.size() + 1> counts{};
+    uint64_t samples = 0;
+    std::chrono::microseconds last{0};
+    std::chrono::microseconds min{0};
+    std::chrono::microseconds max{0};
+    std::chrono::microseconds mean{0};
+
+    /**
+     * @brief Upper bound of the bucket that holds the given fraction of the samples
+     *
+     * @param fraction e.g. 0.99
+     * @return std::chrono::microseconds Bucket upper bound, or max for the last bucket
+     */
+    ELITE_EXPORT std::chrono::microseconds percentile(double fraction) const;
+};
+
+/// Latency and delivery of the reverse channel frames, from the echoes of the control script
+struct ReverseLatencyStatistics {
+    /// Frames sent with a sequence number
+    uint64_t sent = 0;
+    /// Frames echoed by the script
+    uint64_t echoed = 0;
+    /// Sequence numbers missing from the echoes
+    uint64_t lost = 0;
+    /// Frames replaced by the next one in the same controller cycle, before the motion used them
+    uint64_t skipped = 0;
+    /// Controller cycles without a frame between two consecutive frames. For a stream at the robot rate these are the
+    /// cycles in which the script extrapolated.
+    uint64_t missed_cycles = 0;
+    /// Send to echo received, measured on the host clock
+    LatencyHistogram round_trip;
+    /// Host to script and script to host, after removing the clock offset. The controller time is known to one cycle,
+    /// so single samples are off by up to half a cycle; the distributions are meaningful.
+    LatencyHistogram uplink;
+    LatencyHistogram downlink;
+    /// Controller clock minus host clock, estimated so that the shortest uplink and downlink delays are equal
+    std::chrono::microseconds clock_offset{0};
+    /// Controller cycle time reported by the script
+    std::chrono::microseconds step_time{0};
+};
+
+/**
+ * @brief Measures the reverse channel from sequence numbers sent with the frames and echoed by the control script
+ *  with the controller cycle in which the frame was read. The round trip is measured on the host clock. The offset
+ *  between the clocks is estimated from the shortest delays in each direction over a sliding window, which follows
+ *  the drift between the clocks, and gives the one-way latency estimates.
+ *
+ */
+class ReverseLatencyMonitor {
+   public:
+    /**
+     * @brief Construct
+     *
+     * @param window Echoes the clock offset is estimated over
+     */
+    ELITE_EXPORT explicit ReverseLatencyMonitor(size_t window = 2000);
+
+    /**
+     * @brief Record a frame about to be sent
+     *
+     * @param now Send time
+     * @return int32_t The sequence number for the frame, never 0
+     */
+    ELITE_EXPORT int32_t onSend(std::chrono::steady_clock::time_point now);
+
+    /**
+     * @brief Record an echo of the script
+     *
+     * @param sequence The sequence number of the frame
+     * @param cycle Controller cycle in which the script read the frame
+     * @param step_time_us Controller cycle time (us)
+     * @param now Receive time
+     */
+    ELITE_EXPORT void onEcho(int32_t sequence, int32_t cycle, int32_t step_time_us,
+                             std::chrono::steady_clock::time_point now);
+
+    /**
+     * @brief A new script connected: its cycle count starts again, so the clock offset and the echo order start
+     *  again too. The statistics are kept.
+     *
+     */
+    ELITE_EXPORT void restart();
+
+    /**
+     * @brief Clear the statistics
+     *
+     */
+    ELITE_EXPORT void reset();
+
+    ELITE_EXPORT ReverseLatencyStatistics getStatistics() const;
+
+   private:
+    // A sent frame, kept until its slot is reused
+    struct SentFrame {
+        int32_t sequence = 0;
+        std::chrono::steady_clock::time_point time;
+    };
+    // The recent frames, by sequence number modulo the size. The slot keeps the sequence number, so a slot reused by
+    // a later frame, also across the wrap of the sequence numbers, is not taken for an old one.
+    static constexpr size_t SEND_RING_SIZE = 4096;
+
+    size_t window_;
+    std::vector<SentFrame> send_times_;
+    int32_t next_sequence_ = 1;
+    int32_t last_echo_sequence_ = 0;
+    int32_t last_echo_cycle_ = 0;
+    uint64_t echo_index_ = 0;
+    // Sliding window minima of (controller - send) and (receive - controller) (us), index and value, increasing
+    std::deque<std::pair<uint64_t, int64_t>> min_forward_;
+    std::deque<std::pair<uint64_t, int64_t>> min_backward_;
+    // Host clock origin of the microsecond values
+    std::chrono::steady_clock::time_point origin_;
+    bool has_origin_ = false;
+    int64_t round_trip_sum_ = 0;
+    int64_t uplink_sum_ = 0;
+    int64_t downlink_sum_ = 0;
+    ReverseLatencyStatistics statistics_;
+};
+
+}  // namespace ELITE
+
+#endif
@@ -0,0 +1,128 @@
+#ifndef __ELITE__ROBOT_STATE_BUS_HPP__
+#define __ELITE__ROBOT_STATE_BUS_HPP__
+
+#include <Elite/DataType.hpp>
+#include <Elite/EliteOptions.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace ELITE {
+
+/**
+ * @brief One robot state sample shared through the state bus.
+ *  The layout is fixed, so the publisher and the readers must be built with the same SDK version.
+ *  Fields which are not in the output recipe of the publisher are zero, except robot_mode, safety_status and
+ *  runtime_state, which are UNKNOWN.
+ *
+ */
+struct RobotStateSnapshot {
+    double timestamp;
+    vector6d_t target_joint_positions;
+    vector6d_t target_joint_velocity;
+    vector6d_t actual_joint_positions;
+    vector6d_t actual_joint_velocity;
+    vector6d_t actual_joint_current;
+    vector6d_t actual_joint_torques;
+    vector6d_t actual_tcp_pose;
+    vector6d_t actual_tcp_velocity;
+    vector6d_t actual_tcp_force;
+    vector6d_t target_tcp_pose;
+    vector6d_t target_tcp_velocity;
+    double actual_speed_scaling;
+    double target_speed_scaling;
+    uint32_t digital_input_bits;
+    uint32_t digital_output_bits;
+    RobotMode robot_mode;
+    SafetyMode safety_status;
+    TaskStatus runtime_state;
+};
+
+/**
+ * @brief Write robot state snapshots into a named shared memory segment.
+ *  Every publish() is one seqlock write: the writer never waits for the readers,
+ *  and a reader retries if the snapshot changed while it was copying.
+ *  Only one publisher may write to a segment.
+ *
+ */
+class RobotStatePublisher {
+   private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+
+   public:
+    /**
+     * @brief Create the shared memory segment. An existing segment with the same name is replaced.
+     *
+     * @param name Segment name, e.g. "elite_robot_state". Must not contain '/'.
+     * @note Throw EliteException::Code::SHARED_MEMORY_FAIL if the segment can not be created
+     */
+    ELITE_EXPORT explicit RobotStatePublisher(const std::string& name);
+
+    /**
+     * @brief Remove the segment. Readers that already opened it keep the last snapshot.
+     *
+     */
+    ELITE_EXPORT ~RobotStatePublisher();
+
+    /**
+     * @brief Publish a snapshot
+     *
+     * @param snapshot Robot state
+     */
+    ELITE_EXPORT void publish(const RobotStateSnapshot& snapshot);
+
+    /**
+     * @brief Number of snapshots published
+     *
+     */
+    ELITE_EXPORT uint64_t getSequence();
+
+    /**
+     * @brief Segment name
+     *
+     */
+    ELITE_EXPORT const std::string& getName();
+};
+
+/**
+ * @brief Read the robot state snapshots written by a RobotStatePublisher, in the same or another process.
+ *  Reading takes no lock and makes no system call.
+ *
+ */
+class RobotStateReader {
+   private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+
+   public:
+    /**
+     * @brief Open an existing segment
+     *
+     * @param name Segment name given to the publisher
+     * @note Throw EliteException::Code::SHARED_MEMORY_FAIL if the segment does not exist
+     *  or was created by an incompatible SDK version
+     */
+    ELITE_EXPORT explicit RobotStateReader(const std::string& name);
+    ELITE_EXPORT ~RobotStateReader();
+
+    /**
+     * @brief Copy the latest snapshot
+     *
+     * @param snapshot Output
+     * @return true success
+     * @return false Nothing published yet, or the snapshot kept changing while reading
+     */
+    ELITE_EXPORT bool read(RobotStateSnapshot& snapshot);
+
+    /**
+     * @brief Number of snapshots published. Poll it to see whether a new snapshot arrived.
+     *
+     */
+    ELITE_EXPORT uint64_t getSequence();
+};
+
+}  // namespace ELITE
+
+#endif
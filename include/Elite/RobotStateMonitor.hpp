@@ -0,0 +1,138 @@
+#ifndef __ELITE__ROBOT_STATE_MONITOR_HPP__
+#define __ELITE__ROBOT_STATE_MONITOR_HPP__
+
+#include <Elite/DataType.hpp>
+#include <Elite/EliteOptions.hpp>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace ELITE {
+
+/**
+ * @brief Keep the latest robot mode, safety mode and task status, which are updated by a data stream (e.g. RtsiIOInterface).
+ *  The threads waiting for a state are woken as soon as the state is observed, and the listeners are called.
+ *
+ */
+class RobotStateMonitor {
+   private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+
+   public:
+    /// If there is no update within this time, the monitor is considered not updating.
+    static constexpr int DEFAULT_STALE_TIMEOUT_MS = 500;
+
+    ELITE_EXPORT RobotStateMonitor();
+    ELITE_EXPORT ~RobotStateMonitor();
+
+    /**
+     * @brief Update the robot mode and wake the waiting threads.
+     *
+     * @param mode Robot mode
+     */
+    ELITE_EXPORT void updateRobotMode(RobotMode mode);
+
+    /**
+     * @brief Update the safety mode and wake the waiting threads.
+     *
+     * @param mode Safety mode
+     */
+    ELITE_EXPORT void updateSafetyMode(SafetyMode mode);
+
+    /**
+     * @brief Update the task status and wake the waiting threads.
+     *
+     * @param status Task status
+     */
+    ELITE_EXPORT void updateTaskStatus(TaskStatus status);
+
+    /**
+     * @brief Update all states at once, the waiting threads are woken once.
+     *
+     * @param robot_mode Robot mode
+     * @param safety_mode Safety mode
+     * @param task_status Task status
+     */
+    ELITE_EXPORT void update(RobotMode robot_mode, SafetyMode safety_mode, TaskStatus task_status);
+
+    /**
+     * @brief Wait until the robot mode is one of the target modes.
+     *
+     * @param modes Target modes
+     * @param timeout_ms Timeout
+     * @return true The robot mode is one of the target modes
+     * @return false Timeout, or the monitor stopped updating
+     */
+    ELITE_EXPORT bool waitRobotMode(const std::vector<RobotMode>& modes, int timeout_ms);
+
+    /**
+     * @brief Wait until the safety mode is the target mode.
+     *
+     * @param mode Target mode
+     * @param timeout_ms Timeout
+     * @return true The safety mode is the target mode
+     * @return false Timeout, or the monitor stopped updating
+     */
+    ELITE_EXPORT bool waitSafetyMode(SafetyMode mode, int timeout_ms);
+
+    /**
+     * @brief Wait until the task status is the target status.
+     *
+     * @param status Target status
+     * @param timeout_ms Timeout
+     * @return true The task status is the target status
+     * @return false Timeout, or the monitor stopped updating
+     */
+    ELITE_EXPORT bool waitTaskStatus(TaskStatus status, int timeout_ms);
+
+    /**
+     * @brief Add a listener which is called after every update, e.g. to wake an asynchronous wait.
+     *
+     * @param listener Called in the updating thread, must not block or add or remove a listener
+     * @return int The id to remove the listener
+     */
+    ELITE_EXPORT int addListener(std::function<void()> listener);
+
+    /**
+     * @brief Remove a listener. The listener is not called after this returns.
+     *
+     * @param id The id returned by addListener()
+     */
+    ELITE_EXPORT void removeListener(int id);
+
+    /**
+     * @brief Is the monitor updated recently.
+     *
+     * @return true Updated within the stale timeout
+     * @return false Never updated, or the data stream stopped
+     */
+    ELITE_EXPORT bool isUpdating();
+
+    /**
+     * @brief Set the stale timeout
+     *
+     * @param timeout_ms If there is no update within this time, the monitor is considered not updating.
+     */
+    ELITE_EXPORT void setStaleTimeout(int timeout_ms);
+
+    /**
+     * @return RobotMode The latest robot mode
+     */
+    ELITE_EXPORT RobotMode getRobotMode();
+
+    /**
+     * @return SafetyMode The latest safety mode
+     */
+    ELITE_EXPORT SafetyMode getSafetyMode();
+
+    /**
+     * @return TaskStatus The latest task status
+     */
+    ELITE_EXPORT TaskStatus getTaskStatus();
+};
+
+}  // namespace ELITE
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef __ELITE__SERVO_INTERPOLATOR_HPP__
+#define __ELITE__SERVO_INTERPOLATOR_HPP__
+
+#include <Elite/DataType.hpp>
+#include <Elite/EliteOptions.hpp>
+
+#include <cstdint>
+#include <memory>
+
+namespace ELITE {
+
+/// Polynomial between two waypoints
+enum class ServoSplineType {
+    /// Continuous velocity
+    CUBIC,
+    /// Continuous velocity and acceleration, so the jerk stays bounded
+    QUINTIC,
+};
+
+/// Servo interpolator settings
+struct ServoInterpolatorOptions {
+    ServoSplineType spline = ServoSplineType::QUINTIC;
+    /// Period of next(), the servo step time of the robot (s)
+    double period = 0.004;
+    /// Transport latency to the robot (s). Every setpoint is sampled this far ahead.
+    double latency = 0;
+    /// Past the last waypoint, the motion is predicted with its velocity for at most this long (s), then held
+    double max_prediction = 0.05;
+};
+
+/// Smoothness and prediction metrics of the interpolator output
+struct ServoInterpolatorMetrics {
+    /// Setpoints produced
+    uint64_t samples = 0;
+    /// Setpoints past the last waypoint, predicted from it
+    uint64_t predicted = 0;
+    /// Largest and RMS jerk of the setpoints (rad/s^3, Euclidean over the joints), from the change of acceleration
+    /// between setpoints, so a jump of acceleration shows up
+    double max_jerk = 0;
+    double rms_jerk = 0;
+    /// Distance (rad, Euclidean over the joints) of the prediction at the time of a waypoint that arrived while
+    /// predicting past the previous one, from that waypoint; the largest and the last
+    double max_deviation = 0;
+    double last_deviation = 0;
+};
+
+/**
+ * @brief Upsamples coarse joint waypoints, e.g. from a 100 Hz planner, to one servo setpoint per robot step, so
+ *  writeServoj() always has a fresh target and the robot script does not fall back to its first order extrapolation.
+ *  Between waypoints a cubic or quintic polynomial runs from the current setpoint state to the next waypoint, whose
+ *  velocity and acceleration are estimated from up to two neighbours on each side. When a later waypoint refines that estimate, the
+ *  polynomial is planned again from the current setpoint state, so the output stays smooth. Setpoints are sampled
+ *  ahead by the transport latency. Waypoints may be added from another thread than the one taking the setpoints.
+ *
+ */
+class ServoInterpolator {
+   private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+
+   public:
+    ELITE_EXPORT explicit ServoInterpolator(const ServoInterpolatorOptions& options = ServoInterpolatorOptions());
+    ELITE_EXPORT ~ServoInterpolator();
+
+    /**
+     * @brief Start from the current joint positions at rest. Clears the waypoints and the metrics.
+     *
+     * @param positions Current joint positions
+     * @param time Current time (s), the clock of the waypoints
+     */
+    ELITE_EXPORT void reset(const vector6d_t& positions, double time);
+
+    /**
+     * @brief Add a waypoint. Without reset(), the first waypoint is the start at rest.
+     *
+     * @param time Time of the waypoint (s). The same clock as sample().
+     * @param positions Joint positions
+     * @return true success
+     * @return false The time is not after the previous waypoint
+     */
+    ELITE_EXPORT bool addWaypoint(double time, const vector6d_t& positions);
+
+    /**
+     * @brief The setpoint for a time, sampled ahead by the latency. Times must not decrease.
+     *
+     * @param time Current time (s)
+     * @param setpoint Joint positions for writeServoj(), unchanged if false is returned
+     * @return true success
+     * @return false No start yet, reset() or addWaypoint() was not called. Send nothing, there is no setpoint.
+     */
+    ELITE_EXPORT bool sample(double time, vector6d_t& setpoint);
+
+    /**
+     * @brief The setpoint one period after the previous one, for a loop at the robot rate
+     *
+     * @param setpoint Joint positions for writeServoj(), unchanged if false is returned
+     * @return true success
+     * @return false No start yet, reset() or addWaypoint() was not called
+     */
+    ELITE_EXPORT bool next(vector6d_t& setpoint);
+
+    /**
+     * @brief Update the latency, e.g. from a measurement
+     *
+     * @param latency Transport latency (s)
+     */
+    ELITE_EXPORT void setLatency(double latency);
+
+    ELITE_EXPORT ServoInterpolatorMetrics getMetrics();
+
+    ELITE_EXPORT void resetMetrics();
+};
+
+}  // namespace ELITE
+
+#endif
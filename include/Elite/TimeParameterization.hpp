@@ -0,0 +1,87 @@
+#ifndef __ELITE__TIME_PARAMETERIZATION_HPP__
+#define __ELITE__TIME_PARAMETERIZATION_HPP__
+
+#include <Elite/DataType.hpp>
+#include <Elite/EliteOptions.hpp>
+#include <Elite/Kinematics.hpp>
+#include <Elite/RobotConfPackage.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace ELITE {
+
+/// Time parameterization settings
+struct TimeParameterizationOptions {
+    /// Fractions of the joint limits used, a margin for tracking errors
+    double velocity_scale = 1.0;
+    double acc_scale = 1.0;
+    /// Longest step of the grid along the path (rad, Euclidean in joint space). Longer segments are subdivided,
+    /// so a sparse path has room to speed up and slow down.
+    double max_step = 0.01;
+};
+
+/**
+ * @brief Minimum-time timing of a joint path within the joint velocity and acceleration limits, TOPP-RA style.
+ *  The path is the polyline through the points, parameterized by its length s. On a grid along it, a backward pass
+ *  computes the largest reachable ds/dt at every grid point, from which the end can still be reached at rest, and a
+ *  forward pass then takes the largest path acceleration at each step. Each grid point costs a small fixed number of
+ *  operations, so a path of 10k points takes milliseconds. The motion starts and ends at rest.
+ *
+ */
+class TimeParameterization {
+   public:
+    /**
+     * @brief Construct from limits
+     *
+     * @param max_velocity Joint velocity limits (rad/s)
+     * @param max_acc Joint acceleration limits (rad/s^2)
+     * @param options Scales and grid
+     * @throw EliteException ILLEGAL_PARAM if a limit or the grid step is not positive
+     */
+    ELITE_EXPORT TimeParameterization(const vector6d_t& max_velocity, const vector6d_t& max_acc,
+                                      const TimeParameterizationOptions& options = TimeParameterizationOptions());
+
+    /**
+     * @brief Construct from the limits read from the primary port
+     *
+     * @param info The JointLimitsInfo package
+     * @param options Scales and grid
+     * @throw EliteException ILLEGAL_PARAM if a limit is not positive
+     */
+    ELITE_EXPORT explicit TimeParameterization(const JointLimitsInfo& info,
+                                               const TimeParameterizationOptions& options = TimeParameterizationOptions());
+
+    /**
+     * @brief The time of every point of a path
+     *
+     * @param path Joint positions (rad), the first one the start
+     * @return std::vector<double> Time from the previous point to each point (s), 0 for the first point and for repeated
+     *  points. They are the time arguments of writeTrajectoryPoint().
+     */
+    ELITE_EXPORT std::vector<double> parameterize(const Vector6dBatch& path) const;
+
+    /**
+     * @brief Sample the minimum-time motion along a path at a fixed period, for writeServoj()
+     *
+     * @param path Joint positions (rad), the first one the start
+     * @param period Sample period (s)
+     * @return Vector6dBatch Joint targets, one per period after the start. The last one is the end of the path.
+     */
+    ELITE_EXPORT Vector6dBatch resample(const Vector6dBatch& path, double period) const;
+
+    const vector6d_t& getMaxVelocity() const { return max_velocity_; }
+    const vector6d_t& getMaxAcc() const { return max_acc_; }
+
+   private:
+    vector6d_t max_velocity_;
+    vector6d_t max_acc_;
+    TimeParameterizationOptions options_;
+
+    struct Profile;
+    void solve(const Vector6dBatch& path, Profile& profile) const;
+};
+
+}  // namespace ELITE
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef __ELITE__TRAJECTORY_COMPRESSOR_HPP__
+#define __ELITE__TRAJECTORY_COMPRESSOR_HPP__
+
+#include <Elite/DataType.hpp>
+#include <Elite/EliteOptions.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace ELITE {
+
+/// A point of EliteDriver::writeTrajectoryPoint()
+struct TrajectoryWaypoint {
+    /// Joint positions, or a pose [x, y, z, rx, ry, rz]
+    vector6d_t positions{};
+    /// Time to reach this point from the previous one
+    float time = 0;
+    float blend_radius = 0;
+};
+
+/// Trajectory compression settings
+struct TrajectoryCompressionOptions {
+    /// The points are poses for movel(), otherwise joint positions for movej()
+    bool cartesian = false;
+    /// Largest distance of an input point from the blended path. Joint: rad (Euclidean in joint space), cartesian: m.
+    /// Half of it is for the removed points, half for cutting the corners by the blends.
+    double tolerance = 0.001;
+    /// Cartesian only: largest orientation error of a removed point, rad
+    double rotation_tolerance = 0.005;
+    /// A blend radius is at most this fraction of the shorter neighbouring segment, so blends never overlap. 0: no blend
+    double max_blend_ratio = 0.4;
+    /// Joint only: TCP distance per radian of joint motion (m/rad). movej() takes the blend radius in meters, the joint space
+    /// blend size is multiplied by this. Use a small value for a conservative radius.
+    double joint_blend_scale = 0.1;
+    /// Inputs with at least this many points are split into chunks, compressed in parallel
+    size_t parallel_threshold = 20000;
+    /// Number of threads for large inputs. 0: hardware concurrency
+    unsigned threads = 0;
+};
+
+/**
+ * @brief Simplify a dense list of trajectory points before it is sent with EliteDriver::writeTrajectoryPoint().
+ *  Points are removed Ramer-Douglas-Peucker style while every removed point stays within half the tolerance of the
+ *  straight segment that replaces it, and the time of removed points is added to the next kept point.
+ *  A blend radius is then chosen for each inner point, as large as the other half of the tolerance and the neighbouring
+ *  segments allow.
+ *
+ */
+class TrajectoryCompressor {
+   public:
+    ELITE_EXPORT explicit TrajectoryCompressor(const TrajectoryCompressionOptions& options = TrajectoryCompressionOptions());
+
+    /**
+     * @brief Simplify the points and select the blend radii
+     *
+     * @param points Dense points. Their blend radii are ignored.
+     * @return std::vector<TrajectoryWaypoint> The kept points, the first and the last always among them.
+     *  The last point has no blend.
+     */
+    ELITE_EXPORT std::vector<TrajectoryWaypoint> compress(const std::vector<TrajectoryWaypoint>& points) const;
+
+    /**
+     * @brief Indices of the points kept by compress()
+     *
+     * @param points Dense points
+     * @return std::vector<size_t> Increasing indices into points
+     */
+    ELITE_EXPORT std::vector<size_t> simplify(const std::vector<TrajectoryWaypoint>& points) const;
+
+    /**
+     * @brief Deviation of a point from the segment between two others, in the units of the tolerance
+     *
+     * @param point The point
+     * @param start Start of the segment
+     * @param end End of the segment
+     * @return double The distance. Cartesian: the position distance, or the orientation error scaled by
+     *  tolerance / rotation_tolerance if that is larger
+     */
+    ELITE_EXPORT double deviation(const vector6d_t& point, const vector6d_t& start, const vector6d_t& end) const;
+
+    const TrajectoryCompressionOptions& getOptions() const { return options_; }
+
+   private:
+    TrajectoryCompressionOptions options_;
+
+    void simplifyRange(const std::vector<TrajectoryWaypoint>& points, size_t first, size_t last,
+                       std::vector<size_t>& kept) const;
+    float blendRadius(const vector6d_t& prev, const vector6d_t& corner, const vector6d_t& next) const;
+};
+
+}  // namespace ELITE
+
+#endif
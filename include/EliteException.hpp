@@ -46,6 +46,10 @@ public:
         DASHBOARD_NOT_EXPECT_RECIVE,
         /// open file fail
         FILE_OPEN_FAIL,
+        /// operation timeout
+        TIMEOUT,
+        /// create or open shared memory fail
+        SHARED_MEMORY_FAIL,
     };
 
     EliteException() = delete;
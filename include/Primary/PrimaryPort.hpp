@@ -3,8 +3,12 @@
 
 #include "PrimaryPackage.hpp"
 #include "DataType.hpp"
+#include "ReconnectSupervisor.hpp"
+#include "Log.hpp"
 
 #include <boost/asio.hpp>
+#include <atomic>
+#include <chrono>
 #include <string>
 #include <thread>
 #include <memory>
@@ -37,14 +41,38 @@ private:
     std::unordered_map<int, std::shared_ptr<PrimaryPackage>> parser_sub_msg_;
     std::unique_ptr<std::thread> socket_async_thread_;
     std::mutex mutex_;
-    bool socket_async_thread_alive_;
+    std::atomic<bool> socket_async_thread_alive_;
+
+    // The address of the last connect(), used by the automatic reconnect
+    std::string ip_;
+    int port_;
+    ReconnectSupervisor reconnect_;
+    // The steady_clock ticks of the last received package. Written by connectSocket(), which connect() calls on the
+    // user's thread, and by the background thread.
+    std::atomic<std::chrono::steady_clock::rep> last_receive_time_;
+    // The errors of the background thread, which retries every 10 ms
+    LogThrottle disconnected_log_throttle_;
+    LogThrottle head_log_throttle_;
+    LogThrottle length_log_throttle_;
+    LogThrottle body_log_throttle_;
     
     /**
      * @brief The background thread.
      *  Receive and parser package.
+     *  If the automatic reconnect is enabled, restore the connection when it is lost.
      */
     void socketAsyncLoop();
 
+    /**
+     * @brief Open a new socket and connect
+     * 
+     * @param ip The robot ip
+     * @param port The port
+     * @return true success
+     * @return false fail
+     */
+    bool connectSocket(const std::string& ip, int port);
+
     /**
      * @brief Receive and parser package.
      * 
@@ -102,6 +130,26 @@ public:
      */
     bool getPackage(std::shared_ptr<PrimaryPackage> pkg, int timeout_ms);
 
+    /**
+     * @brief Enable or disable the automatic reconnect.
+     *  If enabled, the background thread connects again with backoff when the connection is lost or nothing is received
+     * for options.silence_timeout_ms. The pending getPackage() requests are kept.
+     * @param enable Enable
+     * @param options Backoff settings
+     */
+    void setAutoReconnect(bool enable, const ReconnectOptions& options) { reconnect_.setEnabled(enable, options); }
+
+    /**
+     * @brief Set the callback called when the connection state changes
+     * 
+     * @param cb The callback. It may be called in the background thread, do not call connect() or disconnect() in it.
+     */
+    void setConnectionStateCallback(std::function<void(LinkState)> cb) { reconnect_.setStateCallback(cb); }
+
+    LinkState getConnectionState() const { return reconnect_.getState(); }
+
+    ReconnectMetrics getReconnectMetrics() const { return reconnect_.getMetrics(); }
+
 };
 
 } // namespace ELITE
@@ -11,7 +11,9 @@
 #define __ELITE__PRIMARY_PORT_INTERFACE_HPP__
 
 #include <Elite/PrimaryPackage.hpp>
+#include <Elite/DataType.hpp>
 #include <Elite/EliteOptions.hpp>
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -68,6 +70,36 @@ public:
      */
     ELITE_EXPORT bool getPackage(std::shared_ptr<PrimaryPackage> pkg, int timeout_ms);
 
+    /**
+     * @brief Enable or disable the automatic reconnect.
+     *  If enabled, the background thread connects again with backoff when the connection is lost or nothing is received
+     * for options.silence_timeout_ms. The pending getPackage() requests are kept.
+     * @param enable Enable
+     * @param options Backoff settings
+     */
+    ELITE_EXPORT void setAutoReconnect(bool enable, const ReconnectOptions& options = ReconnectOptions());
+
+    /**
+     * @brief Set the callback called when the connection state changes
+     * 
+     * @param cb The callback. It may be called in the background thread, do not call connect() or disconnect() in it.
+     */
+    ELITE_EXPORT void setConnectionStateCallback(std::function<void(LinkState)> cb);
+
+    /**
+     * @brief Get the connection state
+     * 
+     * @return LinkState The state
+     */
+    ELITE_EXPORT LinkState getConnectionState();
+
+    /**
+     * @brief Get the statistics of automatic reconnect
+     * 
+     * @return ReconnectMetrics The statistics
+     */
+    ELITE_EXPORT ReconnectMetrics getReconnectMetrics();
+
 };
 
 } // namespace ELITE
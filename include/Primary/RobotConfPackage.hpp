@@ -60,6 +60,35 @@ public:
     ELITE_EXPORT void parser(int len, const std::vector<uint8_t>::const_iterator& iter);
 };
 
+/**
+ * @brief The joint limits in RobotConfig message
+ * 
+ */
+class JointLimitsInfo : public RobotConfPackage {
+private:
+    // The limits follow the sub-header: position limits, then velocity and acceleration limits, both paired per joint
+    static constexpr int LIMIT_OFFSET = sizeof(uint32_t) + sizeof(uint8_t);
+public:
+    ELITE_EXPORT JointLimitsInfo() = default;
+    ELITE_EXPORT ~JointLimitsInfo() = default;
+
+    /// Joint position limits (rad)
+    vector6d_t limit_min_;
+    vector6d_t limit_max_;
+    /// Joint velocity limits (rad/s)
+    vector6d_t max_velocity_;
+    /// Joint acceleration limits (rad/s^2)
+    vector6d_t max_acc_;
+
+    /**
+     * @brief Parser message from robot. Internal use.
+     * 
+     * @param len The len of sub-package
+     * @param iter Position of the sub-package in the entire package
+     */
+    ELITE_EXPORT void parser(int len, const std::vector<uint8_t>::const_iterator& iter);
+};
+
 
 } // namespace ELITE
 
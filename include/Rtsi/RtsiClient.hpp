@@ -2,6 +2,7 @@
 #define __RTSICLIENT_HPP__
 
 #include "RtsiRecipe.hpp"
+#include "RtsiClientInterface.hpp"
 #include "VersionInfo.hpp"
 
 #include <boost/asio.hpp>
@@ -90,6 +91,22 @@ public:
      */
     bool pause();
 
+    /**
+     * @brief Send the protocol version, controller version, recipe setup and start requests in one write,
+     *      then match the replies by package type.
+     * 
+     * @param output_recipe The list of output recipe
+     * @param frequency Setup output frenqucy
+     * @param input_recipe The list of input recipe
+     * @param result The replies. If the recipes in it are set, for example from a previous connection, they are set up
+     *      again and keep their values.
+     * @param version The version of RTSI
+     * @return true The replies are received. If the protocol version is not accepted, the later replies are not read.
+     * @return false Some replies are not received in time
+     */
+    bool handshake(const std::vector<std::string>& output_recipe, double frequency, const std::vector<std::string>& input_recipe,
+                   RtsiHandshakeResult& result, uint16_t version = DEFAULT_PROTOCOL_VERSION);
+
     /**
      * @brief Send an recipe to controller
      * 
@@ -178,6 +195,31 @@ private:
      */
     void sendAll(const PackageType& cmd, const std::vector<uint8_t>& payload = std::vector<uint8_t>());
 
+    /**
+     * @brief Append an package to the message buffer
+     * 
+     * @param message The message buffer
+     * @param cmd Package type
+     * @param payload Package payload
+     */
+    static void appendPackage(std::vector<uint8_t>& message, const PackageType& cmd,
+                              const std::vector<uint8_t>& payload = std::vector<uint8_t>());
+
+    /**
+     * @brief Write the whole message to socket
+     * 
+     * @param message The message
+     */
+    void writeMessage(const std::vector<uint8_t>& message);
+
+    /**
+     * @brief Make the payload of recipe setup package
+     * 
+     * @param recipe_list The list of recipe
+     * @return std::vector<uint8_t> The variable names separated by ','
+     */
+    static std::vector<uint8_t> recipePayload(const std::vector<std::string>& recipe_list);
+
     /**
      * @brief Receive socket bytes from RTSI server
      * 
@@ -19,6 +19,20 @@
 
 namespace ELITE {
 
+/**
+ * @brief The replies of the pipelined handshake
+ * 
+ */
+struct RtsiHandshakeResult {
+    // Whether the server accepts the protocol version
+    bool protocol_accepted = false;
+    VersionInfo controller_version;
+    RtsiRecipeSharedPtr output_recipe;
+    RtsiRecipeSharedPtr input_recipe;
+    // Whether data synchronization has started
+    bool started = false;
+};
+
 /**
  * @brief The RTSI client raw interface.
  * 
@@ -97,6 +111,25 @@ public:
      */
     ELITE_EXPORT bool pause();
 
+    /**
+     * @brief Verify the protocol version, get the controller version, subscribe to the input and output variables and send
+     * start signal. All requests are sent at once and then the replies are matched, so the handshake costs about one round
+     * trip instead of five.
+     * 
+     * @param output_recipe The list of output recipe
+     * @param frequency Setup output frenqucy
+     * @param input_recipe The list of input recipe
+     * @param result The replies. If the recipes in it are set, for example from a previous connection, they are set up
+     *      again and keep their values.
+     * @param version The version of RTSI
+     * @return true The replies are received. If the protocol version is not accepted, the later replies are not read and
+     *      the connection is closed, connect again before trying another version.
+     * @return false Some replies are not received in time
+     */
+    ELITE_EXPORT bool handshake(const std::vector<std::string>& output_recipe, double frequency,
+                                const std::vector<std::string>& input_recipe, RtsiHandshakeResult& result,
+                                uint16_t version = DEFAULT_PROTOCOL_VERSION);
+
     /**
      * @brief Send an recipe to controller
      * 
@@ -0,0 +1,311 @@
+/**
+ * @file RtsiHub.hpp
+ * @brief One RTSI connection shared by several subscribers in a process
+ *
+ */
+#ifndef __RTSI_HUB_HPP__
+#define __RTSI_HUB_HPP__
+
+#include <Elite/DataType.hpp>
+#include <Elite/EliteOptions.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ELITE {
+
+/**
+ * @brief One decoded output data package. It is shared by all subscribers and never changed after it is dispatched.
+ *  It holds every field negotiated by the hub, which includes the fields of the subscriber.
+ *
+ */
+class RtsiSample {
+   public:
+    using FieldIndex = std::unordered_map<std::string, size_t>;
+
+    RtsiSample(std::shared_ptr<const FieldIndex> index, std::vector<RtsiTypeVariant>&& values, uint64_t sequence,
+               std::chrono::steady_clock::time_point receive_time)
+        : index_(std::move(index)), values_(std::move(values)), sequence_(sequence), receive_time_(receive_time) {}
+
+    /**
+     * @brief Retrieve the value of a field
+     *
+     * @tparam T The type of output variable, the same as RtsiRecipe::getValue()
+     * @param name The variable name
+     * @param out_value Output value
+     * @return true success
+     * @return false The field is not in the sample, or the type does not match
+     */
+    template <typename T>
+    bool getValue(const std::string& name, T& out_value) const {
+        auto iter = index_->find(name);
+        if (iter == index_->end()) {
+            return false;
+        }
+#if (ELITE_SDK_COMPILE_STANDARD >= 17)
+        const T* value = std::get_if<T>(&values_[iter->second]);
+#elif (ELITE_SDK_COMPILE_STANDARD == 14)
+        const T* value = boost::get<T>(&values_[iter->second]);
+#endif
+        if (!value) {
+            return false;
+        }
+        out_value = *value;
+        return true;
+    }
+
+    /**
+     * @brief Number of data packages dispatched by the hub before this one, counted from 1
+     *
+     */
+    uint64_t getSequence() const { return sequence_; }
+
+    /**
+     * @brief The time the data package was decoded
+     *
+     */
+    std::chrono::steady_clock::time_point getReceiveTime() const { return receive_time_; }
+
+   private:
+    std::shared_ptr<const FieldIndex> index_;
+    std::vector<RtsiTypeVariant> values_;
+    uint64_t sequence_;
+    std::chrono::steady_clock::time_point receive_time_;
+};
+
+using RtsiSamplePtr = std::shared_ptr<const RtsiSample>;
+
+class RtsiHub;
+
+/**
+ * @brief A subscriber of RtsiHub. The hub calls onSample() from its receive thread for every data package.
+ *
+ */
+class RtsiSubscription {
+   public:
+    ELITE_EXPORT virtual ~RtsiSubscription() = default;
+
+    /**
+     * @brief The fields requested by this subscriber
+     *
+     */
+    const std::vector<std::string>& getFields() const { return fields_; }
+
+    /**
+     * @brief Is the subscription dispatched
+     *
+     * @return false Unsubscribed, or the controller rejected one of its fields
+     */
+    bool isActive() const { return active_; }
+
+   protected:
+    explicit RtsiSubscription(const std::vector<std::string>& fields) : fields_(fields), active_(true) {}
+
+    /**
+     * @brief Called from the receive thread of the hub. Must not block.
+     *
+     * @param sample The decoded data package
+     */
+    virtual void onSample(const RtsiSamplePtr& sample) = 0;
+
+   private:
+    friend class RtsiHub;
+    std::vector<std::string> fields_;
+    std::atomic<bool> active_;
+};
+
+/**
+ * @brief Call a function for every data package, in the receive thread of the hub.
+ *
+ */
+class RtsiCallbackSubscription : public RtsiSubscription {
+   public:
+    RtsiCallbackSubscription(const std::vector<std::string>& fields, std::function<void(const RtsiSamplePtr&)> cb)
+        : RtsiSubscription(fields), cb_(std::move(cb)) {}
+
+   protected:
+    ELITE_EXPORT void onSample(const RtsiSamplePtr& sample) override;
+
+   private:
+    std::function<void(const RtsiSamplePtr&)> cb_;
+};
+
+/**
+ * @brief A bounded single-producer single-consumer queue of data packages.
+ *  The hub is the producer, one thread of the subscriber is the consumer.
+ *  If the queue is full the new data package is dropped and counted.
+ *
+ */
+class RtsiSampleQueue : public RtsiSubscription {
+   public:
+    ELITE_EXPORT RtsiSampleQueue(const std::vector<std::string>& fields, size_t capacity);
+
+    /**
+     * @brief Take the oldest data package
+     *
+     * @param sample Output
+     * @return true success
+     * @return false The queue is empty
+     */
+    ELITE_EXPORT bool pop(RtsiSamplePtr& sample);
+
+    /**
+     * @brief Take the oldest data package, wait if the queue is empty
+     *
+     * @param sample Output
+     * @param timeout_ms Timeout
+     * @return true success
+     * @return false Timeout
+     */
+    ELITE_EXPORT bool waitPop(RtsiSamplePtr& sample, int timeout_ms);
+
+    /**
+     * @brief Number of data packages in the queue
+     *
+     */
+    ELITE_EXPORT size_t size() const;
+
+    /**
+     * @brief Number of data packages dropped because the queue was full
+     *
+     */
+    uint64_t getDropped() const { return dropped_; }
+
+   protected:
+    ELITE_EXPORT void onSample(const RtsiSamplePtr& sample) override;
+
+   private:
+    // One slot is kept empty to tell a full ring from an empty one
+    std::vector<RtsiSamplePtr> ring_;
+    std::atomic<size_t> head_;
+    std::atomic<size_t> tail_;
+    std::atomic<uint64_t> dropped_;
+    std::atomic<bool> waiting_;
+    std::mutex wait_mutex_;
+    std::condition_variable wait_cv_;
+};
+
+/**
+ * @brief Keep only the latest data package. Readers never block the hub.
+ *
+ */
+class RtsiLatestSample : public RtsiSubscription {
+   public:
+    explicit RtsiLatestSample(const std::vector<std::string>& fields) : RtsiSubscription(fields) {}
+
+    /**
+     * @brief The latest data package
+     *
+     * @return RtsiSamplePtr nullptr if nothing received yet
+     */
+    ELITE_EXPORT RtsiSamplePtr get() const;
+
+   protected:
+    ELITE_EXPORT void onSample(const RtsiSamplePtr& sample) override;
+
+   private:
+    RtsiSamplePtr latest_;
+};
+
+/**
+ * @brief Own one RTSI connection and dispatch every output data package to the subscribers.
+ *  The output recipe is the union of the fields of all subscribers. Subscribing a field that is not in the recipe
+ *  while connected pauses the synchronization, sets up the new recipe and starts again.
+ *
+ */
+class RtsiHub {
+   private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+
+   public:
+    /**
+     * @brief Construct a new hub
+     *
+     * @param frequency Output frequency
+     */
+    ELITE_EXPORT explicit RtsiHub(double frequency = 250);
+    ELITE_EXPORT ~RtsiHub();
+
+    /**
+     * @brief Connect to the RTSI server, set up the output recipe and start the receive thread
+     *
+     * @param ip The robot IP
+     * @return true success
+     * @return false fail, e.g. the controller rejected a field
+     */
+    ELITE_EXPORT bool connect(const std::string& ip);
+
+    /**
+     * @brief Stop the receive thread and disconnect
+     *
+     */
+    ELITE_EXPORT void disconnect();
+
+    ELITE_EXPORT bool isConnected();
+
+    /**
+     * @brief Add a subscriber. It receives data packages from the next one that holds all its fields.
+     *
+     * @param subscription Subscriber
+     */
+    ELITE_EXPORT void subscribe(std::shared_ptr<RtsiSubscription> subscription);
+
+    /**
+     * @brief Remove a subscriber. The fields of the recipe are not reduced until the next connect().
+     *
+     * @param subscription Subscriber
+     */
+    ELITE_EXPORT void unsubscribe(const std::shared_ptr<RtsiSubscription>& subscription);
+
+    /**
+     * @brief Subscribe with a callback, called in the receive thread of the hub
+     *
+     * @param fields Output recipe fields
+     * @param cb Callback, must not block
+     * @return std::shared_ptr<RtsiSubscription> Pass to unsubscribe()
+     */
+    ELITE_EXPORT std::shared_ptr<RtsiSubscription> subscribe(const std::vector<std::string>& fields,
+                                                             std::function<void(const RtsiSamplePtr&)> cb);
+
+    /**
+     * @brief Subscribe with a bounded queue
+     *
+     * @param fields Output recipe fields
+     * @param capacity Number of data packages the queue holds
+     * @return std::shared_ptr<RtsiSampleQueue> The queue
+     */
+    ELITE_EXPORT std::shared_ptr<RtsiSampleQueue> subscribeQueue(const std::vector<std::string>& fields, size_t capacity);
+
+    /**
+     * @brief Subscribe with a latest-value slot
+     *
+     * @param fields Output recipe fields
+     * @return std::shared_ptr<RtsiLatestSample> The slot
+     */
+    ELITE_EXPORT std::shared_ptr<RtsiLatestSample> subscribeLatest(const std::vector<std::string>& fields);
+
+    /**
+     * @brief The fields of the output recipe negotiated with the controller
+     *
+     */
+    ELITE_EXPORT std::vector<std::string> getOutputRecipe();
+
+    /**
+     * @brief Number of data packages dispatched
+     *
+     */
+    ELITE_EXPORT uint64_t getSampleCount();
+};
+
+}  // namespace ELITE
+
+#endif
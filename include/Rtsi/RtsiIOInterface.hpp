@@ -13,17 +13,42 @@
 
 #include <Elite/DataType.hpp>
 #include <Elite/EliteOptions.hpp>
+#include <Elite/Log.hpp>
 #include <Elite/RtsiClientInterface.hpp>
+#include <Elite/RobotStateBus.hpp>
+#include <Elite/RobotStateMonitor.hpp>
 #include <Elite/RtsiRecipe.hpp>
 #include <Elite/VersionInfo.hpp>
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
 
 namespace ELITE {
 
+class ReconnectSupervisor;
+
+/**
+ * @brief The time spent by each phase of the last connect
+ *
+ */
+struct RtsiConnectTimings {
+    // TCP connection
+    std::chrono::microseconds socket{0};
+    // Protocol version, controller version, recipe setup and start
+    std::chrono::microseconds handshake{0};
+    // From the receive thread creation to the first data package
+    std::chrono::microseconds first_data{0};
+    // The whole connect
+    std::chrono::microseconds total{0};
+};
+
 /**
  * @brief The RTSI interface has been functionally encapsulated.
  *
@@ -53,6 +78,55 @@ class RtsiIOInterface : public RtsiClientInterface {
      */
     ELITE_EXPORT virtual bool connect(const std::string& ip);
 
+    /**
+     * @brief Connect to RTSI server in a new thread. The handshake requests are sent at once and then the replies are
+     * matched (see RtsiClientInterface::handshake()), so it is faster than connect(). Other work, for example creating the
+     * EliteDriver, can be done while connecting.
+     *
+     * @param ip The IP of RTSI server
+     * @return std::future<bool> true if connected success. Holds an EliteException if the socket fails.
+     * @note Do not call other functions of this object before the future is ready.
+     */
+    ELITE_EXPORT std::future<bool> connectAsync(const std::string& ip);
+
+    /**
+     * @brief Get the time spent by each phase of the last connect
+     *
+     * @return RtsiConnectTimings The timings
+     */
+    ELITE_EXPORT RtsiConnectTimings getConnectTimings();
+
+    /**
+     * @brief Enable or disable the automatic reconnect. If enabled, when the connection is lost the receive thread connects
+     * again with backoff, sets up the same recipes with the pipelined handshake and sends the input recipe values again.
+     * The output recipe values keep the last received values until the connection is restored.
+     *
+     * @param enable Enable
+     * @param options Backoff settings
+     */
+    ELITE_EXPORT void setAutoReconnect(bool enable, const ReconnectOptions& options = ReconnectOptions());
+
+    /**
+     * @brief Set the callback called when the connection state changes
+     *
+     * @param cb The callback. It may be called in the receive thread, do not call connect() or disconnect() in it.
+     */
+    ELITE_EXPORT void setConnectionStateCallback(std::function<void(LinkState)> cb);
+
+    /**
+     * @brief Get the connection state
+     *
+     * @return LinkState The state
+     */
+    ELITE_EXPORT LinkState getConnectionState();
+
+    /**
+     * @brief Get the statistics of automatic reconnect
+     *
+     * @return ReconnectMetrics The statistics
+     */
+    ELITE_EXPORT ReconnectMetrics getReconnectMetrics();
+
     /**
      * @brief Disconnect
      *
@@ -431,6 +505,23 @@ class RtsiIOInterface : public RtsiClientInterface {
      */
     ELITE_EXPORT double getOutDoubleRegister(int index);
 
+    /**
+     * @brief Set a monitor that is updated every time a data package is received.
+     *  The robot mode ("robot_mode"), safety mode ("safety_status") and task status ("runtime_state") in the output recipe
+     * are written to the monitor, so the threads waiting for these states are woken without polling.
+     *
+     * @param monitor State monitor. Pass nullptr to stop updating.
+     */
+    ELITE_EXPORT void setStateMonitor(std::shared_ptr<RobotStateMonitor> monitor);
+
+    /**
+     * @brief Set a publisher that writes a RobotStateSnapshot to shared memory every time a data package is received,
+     * so other processes read the robot state with RobotStateReader instead of opening their own RTSI session.
+     *
+     * @param publisher State publisher. Pass nullptr to stop publishing.
+     */
+    ELITE_EXPORT void setStatePublisher(std::shared_ptr<RobotStatePublisher> publisher);
+
     /**
      * @brief Get data from output recipe
      *
@@ -476,6 +567,65 @@ class RtsiIOInterface : public RtsiClientInterface {
     std::unique_ptr<std::thread> recv_thread_;
     std::atomic<bool> is_recv_thread_alive_;
     VersionInfo controller_version_;
+    std::shared_ptr<RobotStateMonitor> state_monitor_;
+    std::shared_ptr<RobotStatePublisher> state_publisher_;
+    RtsiConnectTimings connect_timings_;
+    std::string ip_;
+    std::unique_ptr<ReconnectSupervisor> reconnect_;
+    // Throttles the receive errors of this interface
+    LogThrottle recv_log_throttle_;
+
+    // Notified by the receive thread when the first data package is parsed
+    std::mutex first_data_mutex_;
+    std::condition_variable first_data_cv_;
+    // Atomic because the receive thread checks it without the mutex on every package
+    std::atomic<bool> first_data_received_;
+
+    /**
+     * @brief Connect to RTSI server
+     *
+     * @param ip The IP of RTSI server
+     * @param pipelined If true, use the pipelined handshake
+     * @return true connected success
+     * @return false connected fail
+     */
+    bool connectImpl(const std::string& ip, bool pipelined);
+
+    /**
+     * @brief Send the handshake requests one by one
+     *
+     * @return true success
+     * @return false fail
+     */
+    bool sequentialHandshake();
+
+    /**
+     * @brief Send the handshake requests at once
+     *
+     * @return true success
+     * @return false fail
+     */
+    bool pipelinedHandshake();
+
+    /**
+     * @brief Connect again and set up the current recipes. Called by the receive thread.
+     *
+     * @return true success
+     * @return false fail
+     */
+    bool restoreConnection();
+
+    /**
+     * @brief Write the states in the output recipe to the state monitor.
+     *
+     */
+    void updateStateMonitor();
+
+    /**
+     * @brief Publish the output recipe to the state publisher.
+     *
+     */
+    void updateStatePublisher();
 
     /**
      * @brief Continuously receive and parse data messages.
@@ -56,6 +56,13 @@ public:
      */
     std::vector<uint8_t> packToBytes();
 
+    /**
+     * @brief Copy the values in the order of the recipe list
+     * 
+     * @param out Output values, resized to the recipe size
+     */
+    void copyValues(std::vector<RtsiTypeVariant>& out);
+
 };
 
 
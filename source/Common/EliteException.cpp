@@ -21,6 +21,12 @@ const char* EliteException::exceptionCodeToString(const Code& ec) {
         return "parametric is illegal";
     case Code::DASHBOARD_NOT_EXPECT_RECIVE:
         return "dashboard not expect recive";
+    case Code::FILE_OPEN_FAIL:
+        return "file open fail";
+    case Code::TIMEOUT:
+        return "operation timeout";
+    case Code::SHARED_MEMORY_FAIL:
+        return "shared memory fail";
     default:
         return "unknow code";
     }
@@ -0,0 +1,106 @@
+#include "ReconnectSupervisor.hpp"
+#include "Log.hpp"
+
+#include <algorithm>
+#include <thread>
+
+using namespace ELITE;
+using namespace std::chrono;
+
+ReconnectSupervisor::ReconnectSupervisor() : enabled_(false), state_(LinkState::DISCONNECTED) {
+
+}
+
+void ReconnectSupervisor::setEnabled(bool enable, const ReconnectOptions& options) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    enabled_ = enable;
+    options_ = options;
+}
+
+bool ReconnectSupervisor::isEnabled() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return enabled_;
+}
+
+ReconnectOptions ReconnectSupervisor::getOptions() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return options_;
+}
+
+void ReconnectSupervisor::setStateCallback(std::function<void(LinkState)> cb) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    state_cb_ = cb;
+}
+
+void ReconnectSupervisor::setState(LinkState state) {
+    if (state_.exchange(state) == state) {
+        return;
+    }
+    callStateCallback(state);
+}
+
+void ReconnectSupervisor::callStateCallback(LinkState state) {
+    std::function<void(LinkState)> cb;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cb = state_cb_;
+    }
+    if (cb) {
+        cb(state);
+    }
+}
+
+ReconnectMetrics ReconnectSupervisor::getMetrics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return metrics_;
+}
+
+bool ReconnectSupervisor::run(const std::function<bool()>& attempt, const std::function<bool()>& keep_running) {
+    ReconnectOptions options;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!enabled_) {
+            return false;
+        }
+        options = options_;
+    }
+    setState(LinkState::RECONNECTING);
+    auto begin = steady_clock::now();
+    double delay_ms = std::max(options.initial_delay_ms, 0);
+    for (int count = 1; options.max_attempts <= 0 || count <= options.max_attempts; count++) {
+        // Sleep in short slices, so that a disconnect does not wait for the whole backoff
+        auto wake = steady_clock::now() + microseconds((int64_t)(delay_ms * 1000));
+        while (keep_running() && steady_clock::now() < wake) {
+            std::this_thread::sleep_for(std::min(duration_cast<steady_clock::duration>(wake - steady_clock::now()),
+                                                 duration_cast<steady_clock::duration>(milliseconds(10))));
+        }
+        if (!keep_running()) {
+            break;
+        }
+        if (attempt()) {
+            auto duration = duration_cast<microseconds>(steady_clock::now() - begin);
+            LinkState previous;
+            {
+                // The metrics and the state change together
+                std::lock_guard<std::mutex> lock(mutex_);
+                metrics_.reconnects++;
+                metrics_.last_duration = duration;
+                metrics_.max_duration = std::max(metrics_.max_duration, duration);
+                previous = state_.exchange(LinkState::CONNECTED);
+            }
+            ELITE_LOG_INFO("Connection restored after %d attempts in %lld us", count, (long long)duration.count());
+            if (previous != LinkState::CONNECTED) {
+                callStateCallback(LinkState::CONNECTED);
+            }
+            return true;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            metrics_.failed_attempts++;
+        }
+        ELITE_LOG_DEBUG("Reconnect attempt %d fail", count);
+        delay_ms = std::min(std::max(delay_ms * options.backoff, 1.0), (double)options.max_delay_ms);
+    }
+    setState(LinkState::DISCONNECTED);
+    return false;
+}
@@ -49,7 +49,7 @@ void TcpServer::serverLoop() {
             }
             io_context_.run();
         } catch(const boost::system::system_error &error) {
-            ELITE_LOG_INFO("TCP server %d has error: %s", port_, error.what());
+            ELITE_LOG_INFO_THROTTLE(error_log_throttle_, 1000, "TCP server %d has error: %s", port_, error.what());
             continue;
         }
     }
@@ -3,6 +3,8 @@
 #include "EliteException.hpp"
 #include "Log.hpp"
 
+#include <cstring>
+
 using namespace ELITE;
 
 ReverseInterface::ReverseInterface(int port) : port_(port) {
@@ -16,6 +18,14 @@ ReverseInterface::ReverseInterface(int port) : port_(port) {
             }
             ELITE_LOG_INFO("Reverse interface accept new connection.");
             client_ = client;
+            if (adaptive_timeout_) {
+                adaptive_timeout_->restart();
+            }
+            last_mode_ = ControlMode::MODE_UNINITIALIZED;
+            if (latency_monitor_) {
+                latency_monitor_->restart();
+            }
+            echo_bytes_.clear();
         }
         asyncRead();
     });
@@ -34,23 +44,41 @@ void ReverseInterface::asyncRead() {
         client_.reset();
         return;
     }
-    std::shared_ptr<int> no_use;
-    no_use.reset(new int);
-    client_->async_read_some(boost::asio::buffer(no_use.get(), sizeof(int)), [&, no_use](boost::system::error_code ec, std::size_t len){
+    // The script only sends echoes, when the latency is measured
+    auto buffer = std::make_shared<std::array<uint8_t, 256>>();
+    client_->async_read_some(boost::asio::buffer(*buffer), [&, buffer](boost::system::error_code ec, std::size_t len){
         if (len <= 0 || ec) {
             ELITE_LOG_INFO("Connection to reverse interface dropped: %s", boost::system::system_error(ec).what());
             server_->releaseClient(client_);
             return;
         } else {
+            receiveEchoes(buffer->data(), len);
             asyncRead();
         }
     });
 }
 
+void ReverseInterface::receiveEchoes(const uint8_t* data, size_t size) {
+    auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(client_mutex_);
+    echo_bytes_.insert(echo_bytes_.end(), data, data + size);
+    const size_t echo_bytes = REVERSE_ECHO_SIZE * sizeof(int32_t);
+    size_t offset = 0;
+    for (; offset + echo_bytes <= echo_bytes_.size(); offset += echo_bytes) {
+        int32_t echo[REVERSE_ECHO_SIZE];
+        memcpy(echo, echo_bytes_.data() + offset, echo_bytes);
+        if (latency_monitor_) {
+            latency_monitor_->onEcho(ntohl(echo[0]), ntohl(echo[1]), ntohl(echo[2]), now);
+        }
+    }
+    echo_bytes_.erase(echo_bytes_.begin(), echo_bytes_.begin() + offset);
+}
+
 int ReverseInterface::write(int32_t buffer[], int size) {
     try {
         return client_->write_some(boost::asio::buffer(buffer, size));
     } catch(const boost::system::system_error &error) {
+        ELITE_LOG_ERROR_THROTTLE(write_log_throttle_, 1000, "Reverse interface write fail: %s", error.what());
         server_->releaseClient(client_);
         return -1;
     }
@@ -65,9 +93,13 @@ bool ReverseInterface::writeJointCommand(const vector6d_t* pos, ControlMode mode
     if (!client_) {
         return false;
     }
+    timeout = adaptTimeout(mode, timeout);
     int32_t data[REVERSE_DATA_SIZE] = {0};
     data[0] = htonl(timeout);
-    data[REVERSE_DATA_SIZE - 1] = htonl((int)mode);
+    data[REVERSE_MODE_INDEX] = htonl((int)mode);
+    if (latency_monitor_) {
+        data[REVERSE_SEQUENCE_INDEX] = htonl(latency_monitor_->onSend(std::chrono::steady_clock::now()));
+    }
     if (pos) {
         for (size_t i = 0; i < 6; i++) {
             data[i + 1] = htonl(static_cast<int>(round((*pos)[i] * CONTROL::POS_ZOOM_RATIO)));
@@ -82,11 +114,15 @@ bool ReverseInterface::writeTrajectoryControlAction(TrajectoryControlAction acti
     if (!client_) {
         return false;
     }
+    timeout = adaptTimeout(ControlMode::MODE_TRAJECTORY, timeout);
     int32_t data[REVERSE_DATA_SIZE] = {0};
     data[0] = htonl(timeout);
     data[1] = htonl((int)action);
     data[2] = htonl(point_number);
-    data[REVERSE_DATA_SIZE - 1] = htonl((int)ControlMode::MODE_TRAJECTORY);
+    data[REVERSE_MODE_INDEX] = htonl((int)ControlMode::MODE_TRAJECTORY);
+    if (latency_monitor_) {
+        data[REVERSE_SEQUENCE_INDEX] = htonl(latency_monitor_->onSend(std::chrono::steady_clock::now()));
+    }
     return write(data, sizeof(data)) > 0;
 }
 
@@ -95,13 +131,31 @@ bool ReverseInterface::stopControl() {
     if (!client_) {
         return false;
     }
-    int32_t data[REVERSE_DATA_SIZE];
+    adaptTimeout(ControlMode::MODE_STOPPED, 0);
+    int32_t data[REVERSE_DATA_SIZE] = {0};
     data[0] = 0;
-    data[REVERSE_DATA_SIZE - 1] = htonl((int)ControlMode::MODE_STOPPED);
+    data[REVERSE_MODE_INDEX] = htonl((int)ControlMode::MODE_STOPPED);
     
     return write(data, sizeof(data)) > 0;
 }
 
+int ReverseInterface::adaptTimeout(ControlMode mode, int timeout) {
+    bool mode_changed = mode != last_mode_;
+    last_mode_ = mode;
+    if (!adaptive_timeout_) {
+        return timeout;
+    }
+    if (mode_changed) {
+        // The pause while switching is not a send interval of the new mode
+        adaptive_timeout_->restart();
+    }
+    // Only the streaming modes send at a steady rate, the others keep the given timeout
+    if (mode != ControlMode::MODE_SERVOJ && mode != ControlMode::MODE_SPEEDJ && mode != ControlMode::MODE_TRAJECTORY) {
+        return timeout;
+    }
+    return adaptive_timeout_->update(std::chrono::steady_clock::now(), timeout);
+}
+
 bool ReverseInterface::isRobotConnect() {
     std::lock_guard<std::mutex> lock(client_mutex_);
     if (client_) {
@@ -110,3 +164,39 @@ bool ReverseInterface::isRobotConnect() {
         return false;
     }
 }
+
+void ReverseInterface::enableAdaptiveTimeout(const AdaptiveTimeoutOptions& options) {
+    auto adaptive_timeout = std::make_unique<AdaptiveTimeout>(options);
+    std::lock_guard<std::mutex> lock(client_mutex_);
+    adaptive_timeout_ = std::move(adaptive_timeout);
+}
+
+void ReverseInterface::disableAdaptiveTimeout() {
+    std::lock_guard<std::mutex> lock(client_mutex_);
+    adaptive_timeout_.reset();
+}
+
+AdaptiveTimeoutStatistics ReverseInterface::getAdaptiveTimeoutStatistics() {
+    std::lock_guard<std::mutex> lock(client_mutex_);
+    if (adaptive_timeout_) {
+        return adaptive_timeout_->getStatistics();
+    }
+    return AdaptiveTimeoutStatistics();
+}
+
+void ReverseInterface::setLatencyMeasurement(bool enable) {
+    std::lock_guard<std::mutex> lock(client_mutex_);
+    if (enable) {
+        latency_monitor_ = std::make_unique<ReverseLatencyMonitor>();
+    } else {
+        latency_monitor_.reset();
+    }
+}
+
+ReverseLatencyStatistics ReverseInterface::getLatencyStatistics() {
+    std::lock_guard<std::mutex> lock(client_mutex_);
+    if (latency_monitor_) {
+        return latency_monitor_->getStatistics();
+    }
+    return ReverseLatencyStatistics();
+}
@@ -127,10 +127,24 @@ bool ScriptCommandInterface::endForceMode() {
     return write(buffer, sizeof(buffer)) > 0;
 }
 
+bool ScriptCommandInterface::setServojParams(float time, float lookahead_time, int gain) {
+    std::lock_guard<std::mutex> lock(client_mutex_);
+    if (!client_) {
+        return false;
+    }
+    int32_t buffer[SCRIPT_COMMAND_DATA_SIZE] = {0};
+    buffer[0] = htonl(static_cast<int32_t>(Cmd::SET_SERVO_PARAMS));
+    buffer[1] = htonl(static_cast<int32_t>(round(time * CONTROL::COMMON_ZOOM_RATIO)));
+    buffer[2] = htonl(static_cast<int32_t>(round(lookahead_time * CONTROL::COMMON_ZOOM_RATIO)));
+    buffer[3] = htonl(gain);
+    return write(buffer, sizeof(buffer)) > 0;
+}
+
 int ScriptCommandInterface::write(int32_t buffer[], int size) {
     try {
         return client_->write_some(boost::asio::buffer(buffer, size));
     } catch(const boost::system::system_error &error) {
+        ELITE_LOG_ERROR_THROTTLE(write_log_throttle_, 1000, "Script command interface write fail: %s", error.what());
         server_->releaseClient(client_);
         return -1;
     }
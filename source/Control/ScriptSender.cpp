@@ -26,6 +26,11 @@ ScriptSender::~ScriptSender() {
     
 }
 
+void ScriptSender::setProgram(const std::string& program) {
+    std::lock_guard<std::mutex> lock(program_mutex_);
+    program_ = program;
+}
+
 
 void ScriptSender::responseRequest() {
     if (!client_) {
@@ -49,7 +54,10 @@ void ScriptSender::responseRequest() {
             std::getline(response_stream, request);
             if (request == PROGRAM_REQUEST_) {
                 boost::system::error_code wec;
-                client_->write_some(boost::asio::buffer(program_), wec);
+                {
+                    std::lock_guard<std::mutex> lock(program_mutex_);
+                    client_->write_some(boost::asio::buffer(program_), wec);
+                }
                 if (wec) {
                     ELITE_LOG_ERROR("Script sender send script fail: %s", boost::system::system_error(wec).what());
                     return;
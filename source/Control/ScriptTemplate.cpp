@@ -0,0 +1,100 @@
+#include "ScriptTemplate.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace ELITE;
+
+ScriptTemplate::ScriptTemplate(const std::string& script) : literal_size_(0), line_count_(0) {
+    const size_t begin_len = strlen(PLACEHOLDER_BEGIN);
+    const size_t end_len = strlen(PLACEHOLDER_END);
+    size_t pos = 0;
+    while (pos < script.size()) {
+        size_t begin = script.find(PLACEHOLDER_BEGIN, pos);
+        size_t end = std::string::npos;
+        if (begin != std::string::npos) {
+            end = script.find(PLACEHOLDER_END, begin + begin_len);
+        }
+        if (begin == std::string::npos || end == std::string::npos) {
+            segments_.push_back({script.substr(pos), -1});
+            break;
+        }
+        if (begin > pos) {
+            segments_.push_back({script.substr(pos, begin - pos), -1});
+        }
+        std::string name = script.substr(begin + begin_len, end - begin - begin_len);
+        auto iter = std::find(slot_names_.begin(), slot_names_.end(), name);
+        int slot = (int)(iter - slot_names_.begin());
+        if (iter == slot_names_.end()) {
+            slot_names_.push_back(name);
+            slot_values_.emplace_back();
+            slot_set_.push_back(false);
+            slot_uses_.push_back(0);
+        }
+        slot_uses_[slot]++;
+        segments_.push_back({name, slot});
+        pos = end + end_len;
+    }
+    for (auto& seg : segments_) {
+        if (seg.slot < 0) {
+            literal_size_ += seg.text.size();
+            line_count_ += std::count(seg.text.begin(), seg.text.end(), '\n');
+        }
+    }
+}
+
+bool ScriptTemplate::setValue(const std::string& name, const std::string& value) {
+    auto iter = std::find(slot_names_.begin(), slot_names_.end(), name);
+    if (iter == slot_names_.end()) {
+        return false;
+    }
+    size_t slot = iter - slot_names_.begin();
+    slot_values_[slot] = value;
+    slot_set_[slot] = true;
+    return true;
+}
+
+void ScriptTemplate::appendIndented(std::string& out, const std::string& text, const std::string& indent,
+                                    bool& line_start) const {
+    if (indent.empty()) {
+        out += text;
+        return;
+    }
+    size_t pos = 0;
+    while (pos < text.size()) {
+        // The indent is written before the first character of a line, so a trailing newline adds no indent
+        if (line_start) {
+            out += indent;
+            line_start = false;
+        }
+        size_t newline = text.find('\n', pos);
+        if (newline == std::string::npos) {
+            out.append(text, pos, std::string::npos);
+            return;
+        }
+        out.append(text, pos, newline - pos + 1);
+        line_start = true;
+        pos = newline + 1;
+    }
+}
+
+std::string ScriptTemplate::render(const std::string& indent) const {
+    size_t size = literal_size_ + indent.size() * (line_count_ + 1);
+    for (size_t i = 0; i < slot_names_.size(); i++) {
+        size_t value_size = slot_set_[i] ? slot_values_[i].size() : slot_names_[i].size() + 4;
+        size += value_size * slot_uses_[i];
+    }
+    std::string out;
+    out.reserve(size);
+    bool line_start = true;
+    for (auto& seg : segments_) {
+        if (seg.slot < 0) {
+            appendIndented(out, seg.text, indent, line_start);
+        } else if (slot_set_[seg.slot]) {
+            appendIndented(out, slot_values_[seg.slot], indent, line_start);
+        } else {
+            appendIndented(out, PLACEHOLDER_BEGIN + seg.text + PLACEHOLDER_END, indent, line_start);
+        }
+    }
+    return out;
+}
@@ -80,10 +80,52 @@ bool TrajectoryInterface::writeTrajectoryPoint( const vector6d_t& positions,
 }
 
 
+bool TrajectoryInterface::writeTrajectorySplinePoint(const vector6d_t& positions, const vector6d_t& velocities, float time) {
+    std::lock_guard<std::mutex> lock(client_mutex_);
+    if (!client_) {
+        return false;
+    }
+    // Velocities in the first spare block, the accelerations block stays zero
+    int32_t buffer[TRAJECTORY_MESSAGE_LEN] = {0};
+    for (size_t i = 0; i < 6; i++) {
+        buffer[i] = htonl(round(positions[i] * CONTROL::POS_ZOOM_RATIO));
+        buffer[i + 6] = htonl(round(velocities[i] * CONTROL::POS_ZOOM_RATIO));
+    }
+    buffer[18] = htonl(round(time * CONTROL::TIME_ZOOM_RATIO));
+    buffer[19] = htonl((int)TrajectorySplineType::CUBIC);
+    buffer[20] = htonl((int)TrajectoryMotionType::SPLINE);
+
+    return write(buffer, sizeof(buffer)) > 0;
+}
+
+
+bool TrajectoryInterface::writeTrajectorySplinePoint(const vector6d_t& positions, 
+                                                     const vector6d_t& velocities, 
+                                                     const vector6d_t& accelerations, 
+                                                     float time) {
+    std::lock_guard<std::mutex> lock(client_mutex_);
+    if (!client_) {
+        return false;
+    }
+    int32_t buffer[TRAJECTORY_MESSAGE_LEN] = {0};
+    for (size_t i = 0; i < 6; i++) {
+        buffer[i] = htonl(round(positions[i] * CONTROL::POS_ZOOM_RATIO));
+        buffer[i + 6] = htonl(round(velocities[i] * CONTROL::POS_ZOOM_RATIO));
+        buffer[i + 12] = htonl(round(accelerations[i] * CONTROL::POS_ZOOM_RATIO));
+    }
+    buffer[18] = htonl(round(time * CONTROL::TIME_ZOOM_RATIO));
+    buffer[19] = htonl((int)TrajectorySplineType::QUINTIC);
+    buffer[20] = htonl((int)TrajectoryMotionType::SPLINE);
+
+    return write(buffer, sizeof(buffer)) > 0;
+}
+
+
 int TrajectoryInterface::write(int32_t buffer[], int size) {
     try {
         return client_->write_some(boost::asio::buffer(buffer, size));
     } catch(const boost::system::system_error &error) {
+        ELITE_LOG_ERROR_THROTTLE(write_log_throttle_, 1000, "Trajectory interface write fail: %s", error.what());
         server_->releaseClient(client_);
         return -1;
     }
@@ -1,176 +1,98 @@
 #include "DashboardClient.hpp"
 #include <boost/asio.hpp>
+#include <algorithm>
+#include <atomic>
+#include <deque>
 #include <iostream>
-#include <regex>
 #include <thread>
+#include "DashboardExecutorImpl.hpp"
+#include "DashboardResponseMatcher.hpp"
 #include "DataType.hpp"
 #include "Log.hpp"
 
 using namespace ELITE;
 using namespace std::chrono_literals;
 
-class DashboardClient::Impl {
-   public:
-    std::mutex socket_mutex_;
-    boost::asio::io_context io_context_;
-    std::unique_ptr<boost::asio::ip::tcp::socket> socket_ptr_;
-    std::unique_ptr<boost::asio::ip::tcp::resolver> resolver_ptr_;
-
-    void disconnect();
-};
+namespace {
 
-DashboardClient::DashboardClient() { impl_ = std::make_unique<Impl>(); }
-
-DashboardClient::~DashboardClient() {}
-
-bool DashboardClient::connect(const std::string& ip, int port) {
-    bool ret_val = false;
-    try {
-        std::lock_guard<std::mutex> lock(impl_->socket_mutex_);
-        impl_->socket_ptr_.reset(new boost::asio::ip::tcp::socket(impl_->io_context_));
-        impl_->resolver_ptr_.reset(new boost::asio::ip::tcp::resolver(impl_->io_context_));
-        impl_->socket_ptr_->open(boost::asio::ip::tcp::v4());
-        boost::asio::ip::tcp::no_delay no_delay_option(true);
-        impl_->socket_ptr_->set_option(no_delay_option);
-        boost::asio::socket_base::reuse_address sol_reuse_option(true);
-        impl_->socket_ptr_->set_option(sol_reuse_option);
-#if defined(__linux) || defined(linux) || defined(__linux__)
-        boost::asio::detail::socket_option::boolean<IPPROTO_TCP, TCP_QUICKACK> quickack(true);
-        impl_->socket_ptr_->set_option(quickack);
-#endif
-        boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::make_address(ip), port);
-        boost::system::error_code ec = boost::asio::error::would_block;
-
-        impl_->socket_ptr_->async_connect(endpoint, [&](const boost::system::error_code& error) {
-            ec = error;
-            if (ec) {
-                ELITE_LOG_ERROR("Dashboard connect to robot fail: %s", boost::system::system_error(ec).what());
-                ret_val = false;
-            } else {
-                ret_val = true;
-            }
-        });
+/**
+ * @brief Completion of an internal operation.
+ *  code: SUCCESS, or the reason of failure
+ *  text: The response if success, otherwise the description of failure
+ */
+using Completion = std::function<void(EliteException::Code code, const std::string& text)>;
 
-        do {
-            impl_->io_context_.run_one();
-            // TODO: When all tasks in the io_context are completed, the io_context enters a 'stopped' state.
-            // How can we prevent the io_context from entering the 'stopped' state without using the 'restart' method?
-            if (impl_->io_context_.stopped()) {
-                impl_->io_context_.restart();
-            }
-        } while (ec == boost::asio::error::would_block);
+// While waiting on the monitor, check at least once per period whether it is still updating.
+constexpr auto MONITOR_STALE_CHECK_PERIOD = std::chrono::milliseconds(RobotStateMonitor::DEFAULT_STALE_TIMEOUT_MS);
+// Poll the dashboard every period, when there is no monitor.
+constexpr auto DASHBOARD_POLL_PERIOD = 100ms;
 
-    } catch (const boost::system::system_error& error) {
-        ELITE_LOG_ERROR("Dashboard connect to robot fail: %s", error.what());
-        throw EliteException(EliteException::Code::SOCKET_CONNECT_FAIL, error.what());
-    }
-    asyncReadLine();
-    return ret_val;
-}
+bool isCancelled(const DashboardCancelToken& token) { return token && token->load(); }
 
-void DashboardClient::disconnect() {
-    std::lock_guard<std::mutex> lock(impl_->socket_mutex_);
-    impl_->disconnect();
+std::chrono::milliseconds requestTimeout(const DashboardAsyncOptions& options) {
+    return options.timeout.count() > 0 ? options.timeout
+                                       : std::chrono::milliseconds(DashboardClient::DEFAULT_REQUEST_TIMEOUT_MS);
 }
 
-void DashboardClient::Impl::disconnect() { socket_ptr_.reset(); }
-
-bool DashboardClient::brakeRelease() {
-    std::string response = sendAndRequest("brakeRelease\n", "Brake (Releasing.*|is released).*");
-    if (response.empty()) {
-        return false;
-    }
-    return waitForReply("robotMode\n", "robotMode: RUNNING\r\n");
+std::chrono::milliseconds stateTimeout(const DashboardAsyncOptions& options) {
+    return options.timeout.count() > 0 ? options.timeout
+                                       : std::chrono::milliseconds(DashboardClient::DEFAULT_STATE_TIMEOUT_MS);
 }
 
-bool DashboardClient::closeSafetyDialog() {
-    std::string response = sendAndRequest("closeSafetyDialog\n", "closing .* dialog\r\n");
-    return !response.empty();
+std::chrono::milliseconds remaining(std::chrono::steady_clock::time_point deadline) {
+    auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+    return left.count() > 0 ? left : 1ms;
 }
 
-bool DashboardClient::echo() {
-    std::string response = sendAndRequest("echo\n", "Hello ELITE ROBOTS.\r\n");
-    return !response.empty();
-}
-
-std::string DashboardClient::help(const std::string& cmd) {
-    std::string send_string = "help " + cmd + '\n';
-    return sendAndRequest(send_string);
-}
-
-bool DashboardClient::log(const std::string& message) {
-    std::string message_cpy = message;
-    size_t found = message_cpy.find("\n");
-    while (found != std::string::npos) {
-        message_cpy.replace(found, 1, "\\n");
-        found = message_cpy.find("\n", found);
+/**
+ * @brief Check the response of a command
+ *
+ * @param cmd Dashboard command
+ * @param expected Expected response, empty means any response
+ * @param response The response
+ * @return std::string The matched part of response, or the whole response if 'expected' is empty
+ * @throw EliteException DASHBOARD_NOT_EXPECT_RECIVE if not matched
+ */
+std::string expectResponse(const std::string& cmd, const std::string& expected, const std::string& response) {
+    if (expected.empty()) {
+        return response;
     }
-
-    found = message_cpy.find("\r");
-    while (found != std::string::npos) {
-        message_cpy.replace(found, 1, "\\r");
-        found = message_cpy.find("\r", found);
+    std::string match;
+    if (!DashboardResponseMatcher::get(expected)->search(response, match)) {
+        throw EliteException(
+            EliteException::Code::DASHBOARD_NOT_EXPECT_RECIVE,
+            "Dashboard command \"" + cmd + "\" response expected: " + expected + ". But received: " + response);
     }
-
-    std::string send_string = "log -a " + message_cpy + "\n";
-    std::string response = sendAndRequest(send_string, "Log has been added.\r\n");
-    return !response.empty();
+    return match;
 }
 
-bool DashboardClient::popup(const std::string& arg, const std::string& message) {
-    std::string send_string;
-    if (arg == "-c") {
-        send_string = "popup " + arg + "\n";
-    } else if (arg == "-s") {
-        send_string = "popup " + arg + message + "\n";
-    } else {
-        throw EliteException(EliteException::Code::ILLEGAL_PARAM, "dashboard popup command");
+template <typename T, typename Parse>
+void fulfil(std::promise<T>& promise, Parse& parse, const std::string& response) {
+    try {
+        promise.set_value(parse(response));
+    } catch (...) {
+        promise.set_exception(std::current_exception());
     }
-    std::string response = sendAndRequest(send_string, "Closing popup\r\n|Showing popup with text:.*\\s**");
-    return !response.empty();
 }
 
-void DashboardClient::quit() {
-    sendAndRequest("quit\n");
-    impl_->disconnect();
-}
-
-void DashboardClient::reboot() {
-    sendAndRequest("reboot\n");
-    impl_->disconnect();
-}
-
-std::string DashboardClient::robot() { return sendAndRequest("robot\n"); }
-
-bool DashboardClient::powerOn() {
-    std::string response = sendAndRequest("robotControl -on\n", "Powering on\r\n");
-    return waitForReply("robotMode\n", "robotMode: (RUNNING|IDLE)\r\n");
-}
-
-bool DashboardClient::powerOff() {
-    std::string response = sendAndRequest("robotControl -off\n", "Powering off\r\n");
-    // Beacuse of robot after power off need time to
-    // complete some operation (robot still return "POWER_OFF" by "robotMode" command), delay there
-    std::this_thread::sleep_for(500ms);
-    return waitForReply("robotMode\n", "robotMode: POWER_OFF\r\n");
-}
-
-void DashboardClient::shutdown() {
-    sendAndRequest("shutdown\n");
-    impl_->disconnect();
+template <typename Parse>
+void fulfil(std::promise<void>& promise, Parse& parse, const std::string& response) {
+    try {
+        parse(response);
+        promise.set_value();
+    } catch (...) {
+        promise.set_exception(std::current_exception());
+    }
 }
 
-int DashboardClient::speedScaling() {
-    std::string request = sendAndRequest("status\n", "Target Speed Fraction:.*");
-    std::size_t pos = request.find(": ");
-    request = request.substr(pos + 2);
-    return std::stoi(request);
+int parseSpeedScaling(const std::string& response) {
+    std::size_t pos = response.find(": ");
+    return std::stoi(response.substr(pos + 2));
 }
 
-RobotMode DashboardClient::robotMode() {
-    std::string request = sendAndRequest("robotMode\n", "robotMode:.*");
-    std::size_t pos = request.find(": ");
-    std::string mode = request.substr(pos + 2);
+RobotMode parseRobotMode(const std::string& response) {
+    std::size_t pos = response.find(": ");
+    std::string mode = response.substr(pos + 2);
     if (mode == "NO_CONTROLLER") {
         return RobotMode::NO_CONTROLLER;
     } else if (mode == "DISCONNECTED") {
@@ -198,10 +120,9 @@ RobotMode DashboardClient::robotMode() {
     }
 }
 
-SafetyMode DashboardClient::safetyMode() {
-    std::string request = sendAndRequest("safety -s\n", "Safety status:.*");
-    std::size_t pos = request.find(": ");
-    std::string status = request.substr(pos + 2);
+SafetyMode parseSafetyMode(const std::string& response) {
+    std::size_t pos = response.find(": ");
+    std::string status = response.substr(pos + 2);
     if (status == "NORMAL") {
         return SafetyMode::NORMAL;
     } else if (status == "REDUCED") {
@@ -235,15 +156,9 @@ SafetyMode DashboardClient::safetyMode() {
     }
 }
 
-bool DashboardClient::safetySystemRestart() {
-    sendAndRequest("safety -r\n", "Restarting safety board.*");
-    return waitForReply("safety -m\n", "Safety mode: NORMAL\r\n");
-}
-
-TaskStatus DashboardClient::runningStatus() {
-    std::string request = sendAndRequest("status\n", "RunningStatus:.*");
-    std::size_t pos = request.find(": ");
-    std::string status = request.substr(pos + 2);
+TaskStatus parseRunningStatus(const std::string& response) {
+    std::size_t pos = response.find(": ");
+    std::string status = response.substr(pos + 2);
     if (status.find("STOP") != std::string::npos) {
         return TaskStatus::STOPPED;
     } else if (status.find("RUNNING") != std::string::npos) {
@@ -254,6 +169,895 @@ TaskStatus DashboardClient::runningStatus() {
     return TaskStatus::STOPPED;
 }
 
+std::string parseConfigurationPath(const std::string& response) {
+    std::size_t pos = response.find("Relative path:");
+    return response.substr(pos + (sizeof("Relative path:") - 1));
+}
+
+bool parseConfigurationModify(const std::string& response) {
+    if (response.find("not modified") != std::string::npos) {
+        return false;
+    } else {
+        return true;
+    }
+}
+
+std::string parseTaskPath(const std::string& response) {
+    const char* kw = "Relative path:";
+    constexpr size_t kw_size = sizeof("Relative path:") - 1;
+    std::size_t pos = response.find(kw);
+    if (pos != std::string::npos) {
+        // Exclude prefixes and newline characters.
+        return response.substr(pos + kw_size, response.length() - kw_size - 2);
+    }
+    return response;
+}
+
+TaskStatus parseTaskStatus(const std::string& response) {
+    if (response.find("stopped") != std::string::npos) {
+        return TaskStatus::STOPPED;
+    } else if (response.find("paused") != std::string::npos) {
+        return TaskStatus::PAUSED;
+    } else if (response.find("running") != std::string::npos) {
+        return TaskStatus::PLAYING;
+    } else {
+        return TaskStatus::STOPPED;
+    }
+}
+
+bool parseTaskIsRunning(const std::string& response) {
+    if (response.find("not running") != std::string::npos) {
+        return false;
+    } else if (response.find("is running") != std::string::npos) {
+        return true;
+    }
+    return false;
+}
+
+bool parseTaskSaved(const std::string& response) {
+    if (response == "Task is saved") {
+        return true;
+    } else {
+        return false;
+    }
+}
+
+std::string logCommand(const std::string& message) {
+    std::string message_cpy = message;
+    size_t found = message_cpy.find("\n");
+    while (found != std::string::npos) {
+        message_cpy.replace(found, 1, "\\n");
+        found = message_cpy.find("\n", found);
+    }
+
+    found = message_cpy.find("\r");
+    while (found != std::string::npos) {
+        message_cpy.replace(found, 1, "\\r");
+        found = message_cpy.find("\r", found);
+    }
+    return "log -a " + message_cpy + "\n";
+}
+
+std::string popupCommand(const std::string& arg, const std::string& message) {
+    if (arg == "-c") {
+        return "popup " + arg + "\n";
+    } else if (arg == "-s") {
+        return "popup " + arg + message + "\n";
+    } else {
+        throw EliteException(EliteException::Code::ILLEGAL_PARAM, "dashboard popup command");
+    }
+}
+
+const char* const POPUP_EXPECTED = "Closing popup\r\n|Showing popup with text:.*\\s**";
+
+}  // namespace
+
+namespace ELITE {
+
+/**
+ * @brief
+ *      The socket of a dashboard connection and the commands on it.
+ *      All state is touched only in the strand, so the session can be driven by any number of threads.
+ *      The completion handlers keep the session alive, it may outlive the DashboardClient.
+ */
+class DashboardSession : public std::enable_shared_from_this<DashboardSession> {
+   public:
+    enum class State { DISCONNECTED, CONNECTING, CONNECTED };
+
+    explicit DashboardSession(boost::asio::io_context& io_context)
+        : io_context_(io_context), strand_(boost::asio::make_strand(io_context)) {}
+
+    /**
+     * @brief Connect to dashboard server and read the welcome message
+     *
+     * @param done SUCCESS if connected. On fail, SOCKET_CONNECT_FAIL, TIMEOUT or SOCKET_OPT_CANCEL.
+     */
+    void connect(const std::string& ip, int port, std::chrono::milliseconds timeout, DashboardCancelToken token,
+                 Completion done);
+
+    /**
+     * @brief Close the socket and fail all commands.
+     *
+     * @param done Called after closed, can be nullptr
+     */
+    void close(const std::string& reason, std::function<void()> done);
+
+    /**
+     * @brief Queue a command. The command is written when the number of commands in flight is under the pipeline depth.
+     *
+     * @param done Called with the response line (include "\r\n")
+     */
+    void submit(const std::string& cmd, std::chrono::milliseconds timeout, DashboardCancelToken token, Completion done);
+
+    /**
+     * @brief Same as submit(), and check the response.
+     *
+     * @param done Called with the matched part of response, or DASHBOARD_NOT_EXPECT_RECIVE
+     */
+    void request(const std::string& cmd, const std::string& expected, std::chrono::milliseconds timeout,
+                 DashboardCancelToken token, Completion done);
+
+    /**
+     * @brief Wait until a robot state is reached.
+     *  While the monitor is updating, the state is checked on every update of the monitor, otherwise the dashboard is
+     *  polled.
+     *
+     * @param monitor State monitor, can be nullptr
+     * @param reached Check the state in the monitor. nullptr means always poll the dashboard.
+     * @param cmd The dashboard command to poll
+     * @param expected The response of the target state, the whole response must match
+     * @param done Called with true if reached, false if the deadline expired
+     */
+    void waitState(std::shared_ptr<RobotStateMonitor> monitor, std::function<bool(RobotStateMonitor&)> reached,
+                   const std::string& cmd, const std::string& expected, std::chrono::steady_clock::time_point deadline,
+                   DashboardCancelToken token, std::function<void(EliteException::Code, bool)> done);
+
+    /**
+     * @brief Run a function in the strand after a delay
+     *
+     */
+    void after(std::chrono::milliseconds delay, std::function<void()> fn);
+
+    /**
+     * @brief Fail the commands which use the token
+     *
+     * @param token The token. nullptr means all commands.
+     */
+    void cancel(const DashboardCancelToken& token);
+
+    /**
+     * @brief Call 'done' when there is no unfinished command
+     *
+     */
+    void drain(std::function<void()> done);
+
+    void setPipelineDepth(size_t depth);
+
+    bool isConnected() const { return state_ != State::DISCONNECTED; }
+
+    size_t inFlight() const { return in_flight_count_; }
+
+   private:
+    struct PendingCommand {
+        std::string cmd;
+        Completion done;
+        DashboardCancelToken token;
+        std::unique_ptr<boost::asio::steady_timer> deadline;
+        bool finished = false;
+    };
+    using PendingPtr = std::shared_ptr<PendingCommand>;
+
+    struct StateWait {
+        std::shared_ptr<RobotStateMonitor> monitor;
+        std::function<bool(RobotStateMonitor&)> reached;
+        std::string cmd;
+        std::shared_ptr<const DashboardResponseMatcher> matcher;
+        std::chrono::steady_clock::time_point deadline;
+        DashboardCancelToken token;
+        uint64_t cancel_epoch;
+        std::function<void(EliteException::Code, bool)> done;
+        // Registered in the monitor while waiting on it, -1 otherwise
+        int listener_id = -1;
+        // Set by the listener until the posted step runs, so that the updates do not flood the strand
+        std::atomic<bool> notified{false};
+        // Wakes the wait at the deadline, or once per stale check period while waiting on the monitor
+        std::unique_ptr<boost::asio::steady_timer> timer;
+        // Incremented to ignore a timer that expired before it was cancelled
+        uint64_t timer_generation = 0;
+        // Set while a dashboard poll or the delay after it is running, which steps the wait itself
+        bool polling = false;
+        bool finished = false;
+    };
+
+    void finish(const PendingPtr& pending, EliteException::Code code, const std::string& text);
+    void closeSocket(const std::string& reason);
+    void pump();
+    void startWrite();
+    void startRead();
+    void stepStateWait(std::shared_ptr<StateWait> wait);
+    void watchMonitor(const std::shared_ptr<StateWait>& wait);
+    void unwatchMonitor(const std::shared_ptr<StateWait>& wait);
+    void finishStateWait(const std::shared_ptr<StateWait>& wait, EliteException::Code code, bool reached);
+    void startDeadline(const PendingPtr& pending, std::chrono::milliseconds timeout);
+
+    boost::asio::io_context& io_context_;
+    boost::asio::strand<boost::asio::io_context::executor_type> strand_;
+    std::unique_ptr<boost::asio::ip::tcp::socket> socket_;
+    // Keep the receive buffer, the pipelined responses may arrive in one segment.
+    boost::asio::streambuf read_buffer_;
+    // The commands waiting to be written, in order of submitting.
+    std::deque<PendingPtr> send_queue_;
+    // The commands waiting for response, in order of writing. Finished commands stay here until their response arrives.
+    std::deque<PendingPtr> in_flight_;
+    std::string write_buffer_;
+    std::string writing_buffer_;
+    bool writing_ = false;
+    bool reading_ = false;
+    size_t pipeline_depth_ = DashboardClient::DEFAULT_PIPELINE_DEPTH;
+    size_t unfinished_ = 0;
+    std::vector<std::function<void()>> drain_waiters_;
+    // Changed when the socket is closed, the completions of the old socket are ignored.
+    uint64_t generation_ = 0;
+    // Changed by cancel(nullptr), the state waits started before are cancelled.
+    uint64_t cancel_epoch_ = 0;
+    std::atomic<State> state_{State::DISCONNECTED};
+    std::atomic<size_t> in_flight_count_{0};
+};
+
+void DashboardSession::connect(const std::string& ip, int port, std::chrono::milliseconds timeout,
+                               DashboardCancelToken token, Completion done) {
+    auto self = shared_from_this();
+    boost::asio::post(strand_, [this, self, ip, port, timeout, token, done]() {
+        closeSocket("reconnect");
+        if (isCancelled(token)) {
+            done(EliteException::Code::SOCKET_OPT_CANCEL, "dashboard connect cancelled");
+            return;
+        }
+        boost::asio::ip::tcp::endpoint endpoint;
+        try {
+            socket_.reset(new boost::asio::ip::tcp::socket(io_context_));
+            socket_->open(boost::asio::ip::tcp::v4());
+            boost::asio::ip::tcp::no_delay no_delay_option(true);
+            socket_->set_option(no_delay_option);
+            boost::asio::socket_base::reuse_address sol_reuse_option(true);
+            socket_->set_option(sol_reuse_option);
+#if defined(__linux) || defined(linux) || defined(__linux__)
+            boost::asio::detail::socket_option::boolean<IPPROTO_TCP, TCP_QUICKACK> quickack(true);
+            socket_->set_option(quickack);
+#endif
+            endpoint = boost::asio::ip::tcp::endpoint(boost::asio::ip::make_address(ip), port);
+        } catch (const boost::system::system_error& error) {
+            ELITE_LOG_ERROR("Dashboard connect to robot fail: %s", error.what());
+            socket_.reset();
+            done(EliteException::Code::SOCKET_CONNECT_FAIL, error.what());
+            return;
+        }
+        state_ = State::CONNECTING;
+        uint64_t generation = generation_;
+
+        // The welcome message is the response of an empty command, which is not written.
+        PendingPtr welcome = std::make_shared<PendingCommand>();
+        welcome->token = token;
+        welcome->done = done;
+        unfinished_++;
+        startDeadline(welcome, timeout);
+        in_flight_.push_back(welcome);
+
+        socket_->async_connect(
+            endpoint, boost::asio::bind_executor(strand_, [this, self, generation](const boost::system::error_code& ec) {
+                if (generation != generation_) {
+                    return;
+                }
+                if (ec) {
+                    ELITE_LOG_ERROR("Dashboard connect to robot fail: %s", boost::system::system_error(ec).what());
+                    closeSocket(ec.message());
+                    return;
+                }
+                state_ = State::CONNECTED;
+                pump();
+            }));
+    });
+}
+
+void DashboardSession::close(const std::string& reason, std::function<void()> done) {
+    auto self = shared_from_this();
+    boost::asio::post(strand_, [this, self, reason, done]() {
+        closeSocket(reason);
+        if (done) {
+            done();
+        }
+    });
+}
+
+void DashboardSession::submit(const std::string& cmd, std::chrono::milliseconds timeout, DashboardCancelToken token,
+                              Completion done) {
+    auto self = shared_from_this();
+    PendingPtr pending = std::make_shared<PendingCommand>();
+    pending->cmd = (!cmd.empty() && cmd.back() == '\n') ? cmd : cmd + "\n";
+    pending->token = std::move(token);
+    pending->done = std::move(done);
+    boost::asio::post(strand_, [this, self, pending, timeout]() {
+        unfinished_++;
+        if (isCancelled(pending->token)) {
+            finish(pending, EliteException::Code::SOCKET_OPT_CANCEL, "dashboard command cancelled");
+            return;
+        }
+        if (state_ == State::DISCONNECTED) {
+            ELITE_LOG_ERROR("Dashboard not connect to robot");
+            finish(pending, EliteException::Code::SOCKET_FAIL, "dashboard not connected");
+            return;
+        }
+        startDeadline(pending, timeout);
+        send_queue_.push_back(pending);
+        pump();
+    });
+}
+
+void DashboardSession::request(const std::string& cmd, const std::string& expected, std::chrono::milliseconds timeout,
+                               DashboardCancelToken token, Completion done) {
+    submit(cmd, timeout, std::move(token), [cmd, expected, done](EliteException::Code code, const std::string& text) {
+        if (code != EliteException::Code::SUCCESS) {
+            done(code, text);
+            return;
+        }
+        std::string match;
+        try {
+            match = expectResponse(cmd, expected, text);
+        } catch (const EliteException& e) {
+            done(EliteException::Code::DASHBOARD_NOT_EXPECT_RECIVE, e.what());
+            return;
+        }
+        done(EliteException::Code::SUCCESS, match);
+    });
+}
+
+void DashboardSession::waitState(std::shared_ptr<RobotStateMonitor> monitor,
+                                 std::function<bool(RobotStateMonitor&)> reached, const std::string& cmd,
+                                 const std::string& expected, std::chrono::steady_clock::time_point deadline,
+                                 DashboardCancelToken token, std::function<void(EliteException::Code, bool)> done) {
+    auto self = shared_from_this();
+    auto wait = std::make_shared<StateWait>();
+    wait->monitor = std::move(monitor);
+    wait->reached = std::move(reached);
+    wait->cmd = cmd;
+    wait->matcher = DashboardResponseMatcher::get(expected);
+    wait->deadline = deadline;
+    wait->token = std::move(token);
+    wait->done = std::move(done);
+    boost::asio::post(strand_, [this, self, wait]() {
+        wait->cancel_epoch = cancel_epoch_;
+        stepStateWait(wait);
+    });
+}
+
+void DashboardSession::stepStateWait(std::shared_ptr<StateWait> wait) {
+    if (wait->finished) {
+        return;
+    }
+    if (isCancelled(wait->token) || wait->cancel_epoch != cancel_epoch_) {
+        finishStateWait(wait, EliteException::Code::SOCKET_OPT_CANCEL, false);
+        return;
+    }
+    if (std::chrono::steady_clock::now() >= wait->deadline) {
+        finishStateWait(wait, EliteException::Code::SUCCESS, false);
+        return;
+    }
+    if (wait->reached && wait->monitor && wait->monitor->isUpdating()) {
+        if (wait->reached(*wait->monitor)) {
+            finishStateWait(wait, EliteException::Code::SUCCESS, true);
+        } else {
+            watchMonitor(wait);
+        }
+        return;
+    }
+    unwatchMonitor(wait);
+    auto self = shared_from_this();
+    wait->polling = true;
+    submit(wait->cmd, remaining(wait->deadline), wait->token,
+           [this, self, wait](EliteException::Code code, const std::string& text) {
+               if (code == EliteException::Code::TIMEOUT) {
+                   finishStateWait(wait, EliteException::Code::SUCCESS, false);
+               } else if (code != EliteException::Code::SUCCESS) {
+                   finishStateWait(wait, code, false);
+               } else if (wait->matcher->match(text)) {
+                   finishStateWait(wait, EliteException::Code::SUCCESS, true);
+               } else {
+                   after(DASHBOARD_POLL_PERIOD, [this, self, wait]() {
+                       wait->polling = false;
+                       stepStateWait(wait);
+                   });
+               }
+           });
+}
+
+void DashboardSession::watchMonitor(const std::shared_ptr<StateWait>& wait) {
+    auto self = shared_from_this();
+    if (wait->listener_id < 0) {
+        std::weak_ptr<StateWait> weak = wait;
+        wait->listener_id = wait->monitor->addListener([this, self, weak]() {
+            auto wait = weak.lock();
+            if (!wait || wait->notified.exchange(true)) {
+                return;
+            }
+            boost::asio::post(strand_, [this, self, wait]() {
+                wait->notified = false;
+                if (wait->listener_id >= 0) {
+                    stepStateWait(wait);
+                }
+            });
+        });
+    }
+    if (wait->timer) {
+        return;
+    }
+    auto now = std::chrono::steady_clock::now();
+    uint64_t generation = ++wait->timer_generation;
+    wait->timer.reset(new boost::asio::steady_timer(io_context_, std::min(wait->deadline, now + MONITOR_STALE_CHECK_PERIOD)));
+    wait->timer->async_wait(
+        boost::asio::bind_executor(strand_, [this, self, wait, generation](const boost::system::error_code& ec) {
+            if (ec || generation != wait->timer_generation || wait->polling) {
+                return;
+            }
+            wait->timer.reset();
+            stepStateWait(wait);
+        }));
+}
+
+void DashboardSession::unwatchMonitor(const std::shared_ptr<StateWait>& wait) {
+    if (wait->listener_id >= 0) {
+        wait->monitor->removeListener(wait->listener_id);
+        wait->listener_id = -1;
+    }
+    if (wait->timer) {
+        wait->timer_generation++;
+        wait->timer->cancel();
+        wait->timer.reset();
+    }
+}
+
+void DashboardSession::finishStateWait(const std::shared_ptr<StateWait>& wait, EliteException::Code code,
+                                       bool reached) {
+    if (wait->finished) {
+        return;
+    }
+    wait->finished = true;
+    unwatchMonitor(wait);
+    wait->done(code, reached);
+}
+
+void DashboardSession::after(std::chrono::milliseconds delay, std::function<void()> fn) {
+    auto timer = std::make_shared<boost::asio::steady_timer>(io_context_, delay);
+    timer->async_wait(boost::asio::bind_executor(strand_, [timer, fn](const boost::system::error_code& ec) {
+        if (!ec) {
+            fn();
+        }
+    }));
+}
+
+void DashboardSession::cancel(const DashboardCancelToken& token) {
+    auto self = shared_from_this();
+    boost::asio::post(strand_, [this, self, token]() {
+        if (!token) {
+            cancel_epoch_++;
+        }
+        // The callbacks may not touch the queues, but iterate over copies to be safe.
+        for (auto& queue : {send_queue_, in_flight_}) {
+            for (auto& pending : queue) {
+                if (!token || pending->token == token) {
+                    finish(pending, EliteException::Code::SOCKET_OPT_CANCEL, "dashboard command cancelled");
+                }
+            }
+        }
+        // Connect is cancelled with the welcome message.
+        if (!in_flight_.empty() && in_flight_.front()->cmd.empty() && in_flight_.front()->finished) {
+            closeSocket("connect cancelled");
+        }
+    });
+}
+
+void DashboardSession::drain(std::function<void()> done) {
+    auto self = shared_from_this();
+    boost::asio::post(strand_, [this, self, done]() {
+        if (unfinished_ == 0) {
+            done();
+        } else {
+            drain_waiters_.push_back(done);
+        }
+    });
+}
+
+void DashboardSession::setPipelineDepth(size_t depth) {
+    auto self = shared_from_this();
+    boost::asio::post(strand_, [this, self, depth]() {
+        pipeline_depth_ = depth > 0 ? depth : 1;
+        pump();
+    });
+}
+
+void DashboardSession::startDeadline(const PendingPtr& pending, std::chrono::milliseconds timeout) {
+    if (timeout.count() <= 0) {
+        return;
+    }
+    auto self = shared_from_this();
+    std::weak_ptr<PendingCommand> weak = pending;
+    pending->deadline.reset(new boost::asio::steady_timer(io_context_, timeout));
+    pending->deadline->async_wait(
+        boost::asio::bind_executor(strand_, [this, self, weak](const boost::system::error_code& ec) {
+            PendingPtr pending = weak.lock();
+            if (ec || !pending) {
+                return;
+            }
+            ELITE_LOG_WARN("Dashboard command \"%s\" timeout", pending->cmd.substr(0, pending->cmd.find('\n')).c_str());
+            finish(pending, EliteException::Code::TIMEOUT, "dashboard command timeout");
+            // The welcome message is not received, give up the connection.
+            if (pending->cmd.empty()) {
+                closeSocket("connect timeout");
+            }
+        }));
+}
+
+void DashboardSession::finish(const PendingPtr& pending, EliteException::Code code, const std::string& text) {
+    if (pending->finished) {
+        return;
+    }
+    pending->finished = true;
+    if (pending->deadline) {
+        pending->deadline->cancel();
+    }
+    if (code != EliteException::Code::SUCCESS && !pending->cmd.empty()) {
+        ELITE_LOG_DEBUG("Dashboard command \"%s\" not answered: %s", pending->cmd.c_str(), text.c_str());
+    }
+    try {
+        pending->done(code, text);
+    } catch (const std::exception& e) {
+        ELITE_LOG_ERROR("Dashboard command \"%s\" callback throw: %s", pending->cmd.c_str(), e.what());
+    }
+    if (--unfinished_ == 0) {
+        std::vector<std::function<void()>> waiters;
+        waiters.swap(drain_waiters_);
+        for (auto& waiter : waiters) {
+            waiter();
+        }
+    }
+}
+
+void DashboardSession::closeSocket(const std::string& reason) {
+    generation_++;
+    state_ = State::DISCONNECTED;
+    if (socket_) {
+        boost::system::error_code ignore;
+        socket_->close(ignore);
+        socket_.reset();
+    }
+    read_buffer_.consume(read_buffer_.size());
+    write_buffer_.clear();
+    writing_ = false;
+    reading_ = false;
+    std::deque<PendingPtr> in_flight;
+    std::deque<PendingPtr> send_queue;
+    in_flight.swap(in_flight_);
+    send_queue.swap(send_queue_);
+    in_flight_count_ = 0;
+    for (auto& queue : {in_flight, send_queue}) {
+        for (auto& pending : queue) {
+            finish(pending, EliteException::Code::SOCKET_FAIL, "dashboard " + reason);
+        }
+    }
+}
+
+void DashboardSession::pump() {
+    if (state_ != State::CONNECTED) {
+        return;
+    }
+    while (!send_queue_.empty() && in_flight_.size() < pipeline_depth_) {
+        PendingPtr pending = std::move(send_queue_.front());
+        send_queue_.pop_front();
+        if (pending->finished) {
+            continue;
+        }
+        write_buffer_ += pending->cmd;
+        in_flight_.push_back(std::move(pending));
+    }
+    in_flight_count_ = in_flight_.size();
+    startWrite();
+    startRead();
+}
+
+void DashboardSession::startWrite() {
+    if (writing_ || write_buffer_.empty()) {
+        return;
+    }
+    writing_ = true;
+    writing_buffer_.swap(write_buffer_);
+    auto self = shared_from_this();
+    uint64_t generation = generation_;
+    boost::asio::async_write(
+        *socket_, boost::asio::buffer(writing_buffer_),
+        boost::asio::bind_executor(strand_, [this, self, generation](const boost::system::error_code& ec, std::size_t) {
+            if (generation != generation_) {
+                return;
+            }
+            writing_ = false;
+            writing_buffer_.clear();
+            if (ec) {
+                ELITE_LOG_ERROR("Dashboard send fail: %s", ec.message().c_str());
+                closeSocket(ec.message());
+                return;
+            }
+            startWrite();
+        }));
+}
+
+void DashboardSession::startRead() {
+    if (reading_ || in_flight_.empty()) {
+        return;
+    }
+    reading_ = true;
+    auto self = shared_from_this();
+    uint64_t generation = generation_;
+    boost::asio::async_read_until(
+        *socket_, read_buffer_, '\n',
+        boost::asio::bind_executor(
+            strand_, [this, self, generation](const boost::system::error_code& ec, std::size_t line_len) {
+                if (generation != generation_) {
+                    return;
+                }
+                reading_ = false;
+                if (ec) {
+                    ELITE_LOG_ERROR("Dashboard receive fail: %s", ec.message().c_str());
+                    closeSocket(ec.message());
+                    return;
+                }
+                // Only take one line, the remaining bytes belong to the next response.
+                auto begin = boost::asio::buffers_begin(read_buffer_.data());
+                std::string line(begin, begin + line_len);
+                read_buffer_.consume(line_len);
+                PendingPtr pending = std::move(in_flight_.front());
+                in_flight_.pop_front();
+                finish(pending, EliteException::Code::SUCCESS, line);
+                pump();
+            }));
+}
+
+}  // namespace ELITE
+
+class DashboardClient::Impl {
+   public:
+    // Used when there is no executor, driven by the thread that waits for a result.
+    std::unique_ptr<boost::asio::io_context> io_context_;
+    std::unique_ptr<boost::asio::executor_work_guard<boost::asio::io_context::executor_type>> work_guard_;
+    std::shared_ptr<DashboardExecutor> executor_;
+    std::shared_ptr<DashboardSession> session_;
+    std::shared_ptr<RobotStateMonitor> state_monitor_;
+
+    ~Impl() {
+        session_->close("client destroyed", nullptr);
+        if (io_context_) {
+            // Run the close and the aborted completions, so the socket is released before the io_context.
+            io_context_->poll();
+        }
+        session_.reset();
+        work_guard_.reset();
+    }
+
+    /**
+     * @brief Wait for the future. Without an executor, the calling thread runs the io_context meanwhile.
+     *
+     */
+    template <typename T>
+    T wait(std::future<T>& future) {
+        if (io_context_) {
+            while (future.wait_for(0s) != std::future_status::ready) {
+                io_context_->run_one_for(50ms);
+            }
+        } else if (executor_->runningInThisThread()) {
+            // The result can only be produced by this thread.
+            throw EliteException(EliteException::Code::ILLEGAL_PARAM, "dashboard blocking function called in executor");
+        }
+        return future.get();
+    }
+
+    static std::exception_ptr makeError(EliteException::Code code, const std::string& text) {
+        return std::make_exception_ptr(EliteException(code, text));
+    }
+
+    template <typename T, typename Parse>
+    std::future<T> command(const std::string& cmd, const std::string& expected, const DashboardAsyncOptions& options,
+                           Parse parse) {
+        auto promise = std::make_shared<std::promise<T>>();
+        std::future<T> future = promise->get_future();
+        session_->request(cmd, expected, requestTimeout(options), options.cancel_token,
+                          [promise, parse](EliteException::Code code, const std::string& text) mutable {
+                              if (code != EliteException::Code::SUCCESS) {
+                                  promise->set_exception(makeError(code, text));
+                              } else {
+                                  fulfil(*promise, parse, text);
+                              }
+                          });
+        return future;
+    }
+
+    /**
+     * @brief Send a command, if the response is accepted, wait for a robot state.
+     *
+     * @param accepted Check the response, nullptr means any response that matches 'expected'
+     * @param delay Delay before waiting for the state
+     */
+    std::future<bool> commandThenWait(const std::string& cmd, const std::string& expected,
+                                      std::function<bool(const std::string&)> accepted,
+                                      std::function<bool(RobotStateMonitor&)> reached, const std::string& poll_cmd,
+                                      const std::string& poll_expected, const DashboardAsyncOptions& options,
+                                      std::chrono::milliseconds delay = 0ms) {
+        auto promise = std::make_shared<std::promise<bool>>();
+        std::future<bool> future = promise->get_future();
+        auto deadline = std::chrono::steady_clock::now() + stateTimeout(options);
+        auto session = session_;
+        auto monitor = std::atomic_load(&state_monitor_);
+        auto token = options.cancel_token;
+        session->request(
+            cmd, expected, remaining(deadline), token,
+            [=](EliteException::Code code, const std::string& text) {
+                if (code != EliteException::Code::SUCCESS) {
+                    promise->set_exception(makeError(code, text));
+                    return;
+                }
+                if (accepted && !accepted(text)) {
+                    promise->set_value(false);
+                    return;
+                }
+                auto wait_state = [=]() {
+                    session->waitState(monitor, reached, poll_cmd, poll_expected, deadline, token,
+                                       [promise](EliteException::Code code, bool ok) {
+                                           if (code != EliteException::Code::SUCCESS) {
+                                               promise->set_exception(makeError(code, "dashboard wait state"));
+                                           } else {
+                                               promise->set_value(ok);
+                                           }
+                                       });
+                };
+                if (delay.count() > 0) {
+                    session->after(delay, wait_state);
+                } else {
+                    wait_state();
+                }
+            });
+        return future;
+    }
+
+    /**
+     * @brief Send a command, then close the connection
+     *
+     */
+    std::future<void> commandThenClose(const std::string& cmd, const DashboardAsyncOptions& options) {
+        auto promise = std::make_shared<std::promise<void>>();
+        std::future<void> future = promise->get_future();
+        auto session = session_;
+        session->request(cmd, "", requestTimeout(options), options.cancel_token,
+                         [promise, session, cmd](EliteException::Code code, const std::string& text) {
+                             session->close(cmd.substr(0, cmd.size() - 1), nullptr);
+                             if (code != EliteException::Code::SUCCESS) {
+                                 promise->set_exception(makeError(code, text));
+                             } else {
+                                 promise->set_value();
+                             }
+                         });
+        return future;
+    }
+};
+
+DashboardClient::DashboardClient() {
+    impl_ = std::make_unique<Impl>();
+    impl_->io_context_.reset(new boost::asio::io_context());
+    // Keep the io_context from stopping when there is no pending operation.
+    impl_->work_guard_.reset(
+        new boost::asio::executor_work_guard<boost::asio::io_context::executor_type>(impl_->io_context_->get_executor()));
+    impl_->session_ = std::make_shared<DashboardSession>(*impl_->io_context_);
+}
+
+DashboardClient::DashboardClient(std::shared_ptr<DashboardExecutor> executor) {
+    if (!executor) {
+        throw EliteException(EliteException::Code::ILLEGAL_PARAM, "dashboard executor is null");
+    }
+    impl_ = std::make_unique<Impl>();
+    impl_->executor_ = executor;
+    impl_->session_ = std::make_shared<DashboardSession>(executor->impl_->io_context_);
+}
+
+DashboardClient::~DashboardClient() {}
+
+bool DashboardClient::connect(const std::string& ip, int port) {
+    std::future<bool> future = connectAsync(ip, port);
+    return impl_->wait(future);
+}
+
+void DashboardClient::disconnect() {
+    std::promise<void> promise;
+    std::future<void> future = promise.get_future();
+    impl_->session_->close("disconnected", [&promise]() { promise.set_value(); });
+    impl_->wait(future);
+}
+
+bool DashboardClient::brakeRelease() {
+    std::string response = sendAndRequest("brakeRelease\n", "Brake (Releasing.*|is released).*");
+    if (response.empty()) {
+        return false;
+    }
+    return waitForState([](RobotStateMonitor& m, int t) { return m.waitRobotMode({RobotMode::RUNNING}, t); }, "robotMode\n",
+                        "robotMode: RUNNING\r\n");
+}
+
+bool DashboardClient::closeSafetyDialog() {
+    std::string response = sendAndRequest("closeSafetyDialog\n", "closing .* dialog\r\n");
+    return !response.empty();
+}
+
+bool DashboardClient::echo() {
+    std::string response = sendAndRequest("echo\n", "Hello ELITE ROBOTS.\r\n");
+    return !response.empty();
+}
+
+std::string DashboardClient::help(const std::string& cmd) {
+    std::string send_string = "help " + cmd + '\n';
+    return sendAndRequest(send_string);
+}
+
+bool DashboardClient::log(const std::string& message) {
+    std::string response = sendAndRequest(logCommand(message), "Log has been added.\r\n");
+    return !response.empty();
+}
+
+bool DashboardClient::popup(const std::string& arg, const std::string& message) {
+    std::string response = sendAndRequest(popupCommand(arg, message), POPUP_EXPECTED);
+    return !response.empty();
+}
+
+void DashboardClient::quit() {
+    sendAndRequest("quit\n");
+    disconnect();
+}
+
+void DashboardClient::reboot() {
+    sendAndRequest("reboot\n");
+    disconnect();
+}
+
+std::string DashboardClient::robot() { return sendAndRequest("robot\n"); }
+
+bool DashboardClient::powerOn() {
+    std::string response = sendAndRequest("robotControl -on\n", "Powering on\r\n");
+    return waitForState(
+        [](RobotStateMonitor& m, int t) { return m.waitRobotMode({RobotMode::RUNNING, RobotMode::IDLE}, t); },
+        "robotMode\n", "robotMode: (RUNNING|IDLE)\r\n");
+}
+
+bool DashboardClient::powerOff() {
+    std::string response = sendAndRequest("robotControl -off\n", "Powering off\r\n");
+    // Beacuse of robot after power off need time to
+    // complete some operation (robot still return "POWER_OFF" by "robotMode" command), delay there
+    std::this_thread::sleep_for(500ms);
+    return waitForState([](RobotStateMonitor& m, int t) { return m.waitRobotMode({RobotMode::POWER_OFF}, t); },
+                        "robotMode\n", "robotMode: POWER_OFF\r\n");
+}
+
+void DashboardClient::shutdown() {
+    sendAndRequest("shutdown\n");
+    disconnect();
+}
+
+int DashboardClient::speedScaling() { return parseSpeedScaling(sendAndRequest("status\n", "Target Speed Fraction:.*")); }
+
+RobotMode DashboardClient::robotMode() { return parseRobotMode(sendAndRequest("robotMode\n", "robotMode:.*")); }
+
+SafetyMode DashboardClient::safetyMode() { return parseSafetyMode(sendAndRequest("safety -s\n", "Safety status:.*")); }
+
+bool DashboardClient::safetySystemRestart() {
+    sendAndRequest("safety -r\n", "Restarting safety board.*");
+    return waitForState([](RobotStateMonitor& m, int t) { return m.waitSafetyMode(SafetyMode::NORMAL, t); }, "safety -m\n",
+                        "Safety mode: NORMAL\r\n");
+}
+
+TaskStatus DashboardClient::runningStatus() { return parseRunningStatus(sendAndRequest("status\n", "RunningStatus:.*")); }
+
 bool DashboardClient::unlockProtectiveStop() {
     std::string response = sendAndRequest("unlockProtectiveStop\n", "Protective stop unlocking...\r\n");
     return !response.empty();
@@ -276,26 +1080,18 @@ bool DashboardClient::loadConfiguration(const std::string& path) {
 }
 
 std::string DashboardClient::configurationPath() {
-    std::string request = sendAndRequest("configuration\n", "configuration: Relative path:.*");
-    std::size_t pos = request.find("Relative path:");
-    return request.substr(pos + (sizeof("Relative path:") - 1));
+    return parseConfigurationPath(sendAndRequest("configuration\n", "configuration: Relative path:.*"));
 }
 
-bool DashboardClient::isConfigurationModify() {
-    std::string request = sendAndRequest("configuration -s\n");
-    if (request.find("not modified") != std::string::npos) {
-        return false;
-    } else {
-        return true;
-    }
-}
+bool DashboardClient::isConfigurationModify() { return parseConfigurationModify(sendAndRequest("configuration -s\n")); }
 
 bool DashboardClient::playProgram() {
     std::string request = sendAndRequest("play\n");
     if (request != "Starting task\r\n") {
         return false;
     }
-    return waitForReply("task -s\n", "Task is running\r\n");
+    return waitForState([](RobotStateMonitor& m, int t) { return m.waitTaskStatus(TaskStatus::PLAYING, t); }, "task -s\n",
+                        "Task is running\r\n");
 }
 
 bool DashboardClient::pauseProgram() {
@@ -303,7 +1099,8 @@ bool DashboardClient::pauseProgram() {
     if (request != "Pausing task\r\n") {
         return false;
     }
-    return waitForReply("task -s\n", "Task is paused\r\n");
+    return waitForState([](RobotStateMonitor& m, int t) { return m.waitTaskStatus(TaskStatus::PAUSED, t); }, "task -s\n",
+                        "Task is paused\r\n");
 }
 
 bool DashboardClient::setSpeedScaling(int scaling) {
@@ -317,20 +1114,11 @@ bool DashboardClient::stopProgram() {
     if (response != "Stopping task\r\n") {
         return false;
     }
-    return waitForReply("task -s\n", "Task is stopped\r\n");
+    return waitForState([](RobotStateMonitor& m, int t) { return m.waitTaskStatus(TaskStatus::STOPPED, t); }, "task -s\n",
+                        "Task is stopped\r\n");
 }
 
-std::string DashboardClient::getTaskPath() {
-    std::string request = sendAndRequest("task\n");
-    const char* kw = "Relative path:";
-    constexpr size_t kw_size = sizeof("Relative path:") - 1;
-    std::size_t pos = request.find(kw);
-    if (pos != std::string::npos) {
-        // Exclude prefixes and newline characters.
-        return request.substr(pos + kw_size, request.length() - kw_size - 2);
-    }
-    return request;
-}
+std::string DashboardClient::getTaskPath() { return parseTaskPath(sendAndRequest("task\n")); }
 
 bool DashboardClient::loadTask(const std::string& path) {
     std::string send_command = "task -p " + path + "\n";
@@ -338,97 +1126,314 @@ bool DashboardClient::loadTask(const std::string& path) {
     return waitForReply("task\n", "Relative path:" + path + "\r\n");
 }
 
-TaskStatus DashboardClient::getTaskStatus() {
-    std::string status_str = sendAndRequest("task -s\n", "Task is .*");
-    if (status_str.find("stopped") != std::string::npos) {
-        return TaskStatus::STOPPED;
-    } else if (status_str.find("paused") != std::string::npos) {
-        return TaskStatus::PAUSED;
-    } else if (status_str.find("running") != std::string::npos) {
-        return TaskStatus::PLAYING;
+TaskStatus DashboardClient::getTaskStatus() { return parseTaskStatus(sendAndRequest("task -s\n", "Task is .*")); }
+
+bool DashboardClient::taskIsRunning() { return parseTaskIsRunning(sendAndRequest("task -r\n", "Task is .*")); }
+
+bool DashboardClient::isTaskSaved() { return parseTaskSaved(sendAndRequest("task -ss\n", "Task is .*")); }
+
+std::string DashboardClient::sendAndReceive(const std::string& cmd) {
+    if (cmd.back() != '\n') {
+        return sendAndRequest(cmd + "\n");
     } else {
-        return TaskStatus::STOPPED;
+        return sendAndRequest(cmd);
     }
 }
 
-bool DashboardClient::taskIsRunning() {
-    std::string request = sendAndRequest("task -r\n", "Task is .*");
-    if (request.find("not running") != std::string::npos) {
-        return false;
-    } else if (request.find("is running") != std::string::npos) {
-        return true;
-    }
-    return false;
+std::future<std::string> DashboardClient::pipelineCommand(const std::string& cmd, ResponseCallback cb) {
+    auto promise = std::make_shared<std::promise<std::string>>();
+    std::future<std::string> future = promise->get_future();
+    impl_->session_->submit(cmd, std::chrono::milliseconds(DEFAULT_REQUEST_TIMEOUT_MS), nullptr,
+                            [promise, cb](EliteException::Code code, const std::string& text) {
+                                bool success = (code == EliteException::Code::SUCCESS);
+                                if (success) {
+                                    promise->set_value(text);
+                                } else {
+                                    promise->set_exception(Impl::makeError(code, text));
+                                }
+                                if (cb) {
+                                    cb(success, success ? text : std::string());
+                                }
+                            });
+    return future;
 }
 
-bool DashboardClient::isTaskSaved() {
-    std::string response = sendAndRequest("task -ss\n", "Task is .*");
-    if (response == "Task is saved") {
-        return true;
-    } else {
-        return false;
-    }
+bool DashboardClient::waitPipeline() {
+    std::promise<void> promise;
+    std::future<void> future = promise.get_future();
+    impl_->session_->drain([&promise]() { promise.set_value(); });
+    impl_->wait(future);
+    return impl_->session_->isConnected();
 }
 
-std::string DashboardClient::sendAndReceive(const std::string& cmd) {
-    if (cmd.back() != '\n') {
-        sendCommand(cmd + "\n");
-    } else {
-        sendCommand(cmd);
+std::vector<std::string> DashboardClient::sendAndReceivePipelined(const std::vector<std::string>& cmds) {
+    std::vector<std::future<std::string>> futures;
+    futures.reserve(cmds.size());
+    for (auto& cmd : cmds) {
+        futures.push_back(pipelineCommand(cmd));
+    }
+    waitPipeline();
+    std::vector<std::string> responses;
+    responses.reserve(futures.size());
+    for (auto& f : futures) {
+        responses.push_back(f.get());
     }
-    return asyncReadLine();
+    return responses;
 }
 
-std::string DashboardClient::asyncReadLine(unsigned timeout_ms) {
-    boost::system::error_code ec = boost::asio::error::would_block;
-    boost::asio::streambuf stream_buffer;
-    boost::asio::async_read_until(*impl_->socket_ptr_, stream_buffer, '\n',
-                                  [&](const boost::system::error_code& error, std::size_t nb) { ec = error; });
+void DashboardClient::setPipelineDepth(size_t depth) { impl_->session_->setPipelineDepth(depth); }
 
-    do {
-        impl_->io_context_.run_for(std::chrono::steady_clock::duration(std::chrono::milliseconds(timeout_ms)));
-        // TODO: When all tasks in the io_context are completed, the io_context enters a 'stopped' state.
-        // How can we prevent the io_context from entering the 'stopped' state without using the 'restart' method?
-        if (impl_->io_context_.stopped()) {
-            impl_->io_context_.restart();
-        }
-    } while (ec == boost::asio::error::would_block);
-    if (ec) {
-        throw EliteException(EliteException::Code::SOCKET_FAIL, ec.message());
+size_t DashboardClient::pipelineInFlight() {
+    // Let the pending operations of the calling thread take effect.
+    if (impl_->io_context_) {
+        impl_->io_context_->poll();
     }
-    std::string line(boost::asio::buffers_begin(stream_buffer.data()), boost::asio::buffers_end(stream_buffer.data()));
-    return line;
+    return impl_->session_->inFlight();
 }
 
-void DashboardClient::sendCommand(const std::string& cmd) {
-    boost::system::error_code ec;
-    impl_->socket_ptr_->send(boost::asio::buffer(cmd), 0, ec);
-    if (ec) {
-        throw EliteException(EliteException::Code::SOCKET_FAIL, ec.message());
+DashboardCancelToken DashboardClient::makeCancelToken() { return std::make_shared<std::atomic<bool>>(false); }
+
+void DashboardClient::cancel(const DashboardCancelToken& token) {
+    if (!token) {
+        return;
     }
+    *token = true;
+    impl_->session_->cancel(token);
+}
+
+void DashboardClient::cancelAll() { impl_->session_->cancel(nullptr); }
+
+std::future<bool> DashboardClient::connectAsync(const std::string& ip, int port, const DashboardAsyncOptions& options) {
+    auto promise = std::make_shared<std::promise<bool>>();
+    std::future<bool> future = promise->get_future();
+    impl_->session_->connect(ip, port, requestTimeout(options), options.cancel_token,
+                             [promise](EliteException::Code code, const std::string& text) {
+                                 if (code == EliteException::Code::SUCCESS) {
+                                     promise->set_value(true);
+                                 } else if (code == EliteException::Code::SOCKET_FAIL ||
+                                            code == EliteException::Code::TIMEOUT) {
+                                     promise->set_value(false);
+                                 } else {
+                                     // e.g. SOCKET_CONNECT_FAIL for a bad IP, which connect() throws.
+                                     promise->set_exception(Impl::makeError(code, text));
+                                 }
+                             });
+    return future;
+}
+
+std::future<bool> DashboardClient::brakeReleaseAsync(const DashboardAsyncOptions& options) {
+    return impl_->commandThenWait(
+        "brakeRelease\n", "Brake (Releasing.*|is released).*", nullptr,
+        [](RobotStateMonitor& m) { return m.getRobotMode() == RobotMode::RUNNING; }, "robotMode\n",
+        "robotMode: RUNNING\r\n", options);
+}
+
+std::future<bool> DashboardClient::closeSafetyDialogAsync(const DashboardAsyncOptions& options) {
+    return impl_->command<bool>("closeSafetyDialog\n", "closing .* dialog\r\n", options,
+                                [](const std::string& r) { return !r.empty(); });
+}
+
+std::future<bool> DashboardClient::echoAsync(const DashboardAsyncOptions& options) {
+    return impl_->command<bool>("echo\n", "Hello ELITE ROBOTS.\r\n", options,
+                                [](const std::string& r) { return !r.empty(); });
+}
+
+std::future<std::string> DashboardClient::helpAsync(const std::string& cmd, const DashboardAsyncOptions& options) {
+    return impl_->command<std::string>("help " + cmd + '\n', "", options, [](const std::string& r) { return r; });
+}
+
+std::future<bool> DashboardClient::logAsync(const std::string& message, const DashboardAsyncOptions& options) {
+    return impl_->command<bool>(logCommand(message), "Log has been added.\r\n", options,
+                                [](const std::string& r) { return !r.empty(); });
+}
+
+std::future<bool> DashboardClient::popupAsync(const std::string& arg, const std::string& message,
+                                              const DashboardAsyncOptions& options) {
+    return impl_->command<bool>(popupCommand(arg, message), POPUP_EXPECTED, options,
+                                [](const std::string& r) { return !r.empty(); });
+}
+
+std::future<void> DashboardClient::quitAsync(const DashboardAsyncOptions& options) {
+    return impl_->commandThenClose("quit\n", options);
+}
+
+std::future<void> DashboardClient::rebootAsync(const DashboardAsyncOptions& options) {
+    return impl_->commandThenClose("reboot\n", options);
+}
+
+std::future<std::string> DashboardClient::robotAsync(const DashboardAsyncOptions& options) {
+    return impl_->command<std::string>("robot\n", "", options, [](const std::string& r) { return r; });
+}
+
+std::future<bool> DashboardClient::powerOnAsync(const DashboardAsyncOptions& options) {
+    return impl_->commandThenWait(
+        "robotControl -on\n", "Powering on\r\n", nullptr,
+        [](RobotStateMonitor& m) {
+            return m.getRobotMode() == RobotMode::RUNNING || m.getRobotMode() == RobotMode::IDLE;
+        },
+        "robotMode\n", "robotMode: (RUNNING|IDLE)\r\n", options);
+}
+
+std::future<bool> DashboardClient::powerOffAsync(const DashboardAsyncOptions& options) {
+    // Same delay as powerOff()
+    return impl_->commandThenWait(
+        "robotControl -off\n", "Powering off\r\n", nullptr,
+        [](RobotStateMonitor& m) { return m.getRobotMode() == RobotMode::POWER_OFF; }, "robotMode\n",
+        "robotMode: POWER_OFF\r\n", options, 500ms);
+}
+
+std::future<void> DashboardClient::shutdownAsync(const DashboardAsyncOptions& options) {
+    return impl_->commandThenClose("shutdown\n", options);
+}
+
+std::future<int> DashboardClient::speedScalingAsync(const DashboardAsyncOptions& options) {
+    return impl_->command<int>("status\n", "Target Speed Fraction:.*", options, parseSpeedScaling);
+}
+
+std::future<RobotMode> DashboardClient::robotModeAsync(const DashboardAsyncOptions& options) {
+    return impl_->command<RobotMode>("robotMode\n", "robotMode:.*", options, parseRobotMode);
+}
+
+std::future<SafetyMode> DashboardClient::safetyModeAsync(const DashboardAsyncOptions& options) {
+    return impl_->command<SafetyMode>("safety -s\n", "Safety status:.*", options, parseSafetyMode);
+}
+
+std::future<bool> DashboardClient::safetySystemRestartAsync(const DashboardAsyncOptions& options) {
+    return impl_->commandThenWait(
+        "safety -r\n", "Restarting safety board.*", nullptr,
+        [](RobotStateMonitor& m) { return m.getSafetyMode() == SafetyMode::NORMAL; }, "safety -m\n",
+        "Safety mode: NORMAL\r\n", options);
+}
+
+std::future<TaskStatus> DashboardClient::runningStatusAsync(const DashboardAsyncOptions& options) {
+    return impl_->command<TaskStatus>("status\n", "RunningStatus:.*", options, parseRunningStatus);
+}
+
+std::future<bool> DashboardClient::unlockProtectiveStopAsync(const DashboardAsyncOptions& options) {
+    return impl_->command<bool>("unlockProtectiveStop\n", "Protective stop unlocking...\r\n", options,
+                                [](const std::string& r) { return !r.empty(); });
+}
+
+std::future<std::string> DashboardClient::usageAsync(const std::string& cmd, const DashboardAsyncOptions& options) {
+    return impl_->command<std::string>("usage " + cmd + "\n", "", options, [](const std::string& r) { return r; });
+}
+
+std::future<std::string> DashboardClient::versionAsync(const DashboardAsyncOptions& options) {
+    return impl_->command<std::string>("version\n", "", options, [](const std::string& r) { return r; });
+}
+
+std::future<bool> DashboardClient::loadConfigurationAsync(const std::string& path, const DashboardAsyncOptions& options) {
+    return impl_->commandThenWait("configuration -p " + path + "\n", "Loading Configuration :.*", nullptr, nullptr,
+                                  "configuration\n", "configuration: Relative path:" + path + "\r\n", options);
+}
+
+std::future<std::string> DashboardClient::configurationPathAsync(const DashboardAsyncOptions& options) {
+    return impl_->command<std::string>("configuration\n", "configuration: Relative path:.*", options,
+                                       parseConfigurationPath);
+}
+
+std::future<bool> DashboardClient::isConfigurationModifyAsync(const DashboardAsyncOptions& options) {
+    return impl_->command<bool>("configuration -s\n", "", options, parseConfigurationModify);
+}
+
+std::future<bool> DashboardClient::playProgramAsync(const DashboardAsyncOptions& options) {
+    return impl_->commandThenWait(
+        "play\n", "", [](const std::string& r) { return r == "Starting task\r\n"; },
+        [](RobotStateMonitor& m) { return m.getTaskStatus() == TaskStatus::PLAYING; }, "task -s\n",
+        "Task is running\r\n", options);
+}
+
+std::future<bool> DashboardClient::pauseProgramAsync(const DashboardAsyncOptions& options) {
+    return impl_->commandThenWait(
+        "pause\n", "", [](const std::string& r) { return r == "Pausing task\r\n"; },
+        [](RobotStateMonitor& m) { return m.getTaskStatus() == TaskStatus::PAUSED; }, "task -s\n",
+        "Task is paused\r\n", options);
+}
+
+std::future<bool> DashboardClient::stopProgramAsync(const DashboardAsyncOptions& options) {
+    return impl_->commandThenWait(
+        "stop\n", "", [](const std::string& r) { return r == "Stopping task\r\n"; },
+        [](RobotStateMonitor& m) { return m.getTaskStatus() == TaskStatus::STOPPED; }, "task -s\n",
+        "Task is stopped\r\n", options);
+}
+
+std::future<bool> DashboardClient::setSpeedScalingAsync(int scaling, const DashboardAsyncOptions& options) {
+    auto promise = std::make_shared<std::promise<bool>>();
+    std::future<bool> future = promise->get_future();
+    auto deadline = std::chrono::steady_clock::now() + requestTimeout(options);
+    auto session = impl_->session_;
+    auto token = options.cancel_token;
+    std::string send_command = "speed -v " + std::to_string(scaling) + "\n";
+    session->request(send_command, "", remaining(deadline), token,
+                     [=](EliteException::Code code, const std::string& text) {
+                         if (code != EliteException::Code::SUCCESS) {
+                             promise->set_exception(Impl::makeError(code, text));
+                             return;
+                         }
+                         // Read back the speed scaling
+                         session->request("status\n", "Target Speed Fraction:.*", remaining(deadline), token,
+                                          [=](EliteException::Code code, const std::string& text) {
+                                              if (code != EliteException::Code::SUCCESS) {
+                                                  promise->set_exception(Impl::makeError(code, text));
+                                                  return;
+                                              }
+                                              auto parse = [scaling](const std::string& r) {
+                                                  return parseSpeedScaling(r) == scaling;
+                                              };
+                                              fulfil(*promise, parse, text);
+                                          });
+                     });
+    return future;
+}
+
+std::future<std::string> DashboardClient::getTaskPathAsync(const DashboardAsyncOptions& options) {
+    return impl_->command<std::string>("task\n", "", options, parseTaskPath);
+}
+
+std::future<bool> DashboardClient::loadTaskAsync(const std::string& path, const DashboardAsyncOptions& options) {
+    return impl_->commandThenWait("task -p " + path + "\n", "Loaded task: .*", nullptr, nullptr, "task\n",
+                                  "Relative path:" + path + "\r\n", options);
+}
+
+std::future<TaskStatus> DashboardClient::getTaskStatusAsync(const DashboardAsyncOptions& options) {
+    return impl_->command<TaskStatus>("task -s\n", "Task is .*", options, parseTaskStatus);
+}
+
+std::future<bool> DashboardClient::taskIsRunningAsync(const DashboardAsyncOptions& options) {
+    return impl_->command<bool>("task -r\n", "Task is .*", options, parseTaskIsRunning);
+}
+
+std::future<bool> DashboardClient::isTaskSavedAsync(const DashboardAsyncOptions& options) {
+    return impl_->command<bool>("task -ss\n", "Task is .*", options, parseTaskSaved);
+}
+
+std::future<std::string> DashboardClient::sendAndReceiveAsync(const std::string& cmd, ResponseCallback cb,
+                                                              const DashboardAsyncOptions& options) {
+    auto promise = std::make_shared<std::promise<std::string>>();
+    std::future<std::string> future = promise->get_future();
+    impl_->session_->submit(cmd, requestTimeout(options), options.cancel_token,
+                            [promise, cb](EliteException::Code code, const std::string& text) {
+                                bool success = (code == EliteException::Code::SUCCESS);
+                                if (success) {
+                                    promise->set_value(text);
+                                } else {
+                                    promise->set_exception(Impl::makeError(code, text));
+                                }
+                                if (cb) {
+                                    cb(success, success ? text : std::string());
+                                }
+                            });
+    return future;
 }
 
 std::string DashboardClient::sendAndRequest(const std::string& cmd, const std::string& expected) {
-    std::lock_guard<std::mutex> lock(impl_->socket_mutex_);
-    if (!impl_->socket_ptr_) {
+    if (!impl_->session_->isConnected()) {
         ELITE_LOG_ERROR("Dashboard not connect to robot");
         return "";
     }
-    sendCommand(cmd);
-    std::string response = asyncReadLine();
-    if (!expected.empty()) {
-        std::smatch match;
-        bool ret = std::regex_search(response, match, std::regex(expected));
-        if (!ret) {
-            throw EliteException(
-                EliteException::Code::DASHBOARD_NOT_EXPECT_RECIVE,
-                "Dashboard command \"" + cmd + "\" response expected: " + expected + ". But received: " + response);
-            return std::string();
-        }
-        return match[0];
-    } else {
-        return response;
-    }
+    std::future<std::string> future = pipelineCommand(cmd);
+    std::string response = impl_->wait(future);
+    return expectResponse(cmd, expected, response);
 }
 
 bool DashboardClient::waitForReply(const std::string& cmd, const std::string& expected,
@@ -436,9 +1441,10 @@ bool DashboardClient::waitForReply(const std::string& cmd, const std::string& ex
     const std::chrono::duration<double> wait_period = 100ms;
     std::chrono::duration<double> time_done(0);
     std::string response;
+    auto matcher = DashboardResponseMatcher::get(expected);
     while (time_done < timeout) {
         response = sendAndRequest(cmd);
-        if (std::regex_match(response, std::regex(expected))) {
+        if (matcher->match(response)) {
             return true;
         }
         // wait 100ms before trying again
@@ -446,4 +1452,26 @@ bool DashboardClient::waitForReply(const std::string& cmd, const std::string& ex
         time_done += wait_period;
     }
     return false;
-}
\ No newline at end of file
+}
+
+bool DashboardClient::waitForState(const std::function<bool(RobotStateMonitor&, int)>& event_wait, const std::string& cmd,
+                                   const std::string& expected, const std::chrono::milliseconds timeout) {
+    auto monitor = std::atomic_load(&impl_->state_monitor_);
+    auto start = std::chrono::steady_clock::now();
+    if (monitor && monitor->isUpdating()) {
+        if (event_wait(*monitor, (int)timeout.count())) {
+            return true;
+        }
+        // The data stream is alive, so the state was not reached in time.
+        if (monitor->isUpdating()) {
+            return false;
+        }
+        ELITE_LOG_WARN("State monitor stopped updating, polling dashboard command \"%s\"", cmd.c_str());
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    return waitForReply(cmd, expected, timeout - elapsed);
+}
+
+void DashboardClient::setStateMonitor(std::shared_ptr<RobotStateMonitor> monitor) {
+    std::atomic_store(&impl_->state_monitor_, monitor);
+}
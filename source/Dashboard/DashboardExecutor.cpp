@@ -0,0 +1,36 @@
+#include "DashboardExecutor.hpp"
+#include "DashboardExecutorImpl.hpp"
+#include "Log.hpp"
+
+#include <algorithm>
+
+using namespace ELITE;
+
+DashboardExecutor::DashboardExecutor(int thread_count) {
+    impl_ = std::make_unique<Impl>();
+    thread_count = std::max(thread_count, 1);
+    for (int i = 0; i < thread_count; i++) {
+        impl_->threads_.emplace_back([this]() {
+            try {
+                impl_->io_context_.run();
+            } catch (const std::exception& e) {
+                ELITE_LOG_ERROR("Dashboard executor thread exit: %s", e.what());
+            }
+        });
+    }
+}
+
+DashboardExecutor::~DashboardExecutor() {
+    impl_->work_guard_.reset();
+    impl_->io_context_.stop();
+    for (auto& t : impl_->threads_) {
+        if (t.joinable()) {
+            t.join();
+        }
+    }
+}
+
+bool DashboardExecutor::runningInThisThread() {
+    auto id = std::this_thread::get_id();
+    return std::any_of(impl_->threads_.begin(), impl_->threads_.end(), [id](const std::thread& t) { return t.get_id() == id; });
+}
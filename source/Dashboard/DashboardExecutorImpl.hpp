@@ -0,0 +1,27 @@
+#ifndef __DASHBOARD_EXECUTOR_IMPL_HPP__
+#define __DASHBOARD_EXECUTOR_IMPL_HPP__
+
+#include "DashboardExecutor.hpp"
+
+#include <boost/asio.hpp>
+#include <thread>
+#include <vector>
+
+namespace ELITE {
+
+/**
+ * @brief The io_context and threads of DashboardExecutor, used internally.
+ *
+ */
+class DashboardExecutor::Impl {
+   public:
+    boost::asio::io_context io_context_;
+    boost::asio::executor_work_guard<boost::asio::io_context::executor_type> work_guard_;
+    std::vector<std::thread> threads_;
+
+    Impl() : work_guard_(boost::asio::make_work_guard(io_context_)) {}
+};
+
+}  // namespace ELITE
+
+#endif
@@ -0,0 +1,116 @@
+#include "DashboardResponseMatcher.hpp"
+
+#include <mutex>
+#include <unordered_map>
+
+using namespace ELITE;
+
+static bool isLineTerminator(char c) { return c == '\r' || c == '\n'; }
+
+DashboardResponseMatcher::DashboardResponseMatcher(const std::string& pattern) : kind_(Kind::LITERAL), has_wildcard_(false) {
+    std::string body = pattern;
+    if (body.size() >= 2 && body.compare(body.size() - 2, 2, ".*") == 0) {
+        body.resize(body.size() - 2);
+        kind_ = Kind::PREFIX;
+    }
+    // '.' is the only special character allowed in the fast path.
+    if (body.find_first_of("^$\\*+?()[]{}|") != std::string::npos) {
+        kind_ = Kind::REGEX;
+        regex_ = std::regex(pattern);
+        return;
+    }
+    literal_ = body;
+    has_wildcard_ = literal_.find('.') != std::string::npos;
+}
+
+bool DashboardResponseMatcher::literalAt(const std::string& text, size_t pos) const {
+    if (pos + literal_.size() > text.size()) {
+        return false;
+    }
+    if (!has_wildcard_) {
+        return text.compare(pos, literal_.size(), literal_) == 0;
+    }
+    for (size_t i = 0; i < literal_.size(); i++) {
+        char c = text[pos + i];
+        if (literal_[i] == '.') {
+            if (isLineTerminator(c)) {
+                return false;
+            }
+        } else if (literal_[i] != c) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t DashboardResponseMatcher::findLiteral(const std::string& text) const {
+    if (!has_wildcard_) {
+        return text.find(literal_);
+    }
+    if (literal_.size() > text.size()) {
+        return std::string::npos;
+    }
+    for (size_t pos = 0; pos + literal_.size() <= text.size(); pos++) {
+        if (literalAt(text, pos)) {
+            return pos;
+        }
+    }
+    return std::string::npos;
+}
+
+size_t DashboardResponseMatcher::anyLength(const std::string& text, size_t pos) {
+    size_t end = pos;
+    while (end < text.size() && !isLineTerminator(text[end])) {
+        end++;
+    }
+    return end - pos;
+}
+
+bool DashboardResponseMatcher::search(const std::string& text, std::string& matched) const {
+    if (kind_ == Kind::REGEX) {
+        std::smatch match;
+        if (!std::regex_search(text, match, regex_)) {
+            return false;
+        }
+        matched = match[0];
+        return true;
+    }
+    size_t pos = findLiteral(text);
+    if (pos == std::string::npos) {
+        return false;
+    }
+    size_t len = literal_.size();
+    if (kind_ == Kind::PREFIX) {
+        len += anyLength(text, pos + len);
+    }
+    matched = text.substr(pos, len);
+    return true;
+}
+
+bool DashboardResponseMatcher::match(const std::string& text) const {
+    switch (kind_) {
+        case Kind::LITERAL:
+            return text.size() == literal_.size() && literalAt(text, 0);
+        case Kind::PREFIX:
+            return literalAt(text, 0) && anyLength(text, literal_.size()) == text.size() - literal_.size();
+        default:
+            return std::regex_match(text, regex_);
+    }
+}
+
+std::shared_ptr<const DashboardResponseMatcher> DashboardResponseMatcher::get(const std::string& pattern) {
+    static std::mutex s_cache_mutex;
+    static std::unordered_map<std::string, std::shared_ptr<const DashboardResponseMatcher>> s_cache;
+
+    std::lock_guard<std::mutex> lock(s_cache_mutex);
+    auto iter = s_cache.find(pattern);
+    if (iter != s_cache.end()) {
+        return iter->second;
+    }
+    if (s_cache.size() >= CACHE_MAX_SIZE) {
+        s_cache.clear();
+    }
+    auto matcher = std::make_shared<const DashboardResponseMatcher>(pattern);
+    s_cache.insert({pattern, matcher});
+    return matcher;
+}
@@ -0,0 +1,91 @@
+#ifndef __DASHBOARD_RESPONSE_MATCHER_HPP__
+#define __DASHBOARD_RESPONSE_MATCHER_HPP__
+
+#include <memory>
+#include <regex>
+#include <string>
+
+namespace ELITE {
+
+/**
+ * @brief
+ *      Precompiled matcher of dashboard expected responses, used internal.
+ *      Most of the expected responses are literal strings or literal prefixes followed by ".*".
+ *      These patterns are matched without std::regex, the others fall back to a precompiled std::regex.
+ *      Both paths keep the ECMAScript semantics, '.' matches any character except '\r' and '\n'.
+ */
+class DashboardResponseMatcher {
+   public:
+    DashboardResponseMatcher() = delete;
+
+    /**
+     * @brief Compile the pattern
+     *
+     * @param pattern ECMAScript regular expression
+     */
+    explicit DashboardResponseMatcher(const std::string& pattern);
+    ~DashboardResponseMatcher() = default;
+
+    /**
+     * @brief Same as std::regex_search()
+     *
+     * @param text The response
+     * @param matched The matched part of response (match[0])
+     * @return true matched
+     * @return false not matched
+     */
+    bool search(const std::string& text, std::string& matched) const;
+
+    /**
+     * @brief Same as std::regex_match(), the whole response must match the pattern.
+     *
+     * @param text The response
+     * @return true matched
+     * @return false not matched
+     */
+    bool match(const std::string& text) const;
+
+    /**
+     * @brief Get the compiled matcher of pattern from the cache. If not exist, compile and cache it.
+     *
+     * @param pattern ECMAScript regular expression
+     * @return std::shared_ptr<const DashboardResponseMatcher> The matcher
+     */
+    static std::shared_ptr<const DashboardResponseMatcher> get(const std::string& pattern);
+
+   private:
+    enum class Kind {
+        // Literal characters, '.' is a wildcard.
+        LITERAL,
+        // LITERAL followed by ".*"
+        PREFIX,
+        // Anything else
+        REGEX
+    };
+    // Limit the cache size, some patterns are built from user input (task or configuration path).
+    static constexpr size_t CACHE_MAX_SIZE = 128;
+
+    Kind kind_;
+    std::string literal_;
+    bool has_wildcard_;
+    std::regex regex_;
+
+    /**
+     * @brief Is the literal part matched at the position of text
+     */
+    bool literalAt(const std::string& text, size_t pos) const;
+
+    /**
+     * @brief Find the first position that the literal part matched
+     */
+    size_t findLiteral(const std::string& text) const;
+
+    /**
+     * @brief The length of ".*" matched from the position of text
+     */
+    static size_t anyLength(const std::string& text, size_t pos);
+};
+
+}  // namespace ELITE
+
+#endif
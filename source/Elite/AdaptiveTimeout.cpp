@@ -0,0 +1,109 @@
+#include "AdaptiveTimeout.hpp"
+#include "EliteException.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace ELITE;
+using namespace std::chrono;
+
+namespace {
+
+// Histogram bin width (us)
+constexpr int BIN_US = 100;
+// Sends between two percentile computations
+constexpr int REFRESH_PERIOD = 32;
+
+}  // namespace
+
+AdaptiveTimeout::AdaptiveTimeout(const AdaptiveTimeoutOptions& options) : options_(options) {
+    if (!(options.percentile > 0 && options.percentile <= 1) || !(options.scale > 0) || options.margin_ms < 0 ||
+        options.min_timeout_ms <= 0 || options.max_timeout_ms < options.min_timeout_ms || options.window == 0) {
+        throw EliteException(EliteException::Code::ILLEGAL_PARAM, "Invalid adaptive timeout options");
+    }
+    reset();
+}
+
+void AdaptiveTimeout::reset() {
+    histogram_.assign((size_t)options_.max_timeout_ms * 1000 / BIN_US + 1, 0);
+    ring_.clear();
+    ring_.reserve(options_.window);
+    ring_next_ = 0;
+    window_sum_us_ = 0;
+    until_refresh_ = 0;
+    has_previous_ = false;
+    previous_timeout_ms_ = 0;
+    adapted_timeout_ms_ = 0;
+    statistics_ = AdaptiveTimeoutStatistics();
+}
+
+void AdaptiveTimeout::restart() { has_previous_ = false; }
+
+int AdaptiveTimeout::update(steady_clock::time_point now, int requested_ms) {
+    if (requested_ms <= 0) {
+        // The script blocks until the next frame, nothing is streamed so there is no interval to measure
+        restart();
+        statistics_.timeout_ms = requested_ms;
+        return requested_ms;
+    }
+    if (has_previous_) {
+        int64_t interval_us = std::max<int64_t>(duration_cast<microseconds>(now - previous_).count(), 0);
+        uint32_t interval = (uint32_t)std::min<int64_t>(interval_us, UINT32_MAX);
+        if (ring_.size() < options_.window) {
+            ring_.push_back(interval);
+        } else {
+            uint32_t oldest = ring_[ring_next_];
+            histogram_[std::min<size_t>(oldest / BIN_US, histogram_.size() - 1)]--;
+            window_sum_us_ -= oldest;
+            ring_[ring_next_] = interval;
+            ring_next_ = (ring_next_ + 1) % options_.window;
+        }
+        histogram_[std::min<size_t>(interval / BIN_US, histogram_.size() - 1)]++;
+        window_sum_us_ += interval;
+        statistics_.intervals++;
+        statistics_.last_interval = microseconds(interval);
+        if (previous_timeout_ms_ > 0 && interval_us > (int64_t)previous_timeout_ms_ * 1000) {
+            statistics_.late++;
+        }
+        if (--until_refresh_ <= 0 || (!statistics_.adapted && ring_.size() >= options_.min_samples)) {
+            refresh();
+        }
+    }
+    has_previous_ = true;
+    previous_ = now;
+    previous_timeout_ms_ = statistics_.adapted ? adapted_timeout_ms_ : requested_ms;
+    statistics_.timeout_ms = previous_timeout_ms_;
+    return previous_timeout_ms_;
+}
+
+void AdaptiveTimeout::refresh() {
+    until_refresh_ = REFRESH_PERIOD;
+    if (ring_.size() < options_.min_samples || ring_.empty()) {
+        return;
+    }
+    // The smallest bin with the wanted fraction of the intervals at or below it
+    uint64_t wanted = (uint64_t)std::ceil(options_.percentile * ring_.size());
+    uint64_t count = 0;
+    size_t bin = 0;
+    for (; bin + 1 < histogram_.size(); bin++) {
+        count += histogram_[bin];
+        if (count >= wanted) {
+            break;
+        }
+    }
+    int64_t percentile_us = (int64_t)(bin + 1) * BIN_US;
+    statistics_.percentile_interval = microseconds(percentile_us);
+    double timeout = percentile_us / 1000.0 * options_.scale + options_.margin_ms;
+    adapted_timeout_ms_ =
+        std::min(std::max((int)std::ceil(timeout), options_.min_timeout_ms), options_.max_timeout_ms);
+    statistics_.adapted = true;
+}
+
+AdaptiveTimeoutStatistics AdaptiveTimeout::getStatistics() const {
+    AdaptiveTimeoutStatistics statistics = statistics_;
+    if (!ring_.empty()) {
+        statistics.mean_interval = microseconds(window_sum_us_ / ring_.size());
+        statistics.max_interval = microseconds(*std::max_element(ring_.begin(), ring_.end()));
+    }
+    return statistics;
+}
@@ -0,0 +1,140 @@
+#include "CartesianSpeedConverter.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace ELITE;
+
+namespace {
+
+// |det m|, by Gaussian elimination with partial pivoting
+double absDeterminant(Matrix6d m) {
+    double det = 1;
+    for (int col = 0; col < 6; col++) {
+        int pivot = col;
+        for (int row = col + 1; row < 6; row++) {
+            if (std::fabs(m[row * 6 + col]) > std::fabs(m[pivot * 6 + col])) {
+                pivot = row;
+            }
+        }
+        if (m[pivot * 6 + col] == 0) {
+            return 0;
+        }
+        if (pivot != col) {
+            std::swap_ranges(&m[pivot * 6], &m[pivot * 6] + 6, &m[col * 6]);
+        }
+        det *= m[col * 6 + col];
+        for (int row = col + 1; row < 6; row++) {
+            double f = m[row * 6 + col] / m[col * 6 + col];
+            for (int k = col; k < 6; k++) {
+                m[row * 6 + k] -= f * m[col * 6 + k];
+            }
+        }
+    }
+    return std::fabs(det);
+}
+
+}  // namespace
+
+CartesianSpeedConverter::CartesianSpeedConverter(const Kinematics& kinematics, const CartesianSpeedOptions& options)
+    : kinematics_(kinematics), options_(options) {}
+
+SingularityMetrics CartesianSpeedConverter::singularity(const vector6d_t& joints) const {
+    return singularity(joints, kinematics_.jacobian(joints));
+}
+
+SingularityMetrics CartesianSpeedConverter::singularity(const vector6d_t& joints, const Matrix6d& jacobian) const {
+    const vector6d_t& a = kinematics_.getDhA();
+    const vector6d_t& d = kinematics_.getDhD();
+    SingularityMetrics metrics;
+    metrics.manipulability = absDeterminant(jacobian);
+    metrics.wrist = std::fabs(std::sin(joints[4]));
+    metrics.elbow = std::fabs(std::sin(joints[2]));
+    // Reach of the wrist in the arm plane, measured from the axis of joint 1
+    metrics.shoulder = std::fabs(a[1] * std::cos(joints[1]) + a[2] * std::cos(joints[1] + joints[2]) +
+                                 d[4] * std::sin(joints[1] + joints[2] + joints[3]));
+    return metrics;
+}
+
+vector6d_t CartesianSpeedConverter::toJointSpeed(const vector6d_t& joints, const vector6d_t& tcp_speed,
+                                                 SingularityMetrics* metrics) const {
+    Matrix6d j = kinematics_.jacobian(joints);
+    SingularityMetrics m = singularity(joints, j);
+    if (m.manipulability < options_.manipulability_threshold) {
+        double r = 1 - m.manipulability / options_.manipulability_threshold;
+        m.damping = options_.max_damping * r * r;
+    }
+
+    // A = J J^T + l^2 I, symmetric positive definite unless undamped at a singularity
+    double a[6][6];
+    for (int row = 0; row < 6; row++) {
+        for (int col = 0; col <= row; col++) {
+            double sum = 0;
+            for (int k = 0; k < 6; k++) {
+                sum += j[row * 6 + k] * j[col * 6 + k];
+            }
+            a[row][col] = sum;
+        }
+        a[row][row] += m.damping * m.damping;
+    }
+    // Cholesky A = L L^T in place, then y = A^-1 v
+    double y[6];
+    for (int col = 0; col < 6; col++) {
+        double diag = a[col][col];
+        for (int k = 0; k < col; k++) {
+            diag -= a[col][k] * a[col][k];
+        }
+        if (diag <= 0) {
+            // Singular and no damping: no joint motion produces the velocity
+            if (metrics) {
+                *metrics = m;
+            }
+            return {0, 0, 0, 0, 0, 0};
+        }
+        a[col][col] = std::sqrt(diag);
+        for (int row = col + 1; row < 6; row++) {
+            double sum = a[row][col];
+            for (int k = 0; k < col; k++) {
+                sum -= a[row][k] * a[col][k];
+            }
+            a[row][col] = sum / a[col][col];
+        }
+    }
+    for (int row = 0; row < 6; row++) {
+        double sum = tcp_speed[row];
+        for (int k = 0; k < row; k++) {
+            sum -= a[row][k] * y[k];
+        }
+        y[row] = sum / a[row][row];
+    }
+    for (int row = 5; row >= 0; row--) {
+        double sum = y[row];
+        for (int k = row + 1; k < 6; k++) {
+            sum -= a[k][row] * y[k];
+        }
+        y[row] = sum / a[row][row];
+    }
+
+    // q' = J^T y
+    vector6d_t speed;
+    for (int i = 0; i < 6; i++) {
+        double sum = 0;
+        for (int k = 0; k < 6; k++) {
+            sum += j[k * 6 + i] * y[k];
+        }
+        speed[i] = sum;
+    }
+    for (int i = 0; i < 6; i++) {
+        double limit = options_.max_joint_speed[i];
+        if (limit > 0 && std::fabs(speed[i]) * m.speed_scale > limit) {
+            m.speed_scale = limit / std::fabs(speed[i]);
+        }
+    }
+    for (auto& v : speed) {
+        v *= m.speed_scale;
+    }
+    if (metrics) {
+        *metrics = m;
+    }
+    return speed;
+}
@@ -0,0 +1,181 @@
+#include "ControlLoopRunner.hpp"
+#include "EliteDriver.hpp"
+#include "LatencyBuckets.hpp"
+#include "Log.hpp"
+
+#include <algorithm>
+#include <mutex>
+
+using namespace ELITE;
+using namespace std::chrono;
+
+constexpr std::array<int, 9> ControlLoopStatistics::LATENCY_BUCKETS_US;
+
+microseconds ControlLoopStatistics::percentile(double fraction) const {
+    return latencyPercentile(LATENCY_BUCKETS_US, latency_histogram, cycles, fraction, max_latency);
+}
+
+namespace {
+
+// Runs the control callback for every sample, in the receive thread of the hub
+class LoopSubscription : public RtsiSubscription {
+   public:
+    LoopSubscription(const std::vector<std::string>& fields, std::function<void(const RtsiSamplePtr&)> cycle)
+        : RtsiSubscription(fields), cycle_(std::move(cycle)) {}
+
+   protected:
+    void onSample(const RtsiSamplePtr& sample) override { cycle_(sample); }
+
+   private:
+    std::function<void(const RtsiSamplePtr&)> cycle_;
+};
+
+}  // namespace
+
+class ControlLoopRunner::Impl {
+   public:
+    Impl(RtsiHub& hub, Sender sender) : hub_(hub), sender_(std::move(sender)) {}
+
+    RtsiHub& hub_;
+    Sender sender_;
+    Callback cb_;
+    ControlLoopOptions options_;
+    std::shared_ptr<RtsiSubscription> subscription_;
+    std::atomic<bool> running_{false};
+    int consecutive_overruns_ = 0;
+    LogThrottle overrun_log_throttle_;
+
+    // Shared with the subscription, which the hub may still hold after the runner is destroyed.
+    // The mutex is held while a cycle runs, so stop() returns after it. Recursive for stop() called by the callback.
+    struct Gate {
+        std::recursive_mutex mutex;
+        Impl* impl = nullptr;
+    };
+    std::shared_ptr<Gate> gate_;
+
+    std::mutex stats_mutex_;
+    ControlLoopStatistics stats_;
+    microseconds latency_sum_{0};
+
+    void record(microseconds latency, bool overrun, bool send_ok) {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.cycles++;
+        stats_.last_latency = latency;
+        stats_.max_latency = std::max(stats_.max_latency, latency);
+        latency_sum_ += latency;
+        stats_.mean_latency = latency_sum_ / stats_.cycles;
+        stats_.latency_histogram[latencyBucket(ControlLoopStatistics::LATENCY_BUCKETS_US, latency.count())]++;
+        if (overrun) {
+            stats_.overruns++;
+        }
+        if (!send_ok) {
+            stats_.send_failures++;
+        }
+    }
+
+    void halt() {
+        running_ = false;
+        ControlLoopCommand idle;
+        idle.action = ControlLoopAction::STOP;
+        sender_(idle, options_.command_timeout_ms);
+        hub_.unsubscribe(subscription_);
+    }
+
+    void cycle(const RtsiSamplePtr& sample) {
+        if (!running_) {
+            return;
+        }
+        ControlLoopCommand command = cb_(*sample);
+        if (command.action == ControlLoopAction::STOP) {
+            ELITE_LOG_INFO("Control loop stopped by the callback");
+            halt();
+            return;
+        }
+        bool send_ok = true;
+        if (command.action != ControlLoopAction::NONE) {
+            send_ok = sender_(command, options_.command_timeout_ms);
+        }
+        auto latency = duration_cast<microseconds>(steady_clock::now() - sample->getReceiveTime());
+        bool overrun = latency.count() > options_.deadline_us;
+        record(latency, overrun, send_ok);
+        if (!overrun) {
+            consecutive_overruns_ = 0;
+            return;
+        }
+        consecutive_overruns_++;
+        ELITE_LOG_WARN_THROTTLE(overrun_log_throttle_, 1000, "Control loop overrun: %lldus, deadline %dus",
+                                (long long)latency.count(), options_.deadline_us);
+        if (options_.max_consecutive_overruns > 0 && consecutive_overruns_ >= options_.max_consecutive_overruns) {
+            ELITE_LOG_ERROR("Control loop stopped after %d consecutive overruns", consecutive_overruns_);
+            halt();
+        }
+    }
+};
+
+ControlLoopRunner::ControlLoopRunner(RtsiHub& hub, EliteDriver& driver)
+    : ControlLoopRunner(hub, [&driver](const ControlLoopCommand& command, int timeout_ms) {
+          switch (command.action) {
+              case ControlLoopAction::SERVOJ:
+                  return driver.writeServoj(command.target, timeout_ms);
+              case ControlLoopAction::SPEEDJ:
+                  return driver.writeSpeedj(command.target, timeout_ms);
+              case ControlLoopAction::SPEEDL:
+                  return driver.writeSpeedl(command.target, timeout_ms);
+              case ControlLoopAction::POSE:
+                  return driver.writePose(command.target, timeout_ms);
+              case ControlLoopAction::STOP:
+                  return driver.writeIdle(timeout_ms);
+              default:
+                  return true;
+          }
+      }) {}
+
+ControlLoopRunner::ControlLoopRunner(RtsiHub& hub, Sender sender) : impl_(new Impl(hub, std::move(sender))) {}
+
+ControlLoopRunner::~ControlLoopRunner() { stop(); }
+
+bool ControlLoopRunner::start(const std::vector<std::string>& fields, Callback cb, const ControlLoopOptions& options) {
+    if (impl_->running_) {
+        return false;
+    }
+    impl_->cb_ = std::move(cb);
+    impl_->options_ = options;
+    impl_->consecutive_overruns_ = 0;
+    auto gate = std::make_shared<Impl::Gate>();
+    gate->impl = impl_.get();
+    impl_->gate_ = gate;
+    impl_->subscription_ = std::make_shared<LoopSubscription>(fields, [gate](const RtsiSamplePtr& sample) {
+        std::lock_guard<std::recursive_mutex> lock(gate->mutex);
+        if (gate->impl) {
+            gate->impl->cycle(sample);
+        }
+    });
+    impl_->running_ = true;
+    impl_->hub_.subscribe(impl_->subscription_);
+    return true;
+}
+
+void ControlLoopRunner::stop() {
+    impl_->running_ = false;
+    if (impl_->subscription_) {
+        impl_->hub_.unsubscribe(impl_->subscription_);
+    }
+    if (impl_->gate_) {
+        std::lock_guard<std::recursive_mutex> lock(impl_->gate_->mutex);
+        impl_->gate_->impl = nullptr;
+        impl_->gate_.reset();
+    }
+}
+
+bool ControlLoopRunner::isRunning() { return impl_->running_; }
+
+ControlLoopStatistics ControlLoopRunner::getStatistics() {
+    std::lock_guard<std::mutex> lock(impl_->stats_mutex_);
+    return impl_->stats_;
+}
+
+void ControlLoopRunner::resetStatistics() {
+    std::lock_guard<std::mutex> lock(impl_->stats_mutex_);
+    impl_->stats_ = ControlLoopStatistics();
+    impl_->latency_sum_ = microseconds(0);
+}
@@ -4,29 +4,34 @@
 #include "TrajectoryInterface.hpp"
 #include "ScriptSender.hpp"
 #include "ScriptCommandInterface.hpp"
+#include "ScriptTemplate.hpp"
 #include "ControlCommon.hpp"
 #include "ControlMode.hpp"
 #include "PrimaryPortInterface.hpp"
 #include "Log.hpp"
 #include <boost/asio.hpp>
+#include <chrono>
 #include <fstream>
+#include <future>
 #include <sstream>
 #include <iostream>
 
 using namespace ELITE;
 
-static const std::string SERVER_IP_REPLACE = "{{SERVER_IP_REPLACE}}";
-static const std::string REVERSE_PORT_REPLACE = "{{REVERSE_PORT_REPLACE}}";
-static const std::string SCRIPT_COMMAND_PORT_REPLACE = "{{SCRIPT_COMMAND_PORT_REPLACE}}";
-static const std::string TRAJECTORY_SERVER_PORT_REPLACE = "{{TRAJECTORY_SERVER_PORT_REPLACE}}";
-static const std::string SERVO_J_REPLACE = "{{SERVO_J_REPLACE}}";
-static const std::string POS_ZOOM_RATIO_REPLACE = "{{POS_ZOOM_RATIO_REPLACE}}";
-static const std::string TIME_ZOOM_RATIO_REPLACE = "{{TIME_ZOOM_RATIO_REPLACE}}";
-static const std::string COMMON_ZOOM_RATIO_REPLACE = "{{COMMON_ZOOM_RATIO_REPLACE}}";
-static const std::string REVERSE_DATA_SIZE_REPLACE = "{{REVERSE_DATA_SIZE_REPLACE}}";
-static const std::string TRAJECTORY_DATA_SIZE_REPLACE = "{{TRAJECTORY_DATA_SIZE_REPLACE}}";
-static const std::string SCRIPT_COMMAND_DATA_SIZE_REPLACE = "{{SCRIPT_COMMAND_DATA_SIZE_REPLACE}}";
-static const std::string STOP_J_REPLACE = "{{STOP_J_REPLACE}}";
+static const std::string SERVER_IP_REPLACE = "SERVER_IP_REPLACE";
+static const std::string REVERSE_PORT_REPLACE = "REVERSE_PORT_REPLACE";
+static const std::string SCRIPT_COMMAND_PORT_REPLACE = "SCRIPT_COMMAND_PORT_REPLACE";
+static const std::string TRAJECTORY_SERVER_PORT_REPLACE = "TRAJECTORY_SERVER_PORT_REPLACE";
+static const std::string SERVO_J_TIME_REPLACE = "SERVO_J_TIME_REPLACE";
+static const std::string SERVO_J_LOOKAHEAD_TIME_REPLACE = "SERVO_J_LOOKAHEAD_TIME_REPLACE";
+static const std::string SERVO_J_GAIN_REPLACE = "SERVO_J_GAIN_REPLACE";
+static const std::string POS_ZOOM_RATIO_REPLACE = "POS_ZOOM_RATIO_REPLACE";
+static const std::string TIME_ZOOM_RATIO_REPLACE = "TIME_ZOOM_RATIO_REPLACE";
+static const std::string COMMON_ZOOM_RATIO_REPLACE = "COMMON_ZOOM_RATIO_REPLACE";
+static const std::string REVERSE_DATA_SIZE_REPLACE = "REVERSE_DATA_SIZE_REPLACE";
+static const std::string TRAJECTORY_DATA_SIZE_REPLACE = "TRAJECTORY_DATA_SIZE_REPLACE";
+static const std::string SCRIPT_COMMAND_DATA_SIZE_REPLACE = "SCRIPT_COMMAND_DATA_SIZE_REPLACE";
+static const std::string STOP_J_REPLACE = "STOP_J_REPLACE";
 
 class EliteDriver::Impl {
 public:
@@ -36,9 +41,12 @@ public:
     }
 
     std::string readScriptFile(const std::string& file);
-    void scriptParamWrite(std::string& file_string, int reverse_port, int trajectory_port, \
+    void scriptParamWrite(ScriptTemplate& script, int reverse_port, int trajectory_port,
                           int script_command_port, float servoj_time, float servoj_lookhead_time, 
                           int servoj_gain, float stopj_acc);
+    void setServojParamValues(ScriptTemplate& script, float servoj_time, float servoj_lookhead_time, int servoj_gain);
+    void renderScript();
+    std::unique_ptr<ScriptTemplate> script_template_;
     std::string robot_script_;
     std::string robot_ip_;
     std::string local_ip_;
@@ -48,6 +56,7 @@ public:
     std::unique_ptr<ScriptCommandInterface> script_command_server_;
     std::unique_ptr<PrimaryPortInterface> primary_port_;
     bool headless_mode_;
+    EliteDriverStartupTimings startup_timings_;
 };
 
 
@@ -65,86 +74,51 @@ std::string EliteDriver::Impl::readScriptFile(const std::string& filepath) {
     return content;
 }
 
-void EliteDriver::Impl::scriptParamWrite(std::string& file_string, int reverse_port, int trajectory_port, 
+void EliteDriver::Impl::scriptParamWrite(ScriptTemplate& script, int reverse_port, int trajectory_port, 
                                          int script_command_port, float servoj_time, float servoj_lookhead_time, 
                                          int servoj_gain, float stopj_acc) {
+    script.setValue(SERVER_IP_REPLACE, local_ip_);
+    script.setValue(TRAJECTORY_SERVER_PORT_REPLACE, std::to_string(trajectory_port));
+    script.setValue(REVERSE_PORT_REPLACE, std::to_string(reverse_port));
+    script.setValue(SCRIPT_COMMAND_PORT_REPLACE, std::to_string(script_command_port));
+
+    setServojParamValues(script, servoj_time, servoj_lookhead_time, servoj_gain);
+
+    script.setValue(POS_ZOOM_RATIO_REPLACE, std::to_string(CONTROL::POS_ZOOM_RATIO));
+    script.setValue(TIME_ZOOM_RATIO_REPLACE, std::to_string(CONTROL::TIME_ZOOM_RATIO));
+    script.setValue(COMMON_ZOOM_RATIO_REPLACE, std::to_string(CONTROL::COMMON_ZOOM_RATIO));
+    script.setValue(REVERSE_DATA_SIZE_REPLACE, std::to_string(ReverseInterface::REVERSE_DATA_SIZE));
+    script.setValue(TRAJECTORY_DATA_SIZE_REPLACE, std::to_string(TrajectoryInterface::TRAJECTORY_MESSAGE_LEN));
+    script.setValue(SCRIPT_COMMAND_DATA_SIZE_REPLACE, std::to_string(ScriptCommandInterface::SCRIPT_COMMAND_DATA_SIZE));
+    script.setValue(STOP_J_REPLACE, std::to_string(stopj_acc));
+}
 
-    while (file_string.find(SERVER_IP_REPLACE) != std::string::npos) {
-        file_string.replace(file_string.find(SERVER_IP_REPLACE), 
-                            SERVER_IP_REPLACE.length(), 
-                            local_ip_);
-    }
-    
-    while (file_string.find(TRAJECTORY_SERVER_PORT_REPLACE) != std::string::npos) {
-        file_string.replace(file_string.find(TRAJECTORY_SERVER_PORT_REPLACE), 
-                            TRAJECTORY_SERVER_PORT_REPLACE.length(), 
-                            std::to_string(trajectory_port));
-    }
-    
-    while (file_string.find(REVERSE_PORT_REPLACE) != std::string::npos) {
-        file_string.replace(file_string.find(REVERSE_PORT_REPLACE), 
-                            REVERSE_PORT_REPLACE.length(), 
-                            std::to_string(reverse_port));
-    }
-
-    while (file_string.find(SCRIPT_COMMAND_PORT_REPLACE) != std::string::npos) {
-        file_string.replace(file_string.find(SCRIPT_COMMAND_PORT_REPLACE), 
-                            SCRIPT_COMMAND_PORT_REPLACE.length(), 
-                            std::to_string(script_command_port));
-    }
-    
-    std::ostringstream servoj_replace_str;
-    servoj_replace_str<< "t = " << servoj_time << ", lookahead_time = " << servoj_lookhead_time << ", gain=" << servoj_gain;
-    while (file_string.find(SERVO_J_REPLACE) != std::string::npos) {
-        file_string.replace(file_string.find(SERVO_J_REPLACE), 
-                            SERVO_J_REPLACE.length(), 
-                            servoj_replace_str.str());
-    }
-    
-    while (file_string.find(POS_ZOOM_RATIO_REPLACE) != std::string::npos) {
-        file_string.replace(file_string.find(POS_ZOOM_RATIO_REPLACE), 
-                            POS_ZOOM_RATIO_REPLACE.length(), 
-                            std::to_string(CONTROL::POS_ZOOM_RATIO));
-    }
-    
-
-    while (file_string.find(TIME_ZOOM_RATIO_REPLACE) != std::string::npos) {
-        file_string.replace(file_string.find(TIME_ZOOM_RATIO_REPLACE), 
-                            TIME_ZOOM_RATIO_REPLACE.length(), 
-                            std::to_string(CONTROL::TIME_ZOOM_RATIO));
-    }
-
-    while (file_string.find(COMMON_ZOOM_RATIO_REPLACE) != std::string::npos) {
-        file_string.replace(file_string.find(COMMON_ZOOM_RATIO_REPLACE), 
-                            COMMON_ZOOM_RATIO_REPLACE.length(), 
-                            std::to_string(CONTROL::COMMON_ZOOM_RATIO));
-    }
-
-    while (file_string.find(REVERSE_DATA_SIZE_REPLACE) != std::string::npos) {
-        
-        file_string.replace(file_string.find(REVERSE_DATA_SIZE_REPLACE), \
-                            REVERSE_DATA_SIZE_REPLACE.length(), \
-                            std::to_string(ReverseInterface::REVERSE_DATA_SIZE));
-    }
-
-    while (file_string.find(TRAJECTORY_DATA_SIZE_REPLACE) != std::string::npos) {
-        file_string.replace(file_string.find(TRAJECTORY_DATA_SIZE_REPLACE), \
-                            TRAJECTORY_DATA_SIZE_REPLACE.length(), \
-                            std::to_string(TrajectoryInterface::TRAJECTORY_MESSAGE_LEN));
-    }
-
-    while (file_string.find(SCRIPT_COMMAND_DATA_SIZE_REPLACE) != std::string::npos) {
-        file_string.replace(file_string.find(SCRIPT_COMMAND_DATA_SIZE_REPLACE), \
-                            SCRIPT_COMMAND_DATA_SIZE_REPLACE.length(), \
-                            std::to_string(ScriptCommandInterface::SCRIPT_COMMAND_DATA_SIZE));
-    }
+void EliteDriver::Impl::setServojParamValues(ScriptTemplate& script, float servoj_time, float servoj_lookhead_time,
+                                             int servoj_gain) {
+    std::ostringstream time_str;
+    time_str << servoj_time;
+    std::ostringstream lookahead_time_str;
+    lookahead_time_str << servoj_lookhead_time;
+    script.setValue(SERVO_J_TIME_REPLACE, time_str.str());
+    script.setValue(SERVO_J_LOOKAHEAD_TIME_REPLACE, lookahead_time_str.str());
+    script.setValue(SERVO_J_GAIN_REPLACE, std::to_string(servoj_gain));
+}
 
-    while (file_string.find(STOP_J_REPLACE) != std::string::npos) {
-        file_string.replace(file_string.find(STOP_J_REPLACE), \
-                            STOP_J_REPLACE.length(), \
-                            std::to_string(stopj_acc));
+void EliteDriver::Impl::renderScript() {
+    if (headless_mode_) {
+        // Wrap the script in a function, every line is indented while rendering
+        static const std::string HEADLESS_BEGIN = "def externalControl():\n";
+        static const std::string HEADLESS_END = "end";
+        std::string body = script_template_->render("\t");
+        if (!body.empty() && body.back() != '\n') {
+            body += '\n';
+        }
+        robot_script_.clear();
+        robot_script_.reserve(HEADLESS_BEGIN.size() + body.size() + HEADLESS_END.size());
+        robot_script_.append(HEADLESS_BEGIN).append(body).append(HEADLESS_END);
+    } else {
+        robot_script_ = script_template_->render();
     }
-
 }
 
 EliteDriver::EliteDriver(const std::string& robot_ip, const std::string& local_ip, const std::string& script_file,
@@ -156,8 +130,20 @@ EliteDriver::EliteDriver(const std::string& robot_ip, const std::string& local_i
     impl_ = new EliteDriver::Impl(robot_ip, local_ip);
     
     // Generate external control script.
-    std::string control_script = impl_->readScriptFile(script_file);
-    impl_->scriptParamWrite(control_script, reverse_port, trajectory_port, script_command_port, servoj_time, servoj_lookhead_time, servoj_gain, stopj_acc);
+    impl_->script_template_ = std::make_unique<ScriptTemplate>(impl_->readScriptFile(script_file));
+    impl_->scriptParamWrite(*impl_->script_template_, reverse_port, trajectory_port, script_command_port, servoj_time,
+                            servoj_lookhead_time, servoj_gain, stopj_acc);
+
+    using namespace std::chrono;
+    auto begin = steady_clock::now();
+    // Connect to robot primary port while the servers are created, the connection takes the longest
+    impl_->primary_port_ = std::make_unique<PrimaryPortInterface>();
+    std::future<bool> primary_connected = std::async(std::launch::async, [this, robot_ip]() {
+        auto primary_begin = steady_clock::now();
+        bool result = impl_->primary_port_->connect(robot_ip, PrimaryPortInterface::PRIMARY_PORT);
+        impl_->startup_timings_.primary_port = duration_cast<microseconds>(steady_clock::now() - primary_begin);
+        return result;
+    });
 
     impl_->reverse_server_ = std::make_unique<ReverseInterface>(reverse_port);
     ELITE_LOG_DEBUG("Created reverse interface");
@@ -165,31 +151,33 @@ EliteDriver::EliteDriver(const std::string& robot_ip, const std::string& local_i
     ELITE_LOG_DEBUG("Created trajectory interface");
     impl_->script_command_server_ = std::make_unique<ScriptCommandInterface>(script_command_port);
     ELITE_LOG_DEBUG("Created script command interface");
-    // Connect to robot primary port
-    impl_->primary_port_ = std::make_unique<PrimaryPortInterface>();
-    if (!impl_->primary_port_->connect(robot_ip, PrimaryPortInterface::PRIMARY_PORT)) {
+    auto servers_done = steady_clock::now();
+    impl_->startup_timings_.servers = duration_cast<microseconds>(servers_done - begin);
+
+    impl_->headless_mode_ = headless_mode;
+    impl_->renderScript();
+    auto render_done = steady_clock::now();
+
+    if (!primary_connected.get()) {
         ELITE_LOG_ERROR("Connect robot primary port fail");
         impl_->primary_port_.reset();
     }
-    
-    impl_->headless_mode_ = headless_mode;
+    auto script_begin = steady_clock::now();
 
     if (headless_mode) {
-        impl_->robot_script_ += "def externalControl():\n";
-        std::istringstream control_script_stream(control_script);
-        std::string line;
-        while (std::getline(control_script_stream, line)) {
-            impl_->robot_script_ += "\t" + line + "\n";
-        }
-        impl_->robot_script_ += "end";
-
         sendExternalControlScript();
     } else {
-        impl_->robot_script_ = control_script;
         impl_->script_sender_ = std::make_unique<ScriptSender>(script_sender_port, impl_->robot_script_);
         ELITE_LOG_DEBUG("Created script sender");
     }
 
+    auto end = steady_clock::now();
+    impl_->startup_timings_.script = duration_cast<microseconds>((render_done - servers_done) + (end - script_begin));
+    impl_->startup_timings_.total = duration_cast<microseconds>(end - begin);
+    ELITE_LOG_DEBUG("Startup in %lld us (servers %lld us, primary port %lld us, script %lld us)",
+                    (long long)impl_->startup_timings_.total.count(), (long long)impl_->startup_timings_.servers.count(),
+                    (long long)impl_->startup_timings_.primary_port.count(),
+                    (long long)impl_->startup_timings_.script.count());
     ELITE_LOG_DEBUG("Initialization done");
 }
 
@@ -203,6 +191,28 @@ bool EliteDriver::writeServoj(const vector6d_t& pos, int timeout_ms) {
     return impl_->reverse_server_->writeJointCommand(pos, ControlMode::MODE_SERVOJ, timeout_ms);
 }
 
+bool EliteDriver::setServojParams(float servoj_time, float servoj_lookhead_time, int servoj_gain) {
+    if (servoj_time <= 0 || servoj_lookhead_time < 0.03f || servoj_lookhead_time > 0.2f || servoj_gain <= 0) {
+        ELITE_LOG_ERROR("Invalid servoj parameters: time %f, lookahead time %f, gain %d", servoj_time, servoj_lookhead_time,
+                        servoj_gain);
+        return false;
+    }
+    if (!impl_->script_command_server_->setServojParams(servoj_time, servoj_lookhead_time, servoj_gain)) {
+        return false;
+    }
+    // A script sent later starts with the new parameters
+    impl_->setServojParamValues(*impl_->script_template_, servoj_time, servoj_lookhead_time, servoj_gain);
+    impl_->renderScript();
+    if (impl_->script_sender_) {
+        impl_->script_sender_->setProgram(impl_->robot_script_);
+    }
+    return true;
+}
+
+bool EliteDriver::writePose(const vector6d_t& pose, int timeout_ms) {
+    return impl_->reverse_server_->writeJointCommand(pose, ControlMode::MODE_POSE, timeout_ms);
+}
+
 bool EliteDriver::writeSpeedl(const vector6d_t& vel, int timeout_ms) {
     return impl_->reverse_server_->writeJointCommand(vel, ControlMode::MODE_SPEEDL, timeout_ms);
 }
@@ -219,6 +229,15 @@ bool EliteDriver::writeTrajectoryPoint(const vector6d_t& positions, float time,
     return impl_->trajectory_server_->writeTrajectoryPoint(positions, time, blend_radius, cartesian);
 }
 
+bool EliteDriver::writeTrajectorySplinePoint(const vector6d_t& positions, const vector6d_t& velocities, float time) {
+    return impl_->trajectory_server_->writeTrajectorySplinePoint(positions, velocities, time);
+}
+
+bool EliteDriver::writeTrajectorySplinePoint(const vector6d_t& positions, const vector6d_t& velocities,
+                                             const vector6d_t& accelerations, float time) {
+    return impl_->trajectory_server_->writeTrajectorySplinePoint(positions, velocities, accelerations, time);
+}
+
 bool EliteDriver::writeTrajectoryControlAction(TrajectoryControlAction action, const int point_number, int robot_receive_timeout) {
     return impl_->reverse_server_->writeTrajectoryControlAction(action, point_number, robot_receive_timeout);
 }
@@ -288,4 +307,28 @@ bool EliteDriver::getPrimaryPackage(std::shared_ptr<PrimaryPackage> pkg, int tim
 bool EliteDriver::primaryReconnect() {
     impl_->primary_port_->disconnect();
     return impl_->primary_port_->connect(impl_->robot_ip_);
-}
\ No newline at end of file
+}
+
+EliteDriverStartupTimings EliteDriver::getStartupTimings() {
+    return impl_->startup_timings_;
+}
+
+void EliteDriver::setAdaptiveTimeout(bool enable, const AdaptiveTimeoutOptions& options) {
+    if (enable) {
+        impl_->reverse_server_->enableAdaptiveTimeout(options);
+    } else {
+        impl_->reverse_server_->disableAdaptiveTimeout();
+    }
+}
+
+AdaptiveTimeoutStatistics EliteDriver::getAdaptiveTimeoutStatistics() {
+    return impl_->reverse_server_->getAdaptiveTimeoutStatistics();
+}
+
+void EliteDriver::setLatencyMeasurement(bool enable) {
+    impl_->reverse_server_->setLatencyMeasurement(enable);
+}
+
+ReverseLatencyStatistics EliteDriver::getLatencyStatistics() {
+    return impl_->reverse_server_->getLatencyStatistics();
+}
@@ -0,0 +1,208 @@
+#include "JointLimitValidator.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+using namespace ELITE;
+
+namespace {
+
+struct Limits {
+    const vector6d_t& min;
+    const vector6d_t& max;
+    const vector6d_t& velocity;
+    const vector6d_t& acc;
+};
+
+LimitViolation violation(LimitViolation::Type type, size_t index, int joint, double value, double limit) {
+    LimitViolation v;
+    v.type = type;
+    v.index = index;
+    v.joint = joint;
+    v.value = value;
+    v.limit = limit;
+    return v;
+}
+
+// Checks one point: the position, the velocity from the previous point if any, and the change from the previous
+// velocity if any. The comparisons are negated so a NaN fails.
+LimitViolation checkPoint(const Limits& limits, size_t index, const vector6d_t& q, const vector6d_t* previous, double dt,
+                          const vector6d_t* previous_velocity, double previous_dt) {
+    for (int j = 0; j < 6; j++) {
+        if (!(q[j] >= limits.min[j])) {
+            return violation(LimitViolation::Type::POSITION, index, j, q[j], limits.min[j]);
+        }
+        if (!(q[j] <= limits.max[j])) {
+            return violation(LimitViolation::Type::POSITION, index, j, q[j], limits.max[j]);
+        }
+    }
+    if (!previous) {
+        return LimitViolation();
+    }
+    vector6d_t velocity;
+    for (int j = 0; j < 6; j++) {
+        velocity[j] = (q[j] - (*previous)[j]) / dt;
+        if (!(std::fabs(velocity[j]) <= limits.velocity[j])) {
+            return violation(LimitViolation::Type::VELOCITY, index, j, velocity[j], limits.velocity[j]);
+        }
+    }
+    if (!previous_velocity) {
+        return LimitViolation();
+    }
+    for (int j = 0; j < 6; j++) {
+        double acc = (velocity[j] - (*previous_velocity)[j]) / ((dt + previous_dt) / 2);
+        if (limits.acc[j] > 0 && !(std::fabs(acc) <= limits.acc[j])) {
+            return violation(LimitViolation::Type::ACCELERATION, index, j, acc, limits.acc[j]);
+        }
+    }
+    return LimitViolation();
+}
+
+struct ConstantTime {
+    double period;
+    double operator()(size_t) const { return period; }
+};
+
+struct VariableTime {
+    // times[i]: time from point i - 1 to point i
+    const double* times;
+    double operator()(size_t i) const { return times[i]; }
+};
+
+// The points are columns[j][i]. With a start, point 0 is reached from it after times(0).
+template <typename Times>
+LimitViolation validateColumns(const Limits& limits, const std::array<const double*, 6>& columns, size_t count,
+                               Times times, const vector6d_t* start) {
+    auto point = [&](size_t i) {
+        vector6d_t q;
+        for (int j = 0; j < 6; j++) {
+            q[j] = columns[j][i];
+        }
+        return q;
+    };
+    // Point by point, for the first points, and for a block that failed
+    auto checkRange = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            vector6d_t q = point(i);
+            vector6d_t previous, previous_velocity;
+            bool has_previous = i >= 1 || start;
+            bool has_velocity = i >= 2 || (i == 1 && start);
+            if (has_previous) {
+                previous = i >= 1 ? point(i - 1) : *start;
+            }
+            if (has_velocity) {
+                vector6d_t before = i >= 2 ? point(i - 2) : *start;
+                for (int j = 0; j < 6; j++) {
+                    previous_velocity[j] = (previous[j] - before[j]) / times(i - 1);
+                }
+            }
+            LimitViolation v = checkPoint(limits, i, q, has_previous ? &previous : nullptr, times(i),
+                                          has_velocity ? &previous_velocity : nullptr, has_velocity ? times(i - 1) : 0);
+            if (!v.isValid()) {
+                return v;
+            }
+        }
+        return LimitViolation();
+    };
+
+    size_t head = std::min<size_t>(count, 2);
+    LimitViolation v = checkRange(0, head);
+    if (!v.isValid()) {
+        return v;
+    }
+    // The loops below have no branches and no early exit, so the compiler can vectorize them
+    constexpr size_t BLOCK = 256;
+    for (size_t begin = head; begin < count; begin += BLOCK) {
+        size_t end = std::min(count, begin + BLOCK);
+        int bad = 0;
+        for (int j = 0; j < 6; j++) {
+            const double* p = columns[j];
+            const double lo = limits.min[j], hi = limits.max[j], vmax = limits.velocity[j], amax = limits.acc[j];
+            for (size_t i = begin; i < end; i++) {
+                bad |= !(p[i] >= lo) | !(p[i] <= hi);
+            }
+            for (size_t i = begin; i < end; i++) {
+                bad |= !(std::fabs(p[i] - p[i - 1]) <= vmax * times(i));
+            }
+            if (amax > 0) {
+                for (size_t i = begin; i < end; i++) {
+                    double t1 = times(i), t0 = times(i - 1);
+                    double dv = (p[i] - p[i - 1]) / t1 - (p[i - 1] - p[i - 2]) / t0;
+                    bad |= !(std::fabs(dv) <= amax * (t1 + t0) / 2);
+                }
+            }
+        }
+        if (bad) {
+            v = checkRange(begin, end);
+            if (!v.isValid()) {
+                return v;
+            }
+        }
+    }
+    return LimitViolation();
+}
+
+}  // namespace
+
+JointLimitValidator::JointLimitValidator(const JointLimitsInfo& info)
+    : JointLimitValidator(info.limit_min_, info.limit_max_, info.max_velocity_, info.max_acc_) {}
+
+JointLimitValidator::JointLimitValidator(const vector6d_t& limit_min, const vector6d_t& limit_max,
+                                         const vector6d_t& max_velocity, const vector6d_t& max_acc)
+    : limit_min_(limit_min), limit_max_(limit_max), max_velocity_(max_velocity), max_acc_(max_acc) {}
+
+LimitViolation JointLimitValidator::validate(const Vector6dBatch& points, double period) const {
+    std::array<const double*, 6> columns;
+    for (int j = 0; j < 6; j++) {
+        columns[j] = points.values[j].data();
+    }
+    return validateColumns(Limits{limit_min_, limit_max_, max_velocity_, max_acc_}, columns, points.size(),
+                           ConstantTime{period}, nullptr);
+}
+
+LimitViolation JointLimitValidator::validate(const Vector6dBatch& points, double period, const vector6d_t& start) const {
+    std::array<const double*, 6> columns;
+    for (int j = 0; j < 6; j++) {
+        columns[j] = points.values[j].data();
+    }
+    return validateColumns(Limits{limit_min_, limit_max_, max_velocity_, max_acc_}, columns, points.size(),
+                           ConstantTime{period}, &start);
+}
+
+LimitViolation JointLimitValidator::validate(const std::vector<TrajectoryWaypoint>& points, const vector6d_t& start) const {
+    Vector6dBatch batch(points.size());
+    std::vector<double> times(points.size());
+    for (size_t i = 0; i < points.size(); i++) {
+        batch.set(i, points[i].positions);
+        times[i] = points[i].time;
+    }
+    std::array<const double*, 6> columns;
+    for (int j = 0; j < 6; j++) {
+        columns[j] = batch.values[j].data();
+    }
+    return validateColumns(Limits{limit_min_, limit_max_, max_velocity_, max_acc_}, columns, points.size(),
+                           VariableTime{times.data()}, &start);
+}
+
+void JointLimitValidator::reset(const vector6d_t& current) {
+    servo_last_ = current;
+    servo_has_velocity_ = false;
+    servo_count_ = 0;
+}
+
+LimitViolation JointLimitValidator::checkServo(const vector6d_t& target, double period) {
+    LimitViolation v = checkPoint(Limits{limit_min_, limit_max_, max_velocity_, max_acc_}, servo_count_, target, &servo_last_,
+                                  period, servo_has_velocity_ ? &servo_velocity_ : nullptr, servo_period_);
+    if (!v.isValid()) {
+        return v;
+    }
+    for (int j = 0; j < 6; j++) {
+        servo_velocity_[j] = (target[j] - servo_last_[j]) / period;
+    }
+    servo_last_ = target;
+    servo_period_ = period;
+    servo_has_velocity_ = true;
+    servo_count_++;
+    return v;
+}
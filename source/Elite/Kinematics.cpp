@@ -0,0 +1,413 @@
+#include "Kinematics.hpp"
+#include "EliteException.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+using namespace ELITE;
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+
+// a * b, both rigid transforms
+Transform3d multiply(const Transform3d& a, const Transform3d& b) {
+    Transform3d r;
+    for (int row = 0; row < 3; row++) {
+        const double* ar = &a[row * 4];
+        for (int col = 0; col < 4; col++) {
+            r[row * 4 + col] = ar[0] * b[col] + ar[1] * b[4 + col] + ar[2] * b[8 + col];
+        }
+        r[row * 4 + 3] += ar[3];
+    }
+    return r;
+}
+
+// Inverse of a rigid transform
+Transform3d invert(const Transform3d& t) {
+    Transform3d r;
+    for (int row = 0; row < 3; row++) {
+        for (int col = 0; col < 3; col++) {
+            r[row * 4 + col] = t[col * 4 + row];
+        }
+        r[row * 4 + 3] = -(t[row] * t[3] + t[4 + row] * t[7] + t[8 + row] * t[11]);
+    }
+    return r;
+}
+
+double wrapAngle(double angle) { return std::remainder(angle, 2 * PI); }
+
+// The angle shifted by multiples of 2 pi to the one nearest the reference
+double unwrapNear(double angle, double reference) { return reference + wrapAngle(angle - reference); }
+
+// Among the solutions, the one nearest to the reference, each joint unwrapped to the reference
+vector6d_t nearestSolution(const vector6d_t* solutions, int count, const vector6d_t& reference) {
+    vector6d_t best{};
+    double best_distance = -1;
+    for (int n = 0; n < count; n++) {
+        vector6d_t candidate;
+        double distance = 0;
+        for (size_t j = 0; j < 6; j++) {
+            candidate[j] = unwrapNear(solutions[n][j], reference[j]);
+            distance += (candidate[j] - reference[j]) * (candidate[j] - reference[j]);
+        }
+        if (best_distance < 0 || distance < best_distance) {
+            best_distance = distance;
+            best = candidate;
+        }
+    }
+    return best;
+}
+
+// Solutions with sin(q5) below this are at the wrist singularity, where only a combination of q4 and q6 is determined
+constexpr double WRIST_SINGULAR_SIN = 1e-10;
+
+}  // namespace
+
+Kinematics::Kinematics(const KinematicsInfo& info) : Kinematics(info.dh_a_, info.dh_d_, info.dh_alpha_) {}
+
+Kinematics::Kinematics(const vector6d_t& dh_a, const vector6d_t& dh_d, const vector6d_t& dh_alpha)
+    : dh_a_(dh_a), dh_d_(dh_d), dh_alpha_(dh_alpha) {
+    for (size_t i = 0; i < 6; i++) {
+        sin_alpha_[i] = std::sin(dh_alpha_[i]);
+        cos_alpha_[i] = std::cos(dh_alpha_[i]);
+    }
+    tcp_ = poseToTransform({0, 0, 0, 0, 0, 0});
+    tcp_inverse_ = tcp_;
+}
+
+void Kinematics::setTcpOffset(const vector6d_t& tcp_offset) {
+    tcp_ = poseToTransform(tcp_offset);
+    tcp_inverse_ = invert(tcp_);
+    has_tcp_ = false;
+    for (double v : tcp_offset) {
+        has_tcp_ = has_tcp_ || v != 0;
+    }
+}
+
+Transform3d Kinematics::poseToTransform(const vector6d_t& pose) {
+    double angle = std::sqrt(pose[3] * pose[3] + pose[4] * pose[4] + pose[5] * pose[5]);
+    double x = 0, y = 0, z = 1;
+    if (angle > 1e-12) {
+        x = pose[3] / angle;
+        y = pose[4] / angle;
+        z = pose[5] / angle;
+    }
+    double c = std::cos(angle), s = std::sin(angle), v = 1 - c;
+    return {x * x * v + c,     x * y * v - z * s, x * z * v + y * s, pose[0],
+            x * y * v + z * s, y * y * v + c,     y * z * v - x * s, pose[1],
+            x * z * v - y * s, y * z * v + x * s, z * z * v + c,     pose[2]};
+}
+
+vector6d_t Kinematics::transformToPose(const Transform3d& t) {
+    vector6d_t pose = {t[3], t[7], t[11], 0, 0, 0};
+    double cos_angle = std::min(1.0, std::max(-1.0, (t[0] + t[5] + t[10] - 1) / 2));
+    double angle = std::acos(cos_angle);
+    // Skew-symmetric part, 2 * sin(angle) * axis
+    double kx = t[9] - t[6], ky = t[2] - t[8], kz = t[4] - t[1];
+    if (angle < 1e-6) {
+        pose[3] = kx / 2;
+        pose[4] = ky / 2;
+        pose[5] = kz / 2;
+    } else if (PI - angle < 1e-4) {
+        // sin(angle) is too small, the axis is taken from the symmetric part
+        double x = std::sqrt(std::max(0.0, (t[0] + 1) / 2));
+        double y = std::sqrt(std::max(0.0, (t[5] + 1) / 2));
+        double z = std::sqrt(std::max(0.0, (t[10] + 1) / 2));
+        if (x >= y && x >= z) {
+            y = std::copysign(y, t[1] + t[4]);
+            z = std::copysign(z, t[2] + t[8]);
+        } else if (y >= z) {
+            x = std::copysign(x, t[1] + t[4]);
+            z = std::copysign(z, t[6] + t[9]);
+        } else {
+            x = std::copysign(x, t[2] + t[8]);
+            y = std::copysign(y, t[6] + t[9]);
+        }
+        // Still the sign of the skew-symmetric part, unless the angle is exactly pi
+        double norm = std::sqrt(x * x + y * y + z * z);
+        if (x * kx + y * ky + z * kz < 0) {
+            norm = -norm;
+        }
+        pose[3] = x / norm * angle;
+        pose[4] = y / norm * angle;
+        pose[5] = z / norm * angle;
+    } else {
+        double scale = angle / (2 * std::sin(angle));
+        pose[3] = kx * scale;
+        pose[4] = ky * scale;
+        pose[5] = kz * scale;
+    }
+    return pose;
+}
+
+Transform3d Kinematics::forwardTransform(const vector6d_t& joints) const {
+    Transform3d t = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0};
+    for (size_t i = 0; i < 6; i++) {
+        double ct = std::cos(joints[i]), st = std::sin(joints[i]);
+        double ca = cos_alpha_[i], sa = sin_alpha_[i];
+        // Rz(theta) * Tz(d) * Tx(a) * Rx(alpha)
+        Transform3d link = {ct, -st * ca, st * sa,  dh_a_[i] * ct,
+                            st, ct * ca,  -ct * sa, dh_a_[i] * st,
+                            0,  sa,       ca,       dh_d_[i]};
+        t = multiply(t, link);
+    }
+    if (has_tcp_) {
+        t = multiply(t, tcp_);
+    }
+    return t;
+}
+
+vector6d_t Kinematics::forward(const vector6d_t& joints) const { return transformToPose(forwardTransform(joints)); }
+
+void Kinematics::forward(const Vector6dBatch& joints, Vector6dBatch& poses) const {
+    // Blocks of configurations, each matrix element a column over the block. The inner loops have no calls and no branches.
+    constexpr size_t BLOCK = 64;
+    size_t count = joints.size();
+    poses.resize(count);
+    double c[BLOCK], s[BLOCK];
+    double m[12][BLOCK];
+    for (size_t begin = 0; begin < count; begin += BLOCK) {
+        size_t n = std::min(BLOCK, count - begin);
+        for (size_t j = 0; j < 6; j++) {
+            const double* q = joints.values[j].data() + begin;
+            for (size_t k = 0; k < n; k++) {
+                c[k] = std::cos(q[k]);
+                s[k] = std::sin(q[k]);
+            }
+            const double a = dh_a_[j], d = dh_d_[j], ca = cos_alpha_[j], sa = sin_alpha_[j];
+            if (j == 0) {
+                for (size_t k = 0; k < n; k++) {
+                    m[0][k] = c[k];
+                    m[1][k] = -s[k] * ca;
+                    m[2][k] = s[k] * sa;
+                    m[3][k] = a * c[k];
+                    m[4][k] = s[k];
+                    m[5][k] = c[k] * ca;
+                    m[6][k] = -c[k] * sa;
+                    m[7][k] = a * s[k];
+                    m[8][k] = 0;
+                    m[9][k] = sa;
+                    m[10][k] = ca;
+                    m[11][k] = d;
+                }
+                continue;
+            }
+            // Each row [r0 r1 r2 p] of the product times the link transform
+            for (int row = 0; row < 3; row++) {
+                double* r0 = m[row * 4];
+                double* r1 = m[row * 4 + 1];
+                double* r2 = m[row * 4 + 2];
+                double* p = m[row * 4 + 3];
+                for (size_t k = 0; k < n; k++) {
+                    double x0 = r0[k], x1 = r1[k], x2 = r2[k];
+                    double n0 = x0 * c[k] + x1 * s[k];
+                    double n1 = (x1 * c[k] - x0 * s[k]) * ca + x2 * sa;
+                    double n2 = (x0 * s[k] - x1 * c[k]) * sa + x2 * ca;
+                    p[k] += a * n0 + x2 * d;
+                    r0[k] = n0;
+                    r1[k] = n1;
+                    r2[k] = n2;
+                }
+            }
+        }
+        if (has_tcp_) {
+            for (int row = 0; row < 3; row++) {
+                double* r0 = m[row * 4];
+                double* r1 = m[row * 4 + 1];
+                double* r2 = m[row * 4 + 2];
+                double* p = m[row * 4 + 3];
+                for (size_t k = 0; k < n; k++) {
+                    double x0 = r0[k], x1 = r1[k], x2 = r2[k];
+                    r0[k] = x0 * tcp_[0] + x1 * tcp_[4] + x2 * tcp_[8];
+                    r1[k] = x0 * tcp_[1] + x1 * tcp_[5] + x2 * tcp_[9];
+                    r2[k] = x0 * tcp_[2] + x1 * tcp_[6] + x2 * tcp_[10];
+                    p[k] += x0 * tcp_[3] + x1 * tcp_[7] + x2 * tcp_[11];
+                }
+            }
+        }
+        for (size_t k = 0; k < n; k++) {
+            Transform3d t;
+            for (int e = 0; e < 12; e++) {
+                t[e] = m[e][k];
+            }
+            vector6d_t pose = transformToPose(t);
+            for (size_t j = 0; j < 6; j++) {
+                poses.values[j][begin + k] = pose[j];
+            }
+        }
+    }
+}
+
+Matrix6d Kinematics::jacobian(const vector6d_t& joints) const {
+    // Axis and origin of the frame before each joint, in the base frame
+    double axis[6][3], origin[6][3];
+    Transform3d t = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0};
+    for (size_t i = 0; i < 6; i++) {
+        for (int row = 0; row < 3; row++) {
+            axis[i][row] = t[row * 4 + 2];
+            origin[i][row] = t[row * 4 + 3];
+        }
+        double ct = std::cos(joints[i]), st = std::sin(joints[i]);
+        double ca = cos_alpha_[i], sa = sin_alpha_[i];
+        Transform3d link = {ct, -st * ca, st * sa,  dh_a_[i] * ct,
+                            st, ct * ca,  -ct * sa, dh_a_[i] * st,
+                            0,  sa,       ca,       dh_d_[i]};
+        t = multiply(t, link);
+    }
+    if (has_tcp_) {
+        t = multiply(t, tcp_);
+    }
+    // Column i: [z x (p - o); z]
+    Matrix6d j;
+    for (size_t i = 0; i < 6; i++) {
+        const double* z = axis[i];
+        double rx = t[3] - origin[i][0], ry = t[7] - origin[i][1], rz = t[11] - origin[i][2];
+        j[i] = z[1] * rz - z[2] * ry;
+        j[6 + i] = z[2] * rx - z[0] * rz;
+        j[12 + i] = z[0] * ry - z[1] * rx;
+        j[18 + i] = z[0];
+        j[24 + i] = z[1];
+        j[30 + i] = z[2];
+    }
+    return j;
+}
+
+bool Kinematics::isAnalyticInverseSupported() const {
+    const double expected_alpha[6] = {PI / 2, 0, 0, PI / 2, -PI / 2, 0};
+    for (size_t i = 0; i < 6; i++) {
+        if (std::fabs(wrapAngle(dh_alpha_[i] - expected_alpha[i])) > 1e-6) {
+            return false;
+        }
+    }
+    return dh_a_[3] == 0 && dh_a_[4] == 0 && dh_a_[5] == 0 && dh_a_[1] != 0 && dh_a_[2] != 0 && dh_d_[5] != 0;
+}
+
+void Kinematics::checkAnalyticInverse() const {
+    if (!isAnalyticInverseSupported()) {
+        throw EliteException(EliteException::Code::ILLEGAL_PARAM, "no closed form inverse kinematics for these DH parameters");
+    }
+}
+
+int Kinematics::solveInverse(const vector6d_t& pose, double singular_q6, vector6d_t* solutions) const {
+    Transform3d t = poseToTransform(pose);
+    if (has_tcp_) {
+        t = multiply(t, tcp_inverse_);
+    }
+    const double a2 = dh_a_[1], a3 = dh_a_[2], d4 = dh_d_[3], d6 = dh_d_[5];
+    // Origin of frame 5, the flange moved back along its z axis
+    double p5x = t[3] - d6 * t[2], p5y = t[7] - d6 * t[6];
+    double r = std::hypot(p5x, p5y);
+    if (r < std::fabs(d4) || r == 0) {
+        return 0;
+    }
+    // The offset of frame 5 along the axis of joint 2 is d4: r * sin(q1 - psi) = d4
+    double psi = std::atan2(p5y, p5x);
+    double phi = std::asin(d4 / r);
+    int count = 0;
+    for (double q1 : {psi + phi, psi + PI - phi}) {
+        double s1 = std::sin(q1), c1 = std::cos(q1);
+        // The axis of joint 2 in the TCP frame is (sin(q5) cos(q6), -sin(q5) sin(q6), cos(q5))
+        double c5 = (t[3] * s1 - t[7] * c1 - d4) / d6;
+        if (std::fabs(c5) > 1 + 1e-9) {
+            continue;
+        }
+        c5 = std::min(1.0, std::max(-1.0, c5));
+        for (double q5 : {std::acos(c5), -std::acos(c5)}) {
+            double s5 = std::sin(q5);
+            double q6 = singular_q6;
+            if (std::fabs(s5) > WRIST_SINGULAR_SIN) {
+                q6 = std::atan2((-t[1] * s1 + t[5] * c1) / s5, (t[0] * s1 - t[4] * c1) / s5);
+            }
+            // Frame 4 in frame 1: the planar arm of joints 2 and 3
+            auto link = [this](size_t i, double q) {
+                double ct = std::cos(q), st = std::sin(q), ca = cos_alpha_[i], sa = sin_alpha_[i];
+                return Transform3d{ct, -st * ca, st * sa, dh_a_[i] * ct, st, ct * ca, -ct * sa, dh_a_[i] * st,
+                                   0,  sa,       ca,      dh_d_[i]};
+            };
+            Transform3d t14 = multiply(multiply(invert(link(0, q1)), t), invert(multiply(link(4, q5), link(5, q6))));
+            double px = t14[3], py = t14[7];
+            double c3 = (px * px + py * py - a2 * a2 - a3 * a3) / (2 * a2 * a3);
+            if (std::fabs(c3) > 1 + 1e-9) {
+                continue;
+            }
+            c3 = std::min(1.0, std::max(-1.0, c3));
+            for (double q3 : {std::acos(c3), -std::acos(c3)}) {
+                double q2 = std::atan2(py, px) - std::atan2(a3 * std::sin(q3), a2 + a3 * std::cos(q3));
+                Transform3d t34 = multiply(invert(multiply(link(1, q2), link(2, q3))), t14);
+                double q4 = std::atan2(t34[4], t34[0]);
+                solutions[count++] = {wrapAngle(q1), wrapAngle(q2), wrapAngle(q3), wrapAngle(q4), wrapAngle(q5),
+                                      wrapAngle(q6)};
+            }
+        }
+    }
+    return count;
+}
+
+std::vector<vector6d_t> Kinematics::inverse(const vector6d_t& pose) const {
+    checkAnalyticInverse();
+    vector6d_t solutions[MAX_IK_SOLUTIONS];
+    int count = solveInverse(pose, 0, solutions);
+    return std::vector<vector6d_t>(solutions, solutions + count);
+}
+
+bool Kinematics::inverse(const vector6d_t& pose, const vector6d_t& seed, vector6d_t& joints) const {
+    checkAnalyticInverse();
+    vector6d_t solutions[MAX_IK_SOLUTIONS];
+    int count = solveInverse(pose, seed[5], solutions);
+    if (count == 0) {
+        return false;
+    }
+    joints = nearestSolution(solutions, count, seed);
+    return true;
+}
+
+size_t Kinematics::inverse(const Vector6dBatch& poses, const vector6d_t& seed, Vector6dBatch& joints,
+                           unsigned threads) const {
+    checkAnalyticInverse();
+    size_t size = poses.size();
+    joints.resize(size);
+    // All branches of every point, independent of each other, so they are solved in parallel
+    std::vector<vector6d_t> solutions(size * MAX_IK_SOLUTIONS);
+    std::vector<int> counts(size);
+    auto solveRange = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            counts[i] = solveInverse(poses.get(i), 0, &solutions[i * MAX_IK_SOLUTIONS]);
+        }
+    };
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = (unsigned)std::min<size_t>(threads, std::max<size_t>(1, size / 256));
+    if (threads <= 1) {
+        solveRange(0, size);
+    } else {
+        std::vector<std::thread> workers;
+        for (unsigned n = 0; n < threads; n++) {
+            workers.emplace_back(solveRange, size * n / threads, size * (n + 1) / threads);
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+    // Branch continuity: each point takes the solution nearest to the previous one
+    vector6d_t previous = seed;
+    for (size_t i = 0; i < size; i++) {
+        vector6d_t* candidates = &solutions[i * MAX_IK_SOLUTIONS];
+        bool singular = false;
+        for (int n = 0; n < counts[i]; n++) {
+            singular = singular || std::fabs(std::sin(candidates[n][4])) <= WRIST_SINGULAR_SIN;
+        }
+        if (singular) {
+            // The last joint keeps its previous value, which changes the others
+            counts[i] = solveInverse(poses.get(i), previous[5], candidates);
+        }
+        if (counts[i] == 0) {
+            return i;
+        }
+        previous = nearestSolution(candidates, counts[i], previous);
+        joints.set(i, previous);
+    }
+    return size;
+}
@@ -0,0 +1,43 @@
+#ifndef __ELITE__LATENCY_BUCKETS_HPP__
+#define __ELITE__LATENCY_BUCKETS_HPP__
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace ELITE {
+
+/**
+ * @brief
+ *      Latency histogram with fixed bucket bounds, used internally by ControlLoopStatistics and LatencyHistogram.
+ *      Bucket i holds the values up to bounds_us[i], the last one of the N + 1 buckets holds the rest.
+ */
+template <size_t N>
+size_t latencyBucket(const std::array<int, N>& bounds_us, int64_t value_us) {
+    return std::upper_bound(bounds_us.begin(), bounds_us.end(), value_us - 1) - bounds_us.begin();
+}
+
+/**
+ * @brief Upper bound of the bucket that holds the given fraction of the samples, or max for the last bucket
+ */
+template <size_t N>
+std::chrono::microseconds latencyPercentile(const std::array<int, N>& bounds_us,
+                                            const std::array<uint64_t, N + 1>& counts, uint64_t samples,
+                                            double fraction, std::chrono::microseconds max) {
+    uint64_t target = (uint64_t)std::ceil(fraction * samples);
+    uint64_t count = 0;
+    for (size_t i = 0; i < N; i++) {
+        count += counts[i];
+        if (count >= target && count > 0) {
+            return std::chrono::microseconds(bounds_us[i]);
+        }
+    }
+    return max;
+}
+
+}  // namespace ELITE
+
+#endif
@@ -18,30 +18,51 @@ void setLogLevel(LogLevel level) {
     getLogger().setLevel(level);
 }
 
-void log(const char* file, int line, LogLevel level, const char* fmt, ...) {
+LogLevel getLogLevel() {
+    return getLogger().getLogLevel();
+}
+
+bool isLogCaptureEnabled() {
+    return getLogger().isCaptureEnabled();
+}
+
+void logCaptured(const char* file, int line, LogLevel level, const char* fmt, const LogArg* args, int count) {
     if (level >= getLogger().getLogLevel()) {
-        size_t buffer_size = 4096;
-        std::unique_ptr<char[]> buffer;
-        buffer.reset(new char[buffer_size]);
+        getLogger().logCaptured(file, line, level, fmt, args, count);
+    }
+}
 
+void log(const char* file, int line, LogLevel level, const char* fmt, ...) {
+    if (level >= getLogger().getLogLevel()) {
         va_list args;
         va_start(args, fmt);
-        va_list args_copy;
-        va_copy(args_copy, args);
+        getLogger().log(file, line, level, fmt, args);
+        va_end(args);
+    }
+}
 
-        size_t characters = 1 + std::vsnprintf(buffer.get(), buffer_size, fmt, args);
+void enableAsyncLog(size_t capacity) {
+    getLogger().enableAsync(capacity);
+}
 
-        if (characters >= buffer_size) {
-            buffer_size = characters + 1;
-            buffer.reset(new char[buffer_size]);
-            std::vsnprintf(buffer.get(), buffer_size, fmt, args_copy);
-        }
+void disableAsyncLog() {
+    getLogger().disableAsync();
+}
 
-        va_end(args);
-        va_end(args_copy);
+void flushLog() {
+    getLogger().flush();
+}
 
-        getLogger().log(file, line, level, buffer.get());
-    }
+uint64_t getDroppedLogCount() {
+    return getLogger().getDroppedCount();
+}
+
+bool enableBinaryLog(const std::string& path, size_t capacity) {
+    return getLogger().enableBinary(path, capacity);
+}
+
+void disableBinaryLog() {
+    getLogger().disableBinary();
 }
 
 
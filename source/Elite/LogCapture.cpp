@@ -0,0 +1,382 @@
+#include "LogCapture.hpp"
+
+#include <cctype>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+namespace ELITE {
+
+namespace {
+
+constexpr char BINARY_LOG_MAGIC[8] = {'E', 'L', 'I', 'T', 'E', 'L', 'O', 'G'};
+constexpr uint32_t BINARY_LOG_VERSION = 1;
+constexpr char BINARY_LOG_STRING_ENTRY = 'S';
+constexpr char BINARY_LOG_RECORD_ENTRY = 'R';
+// Preformatted messages are written as a record with this format
+const char* const TEXT_FORMAT = "%s";
+
+struct DecodedArg {
+    LogArg::Type type;
+    int64_t i;
+    uint64_t u;
+    double d;
+    std::string s;
+};
+
+std::vector<DecodedArg> decodeArgs(const char* encoded, size_t size) {
+    std::vector<DecodedArg> result;
+    if (size == 0) {
+        return result;
+    }
+    size_t pos = 1;
+    int count = (uint8_t)encoded[0];
+    for (int i = 0; i < count && pos < size; i++) {
+        DecodedArg arg;
+        arg.type = (LogArg::Type)encoded[pos++];
+        arg.i = 0;
+        arg.u = 0;
+        arg.d = 0;
+        if (arg.type == LogArg::Type::STRING) {
+            if (pos + sizeof(uint16_t) > size) {
+                break;
+            }
+            uint16_t length = 0;
+            memcpy(&length, encoded + pos, sizeof(length));
+            pos += sizeof(length);
+            if (pos + length > size) {
+                break;
+            }
+            arg.s.assign(encoded + pos, length);
+            pos += length;
+        } else {
+            if (pos + sizeof(uint64_t) > size) {
+                break;
+            }
+            if (arg.type == LogArg::Type::INT) {
+                memcpy(&arg.i, encoded + pos, sizeof(arg.i));
+                arg.u = (uint64_t)arg.i;
+                arg.d = (double)arg.i;
+            } else if (arg.type == LogArg::Type::DOUBLE) {
+                memcpy(&arg.d, encoded + pos, sizeof(arg.d));
+                arg.i = (int64_t)arg.d;
+                arg.u = (uint64_t)arg.i;
+            } else {
+                memcpy(&arg.u, encoded + pos, sizeof(arg.u));
+                arg.i = (int64_t)arg.u;
+                arg.d = (double)arg.u;
+            }
+            pos += sizeof(uint64_t);
+        }
+        result.push_back(std::move(arg));
+    }
+    return result;
+}
+
+template <typename T>
+void appendFormatted(std::string& out, const std::string& spec, T value) {
+    char buffer[128];
+    int characters = snprintf(buffer, sizeof(buffer), spec.c_str(), value);
+    if (characters < 0) {
+        return;
+    }
+    if (characters < (int)sizeof(buffer)) {
+        out.append(buffer, characters);
+    } else {
+        std::string large(characters + 1, '\0');
+        snprintf(&large[0], large.size(), spec.c_str(), value);
+        out.append(large.c_str(), characters);
+    }
+}
+
+void appendDigits(std::string& spec, const char*& p) {
+    while (*p && isdigit((unsigned char)*p)) {
+        spec.push_back(*p++);
+    }
+}
+
+}  // namespace
+
+size_t LogCapture::encodeArgs(const LogArg* args, int count, char* buffer, size_t capacity) {
+    if (capacity == 0) {
+        return 0;
+    }
+    size_t pos = 1;
+    int encoded = 0;
+    for (int i = 0; i < count && encoded < 255; i++) {
+        const LogArg& arg = args[i];
+        if (arg.type == LogArg::Type::STRING) {
+            if (pos + 1 + sizeof(uint16_t) > capacity) {
+                break;
+            }
+            const char* str = arg.s ? arg.s : "(null)";
+            size_t length = strlen(str);
+            size_t space = capacity - pos - 1 - sizeof(uint16_t);
+            if (length > space) {
+                length = space;
+            }
+            uint16_t length16 = (uint16_t)length;
+            buffer[pos++] = (char)arg.type;
+            memcpy(buffer + pos, &length16, sizeof(length16));
+            pos += sizeof(length16);
+            memcpy(buffer + pos, str, length);
+            pos += length;
+        } else {
+            if (pos + 1 + sizeof(uint64_t) > capacity) {
+                break;
+            }
+            uint64_t raw = 0;
+            if (arg.type == LogArg::Type::INT) {
+                memcpy(&raw, &arg.i, sizeof(raw));
+            } else if (arg.type == LogArg::Type::DOUBLE) {
+                memcpy(&raw, &arg.d, sizeof(raw));
+            } else if (arg.type == LogArg::Type::POINTER) {
+                raw = (uint64_t)(uintptr_t)arg.p;
+            } else {
+                raw = arg.u;
+            }
+            buffer[pos++] = (char)arg.type;
+            memcpy(buffer + pos, &raw, sizeof(raw));
+            pos += sizeof(raw);
+        }
+        encoded++;
+    }
+    buffer[0] = (char)encoded;
+    return pos;
+}
+
+std::string LogCapture::format(const char* fmt, const char* encoded, size_t size) {
+    std::vector<DecodedArg> args = decodeArgs(encoded, size);
+    size_t next = 0;
+    std::string out;
+    const char* p = fmt;
+    while (*p) {
+        if (*p != '%') {
+            out.push_back(*p++);
+            continue;
+        }
+        if (p[1] == '%') {
+            out.push_back('%');
+            p += 2;
+            continue;
+        }
+        const char* start = p++;
+        std::string spec("%");
+        while (*p && strchr("-+ #0", *p)) {
+            spec.push_back(*p++);
+        }
+        if (*p == '*') {
+            spec += std::to_string(next < args.size() ? args[next++].i : 0);
+            p++;
+        } else {
+            appendDigits(spec, p);
+        }
+        if (*p == '.') {
+            spec.push_back(*p++);
+            if (*p == '*') {
+                spec += std::to_string(next < args.size() ? args[next++].i : 0);
+                p++;
+            } else {
+                appendDigits(spec, p);
+            }
+        }
+        // The length modifier is replaced according to the captured type
+        while (*p && strchr("hljztLq", *p)) {
+            p++;
+        }
+        char conversion = *p;
+        if (!conversion) {
+            out.append(start);
+            break;
+        }
+        p++;
+        if (conversion == 'n') {
+            next++;
+            continue;
+        }
+        if (next >= args.size()) {
+            // Missing argument, keep the specification
+            out.append(start, p - start);
+            continue;
+        }
+        const DecodedArg& arg = args[next++];
+        switch (conversion) {
+            case 'd':
+            case 'i':
+                appendFormatted(out, spec + "lld", (long long)arg.i);
+                break;
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X':
+                appendFormatted(out, spec + "ll" + conversion, (unsigned long long)arg.u);
+                break;
+            case 'c':
+                appendFormatted(out, spec + "c", (int)arg.i);
+                break;
+            case 'f':
+            case 'F':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A':
+                appendFormatted(out, spec + conversion, arg.d);
+                break;
+            case 's':
+                if (arg.type == LogArg::Type::STRING) {
+                    appendFormatted(out, spec + "s", arg.s.c_str());
+                } else if (arg.type == LogArg::Type::DOUBLE) {
+                    appendFormatted(out, spec + "g", arg.d);
+                } else {
+                    appendFormatted(out, spec + "lld", (long long)arg.i);
+                }
+                break;
+            case 'p':
+                appendFormatted(out, spec + "p", (void*)(uintptr_t)arg.u);
+                break;
+            default:
+                out.append(start, p - start);
+                break;
+        }
+    }
+    return out;
+}
+
+BinaryLogWriter::BinaryLogWriter() : file_(nullptr) {}
+
+BinaryLogWriter::~BinaryLogWriter() { close(); }
+
+bool BinaryLogWriter::open(const std::string& path) {
+    close();
+    file_ = fopen(path.c_str(), "wb");
+    if (!file_) {
+        return false;
+    }
+    // A large buffer, the file is flushed once per batch
+    setvbuf(file_, nullptr, _IOFBF, 64 * 1024);
+    fwrite(BINARY_LOG_MAGIC, 1, sizeof(BINARY_LOG_MAGIC), file_);
+    fwrite(&BINARY_LOG_VERSION, sizeof(BINARY_LOG_VERSION), 1, file_);
+    return true;
+}
+
+void BinaryLogWriter::close() {
+    if (file_) {
+        fclose(file_);
+        file_ = nullptr;
+    }
+    defined_.clear();
+}
+
+void BinaryLogWriter::define(const char* str) {
+    if (!defined_.insert(str).second) {
+        return;
+    }
+    uint64_t id = (uint64_t)(uintptr_t)str;
+    uint32_t length = (uint32_t)strlen(str);
+    fputc(BINARY_LOG_STRING_ENTRY, file_);
+    fwrite(&id, sizeof(id), 1, file_);
+    fwrite(&length, sizeof(length), 1, file_);
+    fwrite(str, 1, length, file_);
+}
+
+void BinaryLogWriter::write(const LogRingBuffer::Record& record) {
+    if (!file_) {
+        return;
+    }
+    const char* fmt = record.fmt;
+    const char* payload = record.message;
+    uint16_t size = record.size;
+    char text[LogRingBuffer::MESSAGE_SIZE + 8];
+    if (!fmt) {
+        LogArg arg;
+        arg.type = LogArg::Type::STRING;
+        arg.s = record.message;
+        fmt = TEXT_FORMAT;
+        size = (uint16_t)LogCapture::encodeArgs(&arg, 1, text, sizeof(text));
+        payload = text;
+    }
+    define(record.file);
+    define(fmt);
+    uint64_t file_id = (uint64_t)(uintptr_t)record.file;
+    uint64_t fmt_id = (uint64_t)(uintptr_t)fmt;
+    uint8_t level = (uint8_t)record.level;
+    int32_t line = record.line;
+    fputc(BINARY_LOG_RECORD_ENTRY, file_);
+    fwrite(&record.timestamp_ns, sizeof(record.timestamp_ns), 1, file_);
+    fwrite(&level, sizeof(level), 1, file_);
+    fwrite(&line, sizeof(line), 1, file_);
+    fwrite(&file_id, sizeof(file_id), 1, file_);
+    fwrite(&fmt_id, sizeof(fmt_id), 1, file_);
+    fwrite(&size, sizeof(size), 1, file_);
+    fwrite(payload, 1, size, file_);
+}
+
+void BinaryLogWriter::flush() {
+    if (file_) {
+        fflush(file_);
+    }
+}
+
+bool decodeBinaryLog(const std::string& path, LogHandler& handler) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    std::unique_ptr<FILE, int (*)(FILE*)> guard(file, fclose);
+    char magic[sizeof(BINARY_LOG_MAGIC)];
+    uint32_t version = 0;
+    if (fread(magic, 1, sizeof(magic), file) != sizeof(magic) || memcmp(magic, BINARY_LOG_MAGIC, sizeof(magic)) != 0 ||
+        fread(&version, sizeof(version), 1, file) != 1 || version != BINARY_LOG_VERSION) {
+        return false;
+    }
+    std::unordered_map<uint64_t, std::string> strings;
+    std::vector<char> payload;
+    int entry = 0;
+    while ((entry = fgetc(file)) != EOF) {
+        if (entry == BINARY_LOG_STRING_ENTRY) {
+            uint64_t id = 0;
+            uint32_t length = 0;
+            if (fread(&id, sizeof(id), 1, file) != 1 || fread(&length, sizeof(length), 1, file) != 1) {
+                return false;
+            }
+            std::string str(length, '\0');
+            if (length > 0 && fread(&str[0], 1, length, file) != length) {
+                return false;
+            }
+            strings[id] = std::move(str);
+        } else if (entry == BINARY_LOG_RECORD_ENTRY) {
+            int64_t timestamp_ns = 0;
+            uint8_t level = 0;
+            int32_t line = 0;
+            uint64_t file_id = 0;
+            uint64_t fmt_id = 0;
+            uint16_t size = 0;
+            if (fread(&timestamp_ns, sizeof(timestamp_ns), 1, file) != 1 || fread(&level, sizeof(level), 1, file) != 1 ||
+                fread(&line, sizeof(line), 1, file) != 1 || fread(&file_id, sizeof(file_id), 1, file) != 1 ||
+                fread(&fmt_id, sizeof(fmt_id), 1, file) != 1 || fread(&size, sizeof(size), 1, file) != 1) {
+                return false;
+            }
+            payload.resize(size);
+            if (size > 0 && fread(payload.data(), 1, size, file) != size) {
+                return false;
+            }
+            auto source = strings.find(file_id);
+            auto fmt = strings.find(fmt_id);
+            if (source == strings.end() || fmt == strings.end()) {
+                return false;
+            }
+            char time[32];
+            snprintf(time, sizeof(time), "[%lld.%06lld] ", (long long)(timestamp_ns / 1000000000),
+                     (long long)(timestamp_ns % 1000000000 / 1000));
+            std::string message = time + LogCapture::format(fmt->second.c_str(), payload.data(), size);
+            handler.log(source->second.c_str(), line, (LogLevel)level, message.c_str());
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace ELITE
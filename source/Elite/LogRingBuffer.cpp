@@ -0,0 +1,104 @@
+#include "LogRingBuffer.hpp"
+#include "LogCapture.hpp"
+
+#include <chrono>
+#include <cstdio>
+
+using namespace ELITE;
+
+static size_t roundUpPowerOfTwo(size_t value) {
+    size_t result = 2;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+LogRingBuffer::LogRingBuffer(size_t capacity) : enqueue_pos_(0), dequeue_pos_(0) {
+    size_t size = roundUpPowerOfTwo(capacity);
+    mask_ = size - 1;
+    cells_.reset(new Cell[size]);
+    for (size_t i = 0; i < size; i++) {
+        cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+static int64_t nowNanoseconds() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+LogRingBuffer::Cell* LogRingBuffer::claim(size_t& pos) {
+    Cell* cell = nullptr;
+    pos = enqueue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+        cell = &cells_[pos & mask_];
+        size_t seq = cell->sequence.load(std::memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+        if (diff == 0) {
+            if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // The consumer has not released this slot yet
+            return nullptr;
+        } else {
+            pos = enqueue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+    return cell;
+}
+
+bool LogRingBuffer::push(const char* file, int line, LogLevel level, const char* fmt, va_list args) {
+    size_t pos = 0;
+    Cell* cell = claim(pos);
+    if (!cell) {
+        return false;
+    }
+    cell->record.file = file;
+    cell->record.line = line;
+    cell->record.level = level;
+    cell->record.timestamp_ns = nowNanoseconds();
+    cell->record.fmt = nullptr;
+    cell->record.size = 0;
+    int characters = std::vsnprintf(cell->record.message, MESSAGE_SIZE, fmt, args);
+    if (characters >= (int)MESSAGE_SIZE) {
+        // Mark the truncation
+        cell->record.message[MESSAGE_SIZE - 4] = '.';
+        cell->record.message[MESSAGE_SIZE - 3] = '.';
+        cell->record.message[MESSAGE_SIZE - 2] = '.';
+    }
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool LogRingBuffer::pushCaptured(const char* file, int line, LogLevel level, const char* fmt, const LogArg* args, int count) {
+    size_t pos = 0;
+    Cell* cell = claim(pos);
+    if (!cell) {
+        return false;
+    }
+    cell->record.file = file;
+    cell->record.line = line;
+    cell->record.level = level;
+    cell->record.timestamp_ns = nowNanoseconds();
+    cell->record.fmt = fmt ? fmt : "";
+    cell->record.size = (uint16_t)LogCapture::encodeArgs(args, count, cell->record.message, MESSAGE_SIZE);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+const LogRingBuffer::Record* LogRingBuffer::front() {
+    size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    Cell* cell = &cells_[pos & mask_];
+    size_t seq = cell->sequence.load(std::memory_order_acquire);
+    if (seq != pos + 1) {
+        return nullptr;
+    }
+    return &cell->record;
+}
+
+void LogRingBuffer::pop() {
+    size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    cells_[pos & mask_].sequence.store(pos + mask_ + 1, std::memory_order_release);
+    dequeue_pos_.store(pos + 1, std::memory_order_release);
+}
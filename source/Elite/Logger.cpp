@@ -1,5 +1,9 @@
 #include "Logger.hpp"
 
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
 namespace ELITE{
 
 
@@ -9,4 +13,227 @@ Logger& getLogger() {
     return s_logger;
 }
 
+Logger::Logger()
+    : level_(LogLevel::ELI_INFO),
+      handler_(new DefaultLogHandler),
+      active_ring_(nullptr),
+      active_producers_(0),
+      dropped_(0),
+      worker_alive_(false),
+      worker_sleeping_(false) {}
+
+Logger::~Logger() {
+    disableAsync();
+}
+
+void Logger::dispatch(const char* file, int line, LogLevel level, const char* log) {
+    std::lock_guard<std::mutex> lock(handler_mutex_);
+    if (!handler_) {
+        handler_.reset(new DefaultLogHandler());
+    }
+    handler_->log(file, line, level, log);
+}
+
+void Logger::log(const char* file, int line, LogLevel level, const char* fmt, va_list args) {
+    // Announce the producer before reading the ring, disableAsync() waits for it. Both are sequentially consistent,
+    // so either the switch sees the producer or the producer sees the null ring.
+    active_producers_.fetch_add(1);
+    LogRingBuffer* ring = active_ring_.load();
+    if (ring) {
+        if (!ring->push(file, line, level, fmt, args)) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+        active_producers_.fetch_sub(1, std::memory_order_acq_rel);
+        if (worker_sleeping_.load(std::memory_order_acquire)) {
+            wake_cv_.notify_one();
+        }
+        return;
+    }
+    active_producers_.fetch_sub(1, std::memory_order_acq_rel);
+
+    // Most messages fit in the stack buffer
+    char stack_buffer[1024];
+    va_list args_copy;
+    va_copy(args_copy, args);
+    int characters = std::vsnprintf(stack_buffer, sizeof(stack_buffer), fmt, args);
+    if (characters >= (int)sizeof(stack_buffer)) {
+        std::unique_ptr<char[]> buffer(new char[characters + 1]);
+        std::vsnprintf(buffer.get(), characters + 1, fmt, args_copy);
+        dispatch(file, line, level, buffer.get());
+    } else {
+        dispatch(file, line, level, stack_buffer);
+    }
+    va_end(args_copy);
+    std::cout.flush();
+}
+
+void Logger::logCaptured(const char* file, int line, LogLevel level, const char* fmt, const LogArg* args, int count) {
+    active_producers_.fetch_add(1);
+    LogRingBuffer* ring = active_ring_.load();
+    if (ring) {
+        if (!ring->pushCaptured(file, line, level, fmt, args, count)) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+        active_producers_.fetch_sub(1, std::memory_order_acq_rel);
+        if (worker_sleeping_.load(std::memory_order_acquire)) {
+            wake_cv_.notify_one();
+        }
+        return;
+    }
+    active_producers_.fetch_sub(1, std::memory_order_acq_rel);
+
+    // Asynchronous mode was disabled after the caller checked it
+    char encoded[LogRingBuffer::MESSAGE_SIZE];
+    size_t size = LogCapture::encodeArgs(args, count, encoded, sizeof(encoded));
+    dispatch(file, line, level, LogCapture::format(fmt ? fmt : "", encoded, size).c_str());
+    std::cout.flush();
+}
+
+void Logger::drain(LogRingBuffer* ring) {
+    const LogRingBuffer::Record* record = nullptr;
+    while ((record = ring->front()) != nullptr) {
+        if (binary_writer_) {
+            binary_writer_->write(*record);
+        } else if (record->fmt) {
+            dispatch(record->file, record->line, record->level,
+                     LogCapture::format(record->fmt, record->message, record->size).c_str());
+        } else {
+            dispatch(record->file, record->line, record->level, record->message);
+        }
+        ring->pop();
+    }
+}
+
+void Logger::workerLoop(LogRingBuffer* ring) {
+    uint64_t reported_dropped = dropped_;
+    while (worker_alive_) {
+        if (ring->front() != nullptr) {
+            drain(ring);
+            uint64_t dropped = dropped_;
+            if (dropped != reported_dropped) {
+                char message[128];
+                std::snprintf(message, sizeof(message), "%llu log messages dropped, the log ring is full",
+                              (unsigned long long)(dropped - reported_dropped));
+                dispatch(__FILE__, __LINE__, LogLevel::ELI_WARN, message);
+                reported_dropped = dropped;
+            }
+            // One flush per batch instead of one per line
+            if (binary_writer_) {
+                binary_writer_->flush();
+            }
+            std::cout.flush();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        worker_sleeping_ = true;
+        // Check again, a producer may have pushed before the flag was set.
+        if (ring->front() == nullptr && worker_alive_) {
+            wake_cv_.wait_for(lock, std::chrono::milliseconds(100));
+        }
+        worker_sleeping_ = false;
+    }
+}
+
+void Logger::stopWorker() {
+    if (worker_) {
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            worker_alive_ = false;
+        }
+        wake_cv_.notify_one();
+        if (worker_->joinable()) {
+            worker_->join();
+        }
+        worker_.reset();
+    }
+}
+
+void Logger::startAsync(size_t capacity) {
+    if (ring_ && ring_->capacity() >= capacity && active_ring_.load() == ring_.get()) {
+        return;
+    }
+    // Switch the producers back to synchronous mode while the ring is replaced.
+    active_ring_ = nullptr;
+    while (active_producers_.load() != 0) {
+        std::this_thread::yield();
+    }
+    stopWorker();
+    if (ring_) {
+        drain(ring_.get());
+        // No producer holds the pointer after the wait above, a smaller ring can be freed.
+        if (ring_->capacity() < capacity) {
+            ring_.reset();
+        }
+    }
+    if (!ring_) {
+        ring_.reset(new LogRingBuffer(capacity));
+    }
+    worker_alive_ = true;
+    LogRingBuffer* ring = ring_.get();
+    worker_.reset(new std::thread([this, ring]() { workerLoop(ring); }));
+    active_ring_ = ring;
+}
+
+void Logger::stopAsync() {
+    if (!ring_) {
+        return;
+    }
+    active_ring_ = nullptr;
+    while (active_producers_.load() != 0) {
+        std::this_thread::yield();
+    }
+    stopWorker();
+    drain(ring_.get());
+    if (binary_writer_) {
+        binary_writer_->flush();
+    }
+    std::cout.flush();
+}
+
+void Logger::enableAsync(size_t capacity) {
+    std::lock_guard<std::mutex> lock(async_mutex_);
+    startAsync(capacity);
+}
+
+void Logger::disableAsync() {
+    std::lock_guard<std::mutex> lock(async_mutex_);
+    stopAsync();
+}
+
+bool Logger::enableBinary(const std::string& path, size_t capacity) {
+    std::lock_guard<std::mutex> lock(async_mutex_);
+    // The worker reads the writer, stop it before the writer is replaced
+    stopAsync();
+    std::unique_ptr<BinaryLogWriter> writer(new BinaryLogWriter);
+    if (!writer->open(path)) {
+        binary_writer_.reset();
+        return false;
+    }
+    binary_writer_ = std::move(writer);
+    startAsync(capacity);
+    return true;
+}
+
+void Logger::disableBinary() {
+    std::lock_guard<std::mutex> lock(async_mutex_);
+    if (!binary_writer_) {
+        return;
+    }
+    stopAsync();
+    binary_writer_.reset();
+}
+
+void Logger::flush() {
+    LogRingBuffer* ring = active_ring_.load();
+    if (!ring) {
+        std::cout.flush();
+        return;
+    }
+    while (!ring->empty() && worker_alive_) {
+        wake_cv_.notify_one();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::cout.flush();
+}
+
 }
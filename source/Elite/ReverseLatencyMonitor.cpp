@@ -0,0 +1,116 @@
+#include "ReverseLatencyMonitor.hpp"
+#include "LatencyBuckets.hpp"
+
+#include <algorithm>
+#include <climits>
+
+using namespace ELITE;
+using namespace std::chrono;
+
+constexpr std::array<int, 10> LatencyHistogram::BUCKETS_US;
+
+microseconds LatencyHistogram::percentile(double fraction) const {
+    return latencyPercentile(BUCKETS_US, counts, samples, fraction, max);
+}
+
+namespace {
+
+void addSample(LatencyHistogram& histogram, int64_t& sum, int64_t value_us) {
+    value_us = std::max<int64_t>(value_us, 0);
+    microseconds value(value_us);
+    histogram.counts[latencyBucket(LatencyHistogram::BUCKETS_US, value_us)]++;
+    histogram.last = value;
+    histogram.min = histogram.samples == 0 ? value : std::min(histogram.min, value);
+    histogram.max = std::max(histogram.max, value);
+    histogram.samples++;
+    sum += value_us;
+    histogram.mean = microseconds(sum / (int64_t)histogram.samples);
+}
+
+// Append to a sliding window minimum over the last window entries
+void pushMinimum(std::deque<std::pair<uint64_t, int64_t>>& minimum, uint64_t index, int64_t value, size_t window) {
+    while (!minimum.empty() && minimum.back().second >= value) {
+        minimum.pop_back();
+    }
+    minimum.emplace_back(index, value);
+    while (minimum.front().first + window <= index) {
+        minimum.pop_front();
+    }
+}
+
+}  // namespace
+
+ReverseLatencyMonitor::ReverseLatencyMonitor(size_t window)
+    : window_(std::max<size_t>(window, 1)), send_times_(SEND_RING_SIZE) {}
+
+int32_t ReverseLatencyMonitor::onSend(steady_clock::time_point now) {
+    if (!has_origin_) {
+        origin_ = now;
+        has_origin_ = true;
+    }
+    int32_t sequence = next_sequence_;
+    SentFrame& frame = send_times_[(uint32_t)sequence % SEND_RING_SIZE];
+    frame.sequence = sequence;
+    frame.time = now;
+    next_sequence_ = (next_sequence_ == INT32_MAX) ? 1 : next_sequence_ + 1;
+    statistics_.sent++;
+    return sequence;
+}
+
+void ReverseLatencyMonitor::onEcho(int32_t sequence, int32_t cycle, int32_t step_time_us, steady_clock::time_point now) {
+    if (sequence <= 0 || !has_origin_) {
+        return;
+    }
+    statistics_.echoed++;
+    statistics_.step_time = microseconds(step_time_us);
+    if (last_echo_sequence_ > 0 && sequence > last_echo_sequence_) {
+        statistics_.lost += sequence - last_echo_sequence_ - 1;
+        if (sequence == last_echo_sequence_ + 1) {
+            if (cycle == last_echo_cycle_) {
+                statistics_.skipped++;
+            } else if (cycle > last_echo_cycle_ + 1) {
+                statistics_.missed_cycles += cycle - last_echo_cycle_ - 1;
+            }
+        }
+    }
+    last_echo_sequence_ = sequence;
+    last_echo_cycle_ = cycle;
+
+    // Frames older than the ring have no send time any more
+    const SentFrame& frame = send_times_[(uint32_t)sequence % SEND_RING_SIZE];
+    if (frame.sequence != sequence) {
+        return;
+    }
+    int64_t sent_us = duration_cast<microseconds>(frame.time - origin_).count();
+    int64_t received_us = duration_cast<microseconds>(now - origin_).count();
+    addSample(statistics_.round_trip, round_trip_sum_, received_us - sent_us);
+
+    // The frame was read somewhere in the cycle, take its middle
+    int64_t controller_us = (int64_t)cycle * step_time_us + step_time_us / 2;
+    int64_t forward = controller_us - sent_us;
+    int64_t backward = received_us - controller_us;
+    pushMinimum(min_forward_, echo_index_, forward, window_);
+    pushMinimum(min_backward_, echo_index_, backward, window_);
+    echo_index_++;
+    int64_t offset = (min_forward_.front().second - min_backward_.front().second) / 2;
+    statistics_.clock_offset = microseconds(offset);
+    addSample(statistics_.uplink, uplink_sum_, forward - offset);
+    addSample(statistics_.downlink, downlink_sum_, backward + offset);
+}
+
+void ReverseLatencyMonitor::restart() {
+    last_echo_sequence_ = 0;
+    last_echo_cycle_ = 0;
+    min_forward_.clear();
+    min_backward_.clear();
+}
+
+void ReverseLatencyMonitor::reset() {
+    restart();
+    round_trip_sum_ = 0;
+    uplink_sum_ = 0;
+    downlink_sum_ = 0;
+    statistics_ = ReverseLatencyStatistics();
+}
+
+ReverseLatencyStatistics ReverseLatencyMonitor::getStatistics() const { return statistics_; }
@@ -0,0 +1,134 @@
+#include "RobotStateBus.hpp"
+#include "EliteException.hpp"
+#include "Log.hpp"
+
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+
+#include <atomic>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <type_traits>
+
+using namespace ELITE;
+namespace bip = boost::interprocess;
+
+static_assert(std::is_trivially_copyable<RobotStateSnapshot>::value, "RobotStateSnapshot is copied with memcpy");
+
+namespace {
+
+// "ELSB"
+constexpr uint32_t SEGMENT_MAGIC = 0x42534C45;
+constexpr uint32_t SEGMENT_VERSION = 1;
+// A read is retried while the writer is in the middle of a publish. The writer holds the sequence odd for one
+// memcpy only, so running out of retries means the publisher died while writing.
+constexpr int MAX_READ_RETRIES = 1000;
+
+struct StateSegment {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t snapshot_size;
+    uint32_t reserved;
+    // Odd while the writer is copying the snapshot, incremented by 2 every publish
+    std::atomic<uint64_t> sequence;
+    RobotStateSnapshot snapshot;
+};
+
+}  // namespace
+
+class RobotStatePublisher::Impl {
+   public:
+    std::string name_;
+    bip::shared_memory_object shm_;
+    bip::mapped_region region_;
+    StateSegment* segment_ = nullptr;
+};
+
+RobotStatePublisher::RobotStatePublisher(const std::string& name) : impl_(new Impl) {
+    impl_->name_ = name;
+    try {
+        bip::shared_memory_object::remove(name.c_str());
+        impl_->shm_ = bip::shared_memory_object(bip::create_only, name.c_str(), bip::read_write);
+        impl_->shm_.truncate(sizeof(StateSegment));
+        impl_->region_ = bip::mapped_region(impl_->shm_, bip::read_write);
+    } catch (const bip::interprocess_exception& e) {
+        throw EliteException(EliteException::Code::SHARED_MEMORY_FAIL, "create '" + name + "': " + e.what());
+    }
+    void* addr = impl_->region_.get_address();
+    std::memset(addr, 0, sizeof(StateSegment));
+    impl_->segment_ = new (addr) StateSegment;
+    impl_->segment_->version = SEGMENT_VERSION;
+    impl_->segment_->snapshot_size = sizeof(RobotStateSnapshot);
+    impl_->segment_->sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    impl_->segment_->magic = SEGMENT_MAGIC;
+    ELITE_LOG_INFO("Robot state bus '%s' created", name.c_str());
+}
+
+RobotStatePublisher::~RobotStatePublisher() { bip::shared_memory_object::remove(impl_->name_.c_str()); }
+
+void RobotStatePublisher::publish(const RobotStateSnapshot& snapshot) {
+    StateSegment* segment = impl_->segment_;
+    uint64_t seq = segment->sequence.load(std::memory_order_relaxed);
+    segment->sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(&segment->snapshot, &snapshot, sizeof(RobotStateSnapshot));
+    segment->sequence.store(seq + 2, std::memory_order_release);
+}
+
+uint64_t RobotStatePublisher::getSequence() { return impl_->segment_->sequence.load(std::memory_order_relaxed) / 2; }
+
+const std::string& RobotStatePublisher::getName() { return impl_->name_; }
+
+class RobotStateReader::Impl {
+   public:
+    bip::shared_memory_object shm_;
+    bip::mapped_region region_;
+    const StateSegment* segment_ = nullptr;
+    LogThrottle retry_log_throttle_;
+};
+
+RobotStateReader::RobotStateReader(const std::string& name) : impl_(new Impl) {
+    try {
+        impl_->shm_ = bip::shared_memory_object(bip::open_only, name.c_str(), bip::read_only);
+        impl_->region_ = bip::mapped_region(impl_->shm_, bip::read_only);
+    } catch (const bip::interprocess_exception& e) {
+        throw EliteException(EliteException::Code::SHARED_MEMORY_FAIL, "open '" + name + "': " + e.what());
+    }
+    if (impl_->region_.get_size() < sizeof(StateSegment)) {
+        throw EliteException(EliteException::Code::SHARED_MEMORY_FAIL, "'" + name + "' is too small");
+    }
+    impl_->segment_ = static_cast<const StateSegment*>(impl_->region_.get_address());
+    if (impl_->segment_->magic != SEGMENT_MAGIC || impl_->segment_->version != SEGMENT_VERSION ||
+        impl_->segment_->snapshot_size != sizeof(RobotStateSnapshot)) {
+        throw EliteException(EliteException::Code::SHARED_MEMORY_FAIL,
+                             "'" + name + "' is not a robot state bus of this SDK version");
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+}
+
+RobotStateReader::~RobotStateReader() = default;
+
+bool RobotStateReader::read(RobotStateSnapshot& snapshot) {
+    const StateSegment* segment = impl_->segment_;
+    for (int i = 0; i < MAX_READ_RETRIES; i++) {
+        uint64_t begin = segment->sequence.load(std::memory_order_acquire);
+        if (begin == 0) {
+            return false;
+        }
+        if (begin & 1) {
+            std::this_thread::yield();
+            continue;
+        }
+        std::memcpy(&snapshot, &segment->snapshot, sizeof(RobotStateSnapshot));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (segment->sequence.load(std::memory_order_relaxed) == begin) {
+            return true;
+        }
+    }
+    ELITE_LOG_WARN_THROTTLE(impl_->retry_log_throttle_, 1000, "Robot state bus read retried %d times, the publisher may have died", MAX_READ_RETRIES);
+    return false;
+}
+
+uint64_t RobotStateReader::getSequence() { return impl_->segment_->sequence.load(std::memory_order_acquire) / 2; }
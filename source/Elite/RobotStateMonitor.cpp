@@ -0,0 +1,150 @@
+#include "RobotStateMonitor.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+
+using namespace ELITE;
+using namespace std::chrono;
+
+class RobotStateMonitor::Impl {
+   public:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    RobotMode robot_mode_ = RobotMode::UNKNOWN;
+    SafetyMode safety_mode_ = SafetyMode::UNKNOWN;
+    TaskStatus task_status_ = TaskStatus::UNKNOWN;
+    bool ever_updated_ = false;
+    steady_clock::time_point last_update_;
+    milliseconds stale_timeout_{DEFAULT_STALE_TIMEOUT_MS};
+    // The listeners are called under their own mutex, so they may read the states
+    std::mutex listener_mutex_;
+    std::map<int, std::function<void()>> listeners_;
+    int next_listener_id_ = 0;
+
+    void touch() {
+        ever_updated_ = true;
+        last_update_ = steady_clock::now();
+    }
+
+    // Called after every update, with mutex_ unlocked
+    void notify() {
+        cv_.notify_all();
+        std::lock_guard<std::mutex> lock(listener_mutex_);
+        for (auto& listener : listeners_) {
+            listener.second();
+        }
+    }
+
+    // mutex_ must be locked
+    bool isUpdating() const { return ever_updated_ && (steady_clock::now() - last_update_) < stale_timeout_; }
+
+    bool waitFor(const std::function<bool()>& reached, int timeout_ms) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto deadline = steady_clock::now() + milliseconds(timeout_ms);
+        while (!reached()) {
+            auto now = steady_clock::now();
+            if (now >= deadline || !isUpdating()) {
+                return false;
+            }
+            // Wake up at least once per stale timeout to check whether the data stream is still alive.
+            cv_.wait_until(lock, std::min(deadline, now + stale_timeout_));
+        }
+        return true;
+    }
+};
+
+RobotStateMonitor::RobotStateMonitor() { impl_ = std::make_unique<Impl>(); }
+
+RobotStateMonitor::~RobotStateMonitor() = default;
+
+void RobotStateMonitor::updateRobotMode(RobotMode mode) {
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex_);
+        impl_->robot_mode_ = mode;
+        impl_->touch();
+    }
+    impl_->notify();
+}
+
+void RobotStateMonitor::updateSafetyMode(SafetyMode mode) {
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex_);
+        impl_->safety_mode_ = mode;
+        impl_->touch();
+    }
+    impl_->notify();
+}
+
+void RobotStateMonitor::updateTaskStatus(TaskStatus status) {
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex_);
+        impl_->task_status_ = status;
+        impl_->touch();
+    }
+    impl_->notify();
+}
+
+void RobotStateMonitor::update(RobotMode robot_mode, SafetyMode safety_mode, TaskStatus task_status) {
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex_);
+        impl_->robot_mode_ = robot_mode;
+        impl_->safety_mode_ = safety_mode;
+        impl_->task_status_ = task_status;
+        impl_->touch();
+    }
+    impl_->notify();
+}
+
+bool RobotStateMonitor::waitRobotMode(const std::vector<RobotMode>& modes, int timeout_ms) {
+    return impl_->waitFor(
+        [&]() { return std::find(modes.begin(), modes.end(), impl_->robot_mode_) != modes.end(); }, timeout_ms);
+}
+
+bool RobotStateMonitor::waitSafetyMode(SafetyMode mode, int timeout_ms) {
+    return impl_->waitFor([&]() { return impl_->safety_mode_ == mode; }, timeout_ms);
+}
+
+bool RobotStateMonitor::waitTaskStatus(TaskStatus status, int timeout_ms) {
+    return impl_->waitFor([&]() { return impl_->task_status_ == status; }, timeout_ms);
+}
+
+int RobotStateMonitor::addListener(std::function<void()> listener) {
+    std::lock_guard<std::mutex> lock(impl_->listener_mutex_);
+    int id = impl_->next_listener_id_++;
+    impl_->listeners_[id] = std::move(listener);
+    return id;
+}
+
+void RobotStateMonitor::removeListener(int id) {
+    std::lock_guard<std::mutex> lock(impl_->listener_mutex_);
+    impl_->listeners_.erase(id);
+}
+
+bool RobotStateMonitor::isUpdating() {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    return impl_->isUpdating();
+}
+
+void RobotStateMonitor::setStaleTimeout(int timeout_ms) {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    impl_->stale_timeout_ = milliseconds(timeout_ms);
+}
+
+RobotMode RobotStateMonitor::getRobotMode() {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    return impl_->robot_mode_;
+}
+
+SafetyMode RobotStateMonitor::getSafetyMode() {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    return impl_->safety_mode_;
+}
+
+TaskStatus RobotStateMonitor::getTaskStatus() {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    return impl_->task_status_;
+}
@@ -0,0 +1,317 @@
+#include "ServoInterpolator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <mutex>
+
+using namespace ELITE;
+
+namespace {
+
+struct Knot {
+    double time;
+    vector6d_t positions;
+};
+
+// Position, velocity and acceleration of all joints
+struct State {
+    vector6d_t p{};
+    vector6d_t v{};
+    vector6d_t a{};
+};
+
+// A polynomial per joint from start over duration, c[j][k] the coefficient of t^k
+struct Segment {
+    double start = 0;
+    double duration = 0;
+    double c[6][6] = {};
+
+    void plan(ServoSplineType type, const State& from, const State& to, double start_time, double length) {
+        start = start_time;
+        duration = length;
+        double t = length, t2 = t * t, t3 = t2 * t;
+        for (int j = 0; j < 6; j++) {
+            double dp = to.p[j] - from.p[j];
+            double* k = c[j];
+            k[0] = from.p[j];
+            k[1] = from.v[j];
+            if (type == ServoSplineType::QUINTIC) {
+                k[2] = from.a[j] / 2;
+                k[3] = (20 * dp - (8 * to.v[j] + 12 * from.v[j]) * t - (3 * from.a[j] - to.a[j]) * t2) / (2 * t3);
+                k[4] = (-30 * dp + (14 * to.v[j] + 16 * from.v[j]) * t + (3 * from.a[j] - 2 * to.a[j]) * t2) / (2 * t3 * t);
+                k[5] = (12 * dp - 6 * (to.v[j] + from.v[j]) * t + (to.a[j] - from.a[j]) * t2) / (2 * t3 * t2);
+            } else {
+                k[2] = (3 * dp - (2 * from.v[j] + to.v[j]) * t) / t2;
+                k[3] = (-2 * dp + (from.v[j] + to.v[j]) * t) / t3;
+                k[4] = 0;
+                k[5] = 0;
+            }
+        }
+    }
+
+    State evaluate(double time) const {
+        double t = std::min(std::max(time - start, 0.0), duration);
+        State s;
+        for (int j = 0; j < 6; j++) {
+            const double* k = c[j];
+            s.p[j] = k[0] + t * (k[1] + t * (k[2] + t * (k[3] + t * (k[4] + t * k[5]))));
+            s.v[j] = k[1] + t * (2 * k[2] + t * (3 * k[3] + t * (4 * k[4] + t * 5 * k[5])));
+            s.a[j] = 2 * k[2] + t * (6 * k[3] + t * (12 * k[4] + t * 20 * k[5]));
+        }
+        return s;
+    }
+};
+
+// Finite difference weights at 0 for the values at the nodes, derivatives 0 to 2 (Fornberg)
+void derivativeWeights(const double* nodes, int count, double weights[][3]) {
+    for (int i = 0; i < count; i++) {
+        weights[i][0] = weights[i][1] = weights[i][2] = 0;
+    }
+    weights[0][0] = 1;
+    double c1 = 1, c4 = nodes[0];
+    for (int i = 1; i < count; i++) {
+        int order = std::min(i, 2);
+        double c2 = 1, c5 = c4;
+        c4 = nodes[i];
+        for (int j = 0; j < i; j++) {
+            double c3 = nodes[i] - nodes[j];
+            c2 *= c3;
+            if (j == i - 1) {
+                for (int k = order; k > 0; k--) {
+                    weights[i][k] = c1 * (k * weights[i - 1][k - 1] - c5 * weights[i - 1][k]) / c2;
+                }
+                weights[i][0] = -c1 * c5 * weights[i - 1][0] / c2;
+            }
+            for (int k = order; k > 0; k--) {
+                weights[j][k] = (c4 * weights[j][k] - k * weights[j][k - 1]) / c3;
+            }
+            weights[j][0] = c4 * weights[j][0] / c3;
+        }
+        c1 = c2;
+    }
+}
+
+double distance(const vector6d_t& a, const vector6d_t& b) {
+    double sum = 0;
+    for (int j = 0; j < 6; j++) {
+        sum += (a[j] - b[j]) * (a[j] - b[j]);
+    }
+    return std::sqrt(sum);
+}
+
+}  // namespace
+
+class ServoInterpolator::Impl {
+   public:
+    explicit Impl(const ServoInterpolatorOptions& options) : options_(options) {}
+
+    ServoInterpolatorOptions options_;
+    std::mutex mutex_;
+    bool started_ = false;
+    // Waypoints from two before the target on; knots_[0] has the sequence number first_
+    std::deque<Knot> knots_;
+    size_t first_ = 0;
+    // Sequence number of the waypoint the segment runs to
+    size_t target_ = 0;
+    // Running a segment, otherwise predicting past the last waypoint from prediction_
+    bool in_segment_ = false;
+    Segment segment_;
+    Knot prediction_;
+    vector6d_t prediction_velocity_{};
+    // The last setpoint, at sample time last_time_ (clock time + latency)
+    State state_;
+    double last_time_ = 0;
+    double clock_ = 0;
+    ServoInterpolatorMetrics metrics_;
+    double jerk_square_sum_ = 0;
+
+    const Knot& knot(size_t sequence) const { return knots_[sequence - first_]; }
+    size_t end() const { return first_ + knots_.size(); }
+
+    // Velocity and acceleration of a waypoint, from the polynomial through it and up to two waypoints on each side
+    State knotState(size_t sequence) const {
+        size_t from = std::max(first_, sequence >= 2 ? sequence - 2 : 0);
+        size_t to = std::min(end(), sequence + 3);
+        double nodes[5];
+        int count = 0;
+        for (size_t i = from; i < to; i++) {
+            nodes[count++] = knot(i).time - knot(sequence).time;
+        }
+        double weights[5][3];
+        derivativeWeights(nodes, count, weights);
+        State s;
+        s.p = knot(sequence).positions;
+        for (int j = 0; j < 6; j++) {
+            for (int i = 0; i < count; i++) {
+                s.v[j] += weights[i][1] * knot(from + i).positions[j];
+                s.a[j] += weights[i][2] * knot(from + i).positions[j];
+            }
+        }
+        return s;
+    }
+
+    // Plan from the current setpoint to the target waypoint, over at least min_length
+    void planToTarget(double min_length) {
+        const Knot& k = knot(target_);
+        double length = std::max(k.time - last_time_, min_length);
+        segment_.plan(options_.spline, state_, knotState(target_), last_time_, length);
+        in_segment_ = true;
+    }
+
+    void predictFrom(const Knot& k, const vector6d_t& velocity) {
+        prediction_ = k;
+        prediction_velocity_ = velocity;
+        in_segment_ = false;
+    }
+
+    // The setpoint state at a sample time
+    State advance(double time) {
+        while (in_segment_ && time > segment_.start + segment_.duration) {
+            State reached = segment_.evaluate(segment_.start + segment_.duration);
+            double reached_time = segment_.start + segment_.duration;
+            if (target_ + 1 < end()) {
+                State from = reached;
+                target_++;
+                const Knot& k = knot(target_);
+                segment_.plan(options_.spline, from, knotState(target_), reached_time,
+                              std::max(k.time - reached_time, options_.period));
+            } else {
+                predictFrom({reached_time, reached.p}, reached.v);
+            }
+        }
+        if (in_segment_) {
+            return segment_.evaluate(time);
+        }
+        State s;
+        double ahead = time - prediction_.time;
+        bool moving = ahead < options_.max_prediction;
+        ahead = std::min(ahead, options_.max_prediction);
+        for (int j = 0; j < 6; j++) {
+            s.p[j] = prediction_.positions[j] + prediction_velocity_[j] * ahead;
+            s.v[j] = moving ? prediction_velocity_[j] : 0;
+        }
+        if (ahead > 0) {
+            metrics_.predicted++;
+        }
+        return s;
+    }
+
+    void record(const State& s, double time) {
+        if (metrics_.samples > 0 && time > last_time_) {
+            double sum = 0;
+            for (int j = 0; j < 6; j++) {
+                double jerk = (s.a[j] - state_.a[j]) / (time - last_time_);
+                sum += jerk * jerk;
+            }
+            metrics_.max_jerk = std::max(metrics_.max_jerk, std::sqrt(sum));
+            jerk_square_sum_ += sum;
+            metrics_.rms_jerk = std::sqrt(jerk_square_sum_ / metrics_.samples);
+        }
+        metrics_.samples++;
+        state_ = s;
+        last_time_ = time;
+    }
+
+    // Keep two waypoints before the target for the estimates
+    void trim() {
+        while (first_ + 2 < target_ && knots_.size() > 3) {
+            knots_.pop_front();
+            first_++;
+        }
+    }
+};
+
+ServoInterpolator::ServoInterpolator(const ServoInterpolatorOptions& options) : impl_(new Impl(options)) {}
+
+ServoInterpolator::~ServoInterpolator() = default;
+
+void ServoInterpolator::reset(const vector6d_t& positions, double time) {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    impl_->knots_.clear();
+    impl_->knots_.push_back({time, positions});
+    impl_->first_ = 0;
+    impl_->target_ = 0;
+    impl_->state_ = State();
+    impl_->state_.p = positions;
+    impl_->last_time_ = time;
+    impl_->clock_ = time;
+    impl_->predictFrom({time, positions}, vector6d_t{});
+    impl_->started_ = true;
+    impl_->metrics_ = ServoInterpolatorMetrics();
+    impl_->jerk_square_sum_ = 0;
+}
+
+bool ServoInterpolator::addWaypoint(double time, const vector6d_t& positions) {
+    std::unique_lock<std::mutex> lock(impl_->mutex_);
+    if (!impl_->started_) {
+        lock.unlock();
+        reset(positions, time);
+        return true;
+    }
+    Impl& d = *impl_;
+    if (time <= d.knots_.back().time) {
+        return false;
+    }
+    d.knots_.push_back({time, positions});
+    if (!d.in_segment_) {
+        // Predicting past the previous waypoint: how far off is the prediction, if it was used, then head for the new
+        // one. A waypoint that comes late is reached one period from now.
+        if (d.last_time_ > d.prediction_.time) {
+            double ahead = std::min(time - d.prediction_.time, d.options_.max_prediction);
+            vector6d_t predicted;
+            for (int j = 0; j < 6; j++) {
+                predicted[j] = d.prediction_.positions[j] + d.prediction_velocity_[j] * ahead;
+            }
+            d.metrics_.last_deviation = distance(predicted, positions);
+            d.metrics_.max_deviation = std::max(d.metrics_.max_deviation, d.metrics_.last_deviation);
+        }
+        d.target_ = d.end() - 1;
+        d.planToTarget(d.options_.period);
+    } else if (d.target_ + 3 >= d.end() && d.segment_.start + d.segment_.duration - d.last_time_ > d.options_.period / 2) {
+        // The estimate of the target improves with the waypoints after it
+        d.planToTarget(0);
+    }
+    d.trim();
+    return true;
+}
+
+bool ServoInterpolator::sample(double time, vector6d_t& setpoint) {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    Impl& d = *impl_;
+    if (!d.started_) {
+        return false;
+    }
+    d.clock_ = std::max(d.clock_, time);
+    double ahead = std::max(d.clock_ + d.options_.latency, d.last_time_);
+    State s = d.advance(ahead);
+    d.record(s, ahead);
+    d.trim();
+    setpoint = s.p;
+    return true;
+}
+
+bool ServoInterpolator::next(vector6d_t& setpoint) {
+    double time;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex_);
+        time = impl_->clock_ + impl_->options_.period;
+    }
+    return sample(time, setpoint);
+}
+
+void ServoInterpolator::setLatency(double latency) {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    impl_->options_.latency = std::max(0.0, latency);
+}
+
+ServoInterpolatorMetrics ServoInterpolator::getMetrics() {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    return impl_->metrics_;
+}
+
+void ServoInterpolator::resetMetrics() {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    impl_->metrics_ = ServoInterpolatorMetrics();
+    impl_->jerk_square_sum_ = 0;
+}
@@ -0,0 +1,255 @@
+#include "TimeParameterization.hpp"
+#include "EliteException.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace ELITE;
+
+namespace {
+
+// Linear bounds on the path acceleration u at a grid point, for a given x = (ds/dt)^2:
+// lower[k][0] + lower[k][1] * x <= u <= upper[k][0] + upper[k][1] * x
+struct Bounds {
+    double lower[7][2];
+    double upper[7][2];
+    int count = 0;
+    // Limit on x from joints that only see the curvature term
+    double x_max;
+};
+
+// Joint j accelerates by dq[j] * u + ddq[j] * x. The step to the next grid point must end within [0, next_max].
+Bounds accelerationBounds(const double* dq, const double* ddq, const vector6d_t& acc, double step, double next_max,
+                          double x_max) {
+    Bounds bounds;
+    bounds.x_max = x_max;
+    for (int j = 0; j < 6; j++) {
+        double p = dq[j], q = ddq[j];
+        if (std::fabs(p) > 1e-12) {
+            double lo = -acc[j] / p, hi = acc[j] / p;
+            if (p < 0) {
+                std::swap(lo, hi);
+            }
+            bounds.lower[bounds.count][0] = lo;
+            bounds.lower[bounds.count][1] = -q / p;
+            bounds.upper[bounds.count][0] = hi;
+            bounds.upper[bounds.count][1] = -q / p;
+            bounds.count++;
+        } else if (q != 0) {
+            bounds.x_max = std::min(bounds.x_max, acc[j] / std::fabs(q));
+        }
+    }
+    // x_next = x + 2 * step * u
+    bounds.lower[bounds.count][0] = 0;
+    bounds.lower[bounds.count][1] = -1 / (2 * step);
+    bounds.upper[bounds.count][0] = next_max / (2 * step);
+    bounds.upper[bounds.count][1] = -1 / (2 * step);
+    bounds.count++;
+    return bounds;
+}
+
+// The largest x for which some u satisfies all bounds. x = 0 always does, with u = 0.
+double maxFeasibleX(const Bounds& bounds) {
+    double x = bounds.x_max;
+    for (int k = 0; k < bounds.count; k++) {
+        for (int m = 0; m < bounds.count; m++) {
+            double slope = bounds.lower[k][1] - bounds.upper[m][1];
+            if (slope > 0) {
+                x = std::min(x, (bounds.upper[m][0] - bounds.lower[k][0]) / slope);
+            }
+        }
+    }
+    return std::max(0.0, x);
+}
+
+double maxAcceleration(const Bounds& bounds, double x) {
+    double u = std::numeric_limits<double>::infinity();
+    for (int k = 0; k < bounds.count; k++) {
+        u = std::min(u, bounds.upper[k][0] + bounds.upper[k][1] * x);
+    }
+    return u;
+}
+
+}  // namespace
+
+// The solved motion on the grid
+struct TimeParameterization::Profile {
+    // Path length at every grid point
+    std::vector<double> s;
+    // (ds/dt)^2 at every grid point
+    std::vector<double> x;
+    // Time from the previous grid point
+    std::vector<double> dt;
+    // Path length at every input point, and its grid point
+    std::vector<double> point_s;
+    std::vector<size_t> point_grid;
+};
+
+TimeParameterization::TimeParameterization(const vector6d_t& max_velocity, const vector6d_t& max_acc,
+                                           const TimeParameterizationOptions& options)
+    : options_(options) {
+    for (int j = 0; j < 6; j++) {
+        if (!(max_velocity[j] > 0) || !(max_acc[j] > 0)) {
+            throw EliteException(EliteException::Code::ILLEGAL_PARAM, "joint limits must be positive");
+        }
+        max_velocity_[j] = max_velocity[j] * options.velocity_scale;
+        max_acc_[j] = max_acc[j] * options.acc_scale;
+    }
+    if (!(options.max_step > 0) || !(options.velocity_scale > 0) || !(options.acc_scale > 0)) {
+        throw EliteException(EliteException::Code::ILLEGAL_PARAM, "time parameterization options must be positive");
+    }
+}
+
+TimeParameterization::TimeParameterization(const JointLimitsInfo& info, const TimeParameterizationOptions& options)
+    : TimeParameterization(info.max_velocity_, info.max_acc_, options) {}
+
+void TimeParameterization::solve(const Vector6dBatch& path, Profile& profile) const {
+    size_t count = path.size();
+    profile.point_s.assign(count, 0);
+    profile.point_grid.assign(count, 0);
+    profile.s.assign(1, 0);
+    if (count == 0) {
+        profile.x.assign(1, 0);
+        profile.dt.assign(1, 0);
+        return;
+    }
+
+    // Segment lengths; a path of one segment gets two steps, so it can speed up and slow down
+    std::vector<double> lengths(count, 0);
+    size_t segments = 0;
+    for (size_t i = 1; i < count; i++) {
+        double sum = 0;
+        for (int j = 0; j < 6; j++) {
+            double d = path.values[j][i] - path.values[j][i - 1];
+            sum += d * d;
+        }
+        lengths[i] = std::sqrt(sum);
+        segments += lengths[i] > 0;
+    }
+    // The grid, and the input segment of the step that ends at each grid point
+    std::vector<size_t> step_segment(1, 0);
+    for (size_t i = 1; i < count; i++) {
+        profile.point_s[i] = profile.point_s[i - 1] + lengths[i];
+        if (lengths[i] > 0) {
+            size_t pieces = std::max<size_t>(segments == 1 ? 2 : 1, (size_t)std::ceil(lengths[i] / options_.max_step));
+            for (size_t p = 1; p <= pieces; p++) {
+                profile.s.push_back(p == pieces ? profile.point_s[i] : profile.point_s[i - 1] + lengths[i] * p / pieces);
+                step_segment.push_back(i);
+            }
+        }
+        profile.point_grid[i] = profile.s.size() - 1;
+    }
+    size_t grid = profile.s.size();
+    profile.x.assign(grid, 0);
+    profile.dt.assign(grid, 0);
+    if (grid < 2) {
+        return;
+    }
+
+    // Path derivatives dq/ds and d2q/ds2 at the grid points, and the limit of x from the joint velocities.
+    // Along a segment dq/ds is its slope; at an input point the difference of the slopes gives the curvature.
+    std::vector<double> dq(grid * 6), ddq(grid * 6), x_velocity(grid);
+    auto slope = [&](size_t segment, int j) {
+        return (path.values[j][segment] - path.values[j][segment - 1]) / lengths[segment];
+    };
+    for (size_t g = 0; g < grid; g++) {
+        double h0 = g > 0 ? profile.s[g] - profile.s[g - 1] : 0;
+        double h1 = g + 1 < grid ? profile.s[g + 1] - profile.s[g] : 0;
+        double x_max = std::numeric_limits<double>::infinity();
+        for (int j = 0; j < 6; j++) {
+            double in = g > 0 ? slope(step_segment[g], j) : slope(step_segment[1], j);
+            double out = g + 1 < grid ? slope(step_segment[g + 1], j) : in;
+            dq[g * 6 + j] = (h0 * in + h1 * out) / (h0 + h1);
+            ddq[g * 6 + j] = (g > 0 && g + 1 < grid) ? 2 * (out - in) / (h0 + h1) : 0;
+            double fastest = std::max(std::fabs(in), std::fabs(out));
+            if (fastest > 0) {
+                x_max = std::min(x_max, max_velocity_[j] * max_velocity_[j] / (fastest * fastest));
+            }
+        }
+        x_velocity[g] = x_max;
+    }
+
+    // Backward: the largest x at each grid point from which the end is reached at rest
+    std::vector<double> reachable(grid, 0);
+    for (size_t g = grid - 1; g-- > 0;) {
+        double step = profile.s[g + 1] - profile.s[g];
+        Bounds bounds = accelerationBounds(&dq[g * 6], &ddq[g * 6], max_acc_, step, reachable[g + 1], x_velocity[g]);
+        reachable[g] = maxFeasibleX(bounds);
+    }
+    // Forward: the largest path acceleration that stays reachable, from rest
+    for (size_t g = 0; g + 1 < grid; g++) {
+        double step = profile.s[g + 1] - profile.s[g];
+        Bounds bounds = accelerationBounds(&dq[g * 6], &ddq[g * 6], max_acc_, step, reachable[g + 1], x_velocity[g]);
+        double u = maxAcceleration(bounds, profile.x[g]);
+        profile.x[g + 1] = std::min(reachable[g + 1], std::max(0.0, profile.x[g] + 2 * step * u));
+        // Constant path acceleration over the step
+        profile.dt[g + 1] = 2 * step / (std::sqrt(profile.x[g]) + std::sqrt(profile.x[g + 1]));
+    }
+}
+
+std::vector<double> TimeParameterization::parameterize(const Vector6dBatch& path) const {
+    Profile profile;
+    solve(path, profile);
+    std::vector<double> times(path.size(), 0);
+    size_t g = 0;
+    double elapsed = 0;
+    for (size_t i = 1; i < path.size(); i++) {
+        double start = elapsed;
+        for (; g < profile.point_grid[i]; g++) {
+            elapsed += profile.dt[g + 1];
+        }
+        times[i] = elapsed - start;
+    }
+    return times;
+}
+
+Vector6dBatch TimeParameterization::resample(const Vector6dBatch& path, double period) const {
+    if (!(period > 0)) {
+        throw EliteException(EliteException::Code::ILLEGAL_PARAM, "sample period must be positive");
+    }
+    Vector6dBatch samples;
+    if (path.size() == 0) {
+        return samples;
+    }
+    Profile profile;
+    solve(path, profile);
+    double total = 0;
+    for (double dt : profile.dt) {
+        total += dt;
+    }
+    size_t count = std::max<size_t>(1, (size_t)std::ceil(total / period - 1e-9));
+    samples.resize(count);
+
+    size_t g = 1;
+    double step_start = 0;
+    size_t segment = 1;
+    for (size_t k = 0; k < count; k++) {
+        if (k + 1 == count || profile.s.size() < 2) {
+            samples.set(k, path.get(path.size() - 1));
+            continue;
+        }
+        double t = (k + 1) * period;
+        while (g + 1 < profile.s.size() && step_start + profile.dt[g] < t) {
+            step_start += profile.dt[g];
+            g++;
+        }
+        // Position along the path with the constant path acceleration of the step
+        double step = profile.s[g] - profile.s[g - 1];
+        double tau = std::min(t - step_start, profile.dt[g]);
+        double u = (profile.x[g] - profile.x[g - 1]) / (2 * step);
+        double s = profile.s[g - 1] + std::sqrt(profile.x[g - 1]) * tau + u * tau * tau / 2;
+        s = std::min(profile.s[g], std::max(profile.s[g - 1], s));
+        // The input segment holding s
+        while (segment + 1 < path.size() && profile.point_s[segment] < s) {
+            segment++;
+        }
+        double length = profile.point_s[segment] - profile.point_s[segment - 1];
+        double ratio = length > 0 ? (s - profile.point_s[segment - 1]) / length : 1;
+        for (int j = 0; j < 6; j++) {
+            double a = path.values[j][segment - 1], b = path.values[j][segment];
+            samples.values[j][k] = a + (b - a) * ratio;
+        }
+    }
+    return samples;
+}
@@ -0,0 +1,204 @@
+#include "TrajectoryCompressor.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <thread>
+#include <utility>
+
+using namespace ELITE;
+
+namespace {
+
+using Quaternion = std::array<double, 4>;
+
+// Rotation vector [rx, ry, rz] in positions[3..5] to a unit quaternion [w, x, y, z]
+Quaternion toQuaternion(const vector6d_t& pose) {
+    double angle = std::sqrt(pose[3] * pose[3] + pose[4] * pose[4] + pose[5] * pose[5]);
+    if (angle < 1e-12) {
+        return {1, 0, 0, 0};
+    }
+    double s = std::sin(angle / 2) / angle;
+    return {std::cos(angle / 2), pose[3] * s, pose[4] * s, pose[5] * s};
+}
+
+double dot(const Quaternion& a, const Quaternion& b) { return a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3]; }
+
+Quaternion slerp(const Quaternion& a, Quaternion b, double t) {
+    double cos_theta = dot(a, b);
+    // The shorter way, as movel() does
+    if (cos_theta < 0) {
+        for (auto& v : b) {
+            v = -v;
+        }
+        cos_theta = -cos_theta;
+    }
+    double wa = 1 - t, wb = t;
+    if (cos_theta < 0.9999) {
+        double theta = std::acos(cos_theta);
+        wa = std::sin((1 - t) * theta) / std::sin(theta);
+        wb = std::sin(t * theta) / std::sin(theta);
+    }
+    Quaternion q;
+    double norm = 0;
+    for (int i = 0; i < 4; i++) {
+        q[i] = wa * a[i] + wb * b[i];
+        norm += q[i] * q[i];
+    }
+    norm = std::sqrt(norm);
+    for (auto& v : q) {
+        v /= norm;
+    }
+    return q;
+}
+
+double angleBetween(const Quaternion& a, const Quaternion& b) {
+    return 2 * std::acos(std::min(1.0, std::fabs(dot(a, b))));
+}
+
+// Distance of p from the segment [a, b] over the first n coordinates, and the segment parameter of the closest point
+std::pair<double, double> segmentDistance(const vector6d_t& p, const vector6d_t& a, const vector6d_t& b, int n) {
+    double ab2 = 0, ap_ab = 0;
+    for (int i = 0; i < n; i++) {
+        ab2 += (b[i] - a[i]) * (b[i] - a[i]);
+        ap_ab += (p[i] - a[i]) * (b[i] - a[i]);
+    }
+    double t = ab2 > 0 ? std::min(1.0, std::max(0.0, ap_ab / ab2)) : 0;
+    double d2 = 0;
+    for (int i = 0; i < n; i++) {
+        double d = p[i] - (a[i] + t * (b[i] - a[i]));
+        d2 += d * d;
+    }
+    return {std::sqrt(d2), t};
+}
+
+}  // namespace
+
+TrajectoryCompressor::TrajectoryCompressor(const TrajectoryCompressionOptions& options) : options_(options) {}
+
+double TrajectoryCompressor::deviation(const vector6d_t& point, const vector6d_t& start, const vector6d_t& end) const {
+    if (!options_.cartesian) {
+        return segmentDistance(point, start, end, 6).first;
+    }
+    auto position = segmentDistance(point, start, end, 3);
+    double rotation = angleBetween(toQuaternion(point), slerp(toQuaternion(start), toQuaternion(end), position.second));
+    if (options_.rotation_tolerance <= 0) {
+        return position.first;
+    }
+    return std::max(position.first, rotation * options_.tolerance / options_.rotation_tolerance);
+}
+
+void TrajectoryCompressor::simplifyRange(const std::vector<TrajectoryWaypoint>& points, size_t first, size_t last,
+                                         std::vector<size_t>& kept) const {
+    // Iterative, a long path must not overflow the stack
+    std::vector<std::pair<size_t, size_t>> ranges = {{first, last}};
+    while (!ranges.empty()) {
+        auto range = ranges.back();
+        ranges.pop_back();
+        double max_deviation = 0;
+        size_t max_index = range.first;
+        for (size_t i = range.first + 1; i < range.second; i++) {
+            double d = deviation(points[i].positions, points[range.first].positions, points[range.second].positions);
+            if (d > max_deviation) {
+                max_deviation = d;
+                max_index = i;
+            }
+        }
+        if (max_deviation > options_.tolerance / 2) {
+            kept.push_back(max_index);
+            ranges.push_back({range.first, max_index});
+            ranges.push_back({max_index, range.second});
+        }
+    }
+}
+
+std::vector<size_t> TrajectoryCompressor::simplify(const std::vector<TrajectoryWaypoint>& points) const {
+    std::vector<size_t> kept;
+    if (points.size() <= 2) {
+        for (size_t i = 0; i < points.size(); i++) {
+            kept.push_back(i);
+        }
+        return kept;
+    }
+    size_t last = points.size() - 1;
+    unsigned threads = options_.threads ? options_.threads : std::max(1u, std::thread::hardware_concurrency());
+    if (points.size() < options_.parallel_threshold || threads <= 1) {
+        kept = {0, last};
+        simplifyRange(points, 0, last, kept);
+    } else {
+        // The chunk boundaries are kept, so each chunk is simplified on its own. It keeps a few more points than one pass.
+        std::vector<size_t> bounds;
+        for (unsigned i = 0; i <= threads; i++) {
+            bounds.push_back(last * i / threads);
+        }
+        std::vector<std::vector<size_t>> chunk_kept(threads);
+        std::vector<std::thread> workers;
+        for (unsigned i = 0; i < threads; i++) {
+            workers.emplace_back([&, i]() { simplifyRange(points, bounds[i], bounds[i + 1], chunk_kept[i]); });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        kept = bounds;
+        for (auto& chunk : chunk_kept) {
+            kept.insert(kept.end(), chunk.begin(), chunk.end());
+        }
+    }
+    std::sort(kept.begin(), kept.end());
+    kept.erase(std::unique(kept.begin(), kept.end()), kept.end());
+    return kept;
+}
+
+float TrajectoryCompressor::blendRadius(const vector6d_t& prev, const vector6d_t& corner, const vector6d_t& next) const {
+    // Joint: the blend size in joint space, cartesian: the TCP position
+    int n = options_.cartesian ? 3 : 6;
+    double in_len = 0, out_len = 0, in_out = 0;
+    for (int i = 0; i < n; i++) {
+        double in = corner[i] - prev[i];
+        double out = next[i] - corner[i];
+        in_len += in * in;
+        out_len += out * out;
+        in_out += in * out;
+    }
+    in_len = std::sqrt(in_len);
+    out_len = std::sqrt(out_len);
+    if (in_len <= 0 || out_len <= 0) {
+        return 0;
+    }
+    double radius = options_.max_blend_ratio * std::min(in_len, out_len);
+    // The blend cuts the corner at most as far as the chord between its ends, radius * sin(turn / 2) from the corner.
+    // It gets the other half of the tolerance, a removed point near the corner is within the sum of both.
+    double cos_turn = std::min(1.0, std::max(-1.0, in_out / (in_len * out_len)));
+    double half_turn_sin = std::sqrt((1 - cos_turn) / 2);
+    if (half_turn_sin > 1e-9) {
+        radius = std::min(radius, options_.tolerance / 2 / half_turn_sin);
+    }
+    if (!options_.cartesian) {
+        radius *= options_.joint_blend_scale;
+    }
+    return (float)radius;
+}
+
+std::vector<TrajectoryWaypoint> TrajectoryCompressor::compress(const std::vector<TrajectoryWaypoint>& points) const {
+    std::vector<size_t> kept = simplify(points);
+    std::vector<TrajectoryWaypoint> result;
+    result.reserve(kept.size());
+    size_t previous = 0;
+    for (size_t k = 0; k < kept.size(); k++) {
+        TrajectoryWaypoint point = points[kept[k]];
+        if (k > 0) {
+            point.time = 0;
+            for (size_t i = previous + 1; i <= kept[k]; i++) {
+                point.time += points[i].time;
+            }
+        }
+        point.blend_radius = 0;
+        result.push_back(point);
+        previous = kept[k];
+    }
+    for (size_t k = 1; k + 1 < result.size(); k++) {
+        result[k].blend_radius =
+            blendRadius(result[k - 1].positions, result[k].positions, result[k + 1].positions);
+    }
+    return result;
+}
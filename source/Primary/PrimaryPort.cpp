@@ -9,7 +9,7 @@ namespace ELITE
 {
 using namespace std::chrono;
 
-PrimaryPort::PrimaryPort() {
+PrimaryPort::PrimaryPort() : socket_async_thread_alive_(false), port_(0), last_receive_time_(0) {
     message_head_.resize(HEAD_LENGTH);
 }
 
@@ -19,6 +19,30 @@ PrimaryPort::~PrimaryPort() {
 
 
 bool PrimaryPort::connect(const std::string& ip, int port) {
+    ip_ = ip;
+    port_ = port;
+    if (!connectSocket(ip, port)) {
+        return false;
+    }
+    // The background thread exits when the connection is lost and the automatic reconnect is disabled
+    if (socket_async_thread_ && !socket_async_thread_alive_) {
+        if (socket_async_thread_->joinable()) {
+            socket_async_thread_->join();
+        }
+        socket_async_thread_.reset();
+    }
+    if (!socket_async_thread_) {
+        // Start async thread
+        socket_async_thread_alive_ = true;
+        socket_async_thread_.reset(new std::thread([&](){
+            socketAsyncLoop();
+        }));
+    }
+    reconnect_.setState(LinkState::CONNECTED);
+    return true;
+}
+
+bool PrimaryPort::connectSocket(const std::string& ip, int port) {
     try {
         std::lock_guard<std::mutex> lock(socket_mutex_);
         socket_ptr_.reset(new boost::asio::ip::tcp::socket(io_context_));
@@ -31,13 +55,25 @@ bool PrimaryPort::connect(const std::string& ip, int port) {
 #endif
         boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::make_address(ip), port);
         boost::system::error_code connect_ec;
+        bool connect_done = false;
         socket_ptr_->async_connect(endpoint, [&](const boost::system::error_code& ec){
             connect_ec = ec;
+            connect_done = true;
         });
         if (io_context_.stopped()) {
             io_context_.restart();
         }
         io_context_.run_for(std::chrono::steady_clock::duration(500ms));
+        if (!connect_done) {
+            // Cancel the connect and run the handler, it refers to the local variables
+            boost::system::error_code close_ec;
+            socket_ptr_->close(close_ec);
+            io_context_.restart();
+            io_context_.run();
+            socket_ptr_.reset();
+            ELITE_LOG_ERROR("Connect to robot primary port timeout");
+            return false;
+        }
         if (connect_ec) {
             ELITE_LOG_ERROR("Connect to robot primary port fail: %s", boost::system::system_error(connect_ec).what());
             return false;
@@ -46,13 +82,7 @@ bool PrimaryPort::connect(const std::string& ip, int port) {
         throw EliteException(EliteException::Code::SOCKET_CONNECT_FAIL, error.what());
         return false;
     }
-    if (!socket_async_thread_) {
-        // Start async thread
-        socket_async_thread_alive_ = true;
-        socket_async_thread_.reset(new std::thread([&](){
-            socketAsyncLoop();
-        }));
-    }
+    last_receive_time_ = steady_clock::now().time_since_epoch().count();
     return true;
 }
 
@@ -67,6 +97,7 @@ void PrimaryPort::disconnect() {
         socket_async_thread_->join();
     }
     socket_async_thread_.reset();
+    reconnect_.setState(LinkState::DISCONNECTED);
 }
 
 bool PrimaryPort::sendScript(const std::string& script) {
@@ -79,7 +110,7 @@ bool PrimaryPort::sendScript(const std::string& script) {
     boost::system::error_code ec;
     socket_ptr_->write_some(boost::asio::buffer(*script_with_newline), ec);
     if (ec) {
-        ELITE_LOG_ERROR("Send script to robot fail : ", boost::system::system_error(ec).what());
+        ELITE_LOG_ERROR("Send script to robot fail: %s", boost::system::system_error(ec).what());
         return false;
     } else {
         return true;
@@ -98,7 +129,7 @@ bool PrimaryPort::getPackage(std::shared_ptr<PrimaryPackage> pkg, int timeout_ms
 bool PrimaryPort::parserMessage() {
     std::lock_guard<std::mutex> lock(socket_mutex_);
     if (!socket_ptr_ || !socket_ptr_->is_open()) {
-        ELITE_LOG_WARN("Don't connect to robot primary port");
+        ELITE_LOG_WARN_THROTTLE(disconnected_log_throttle_, 1000, "Don't connect to robot primary port");
         return false;
     }
     if (socket_ptr_->available() <= HEAD_LENGTH) {
@@ -108,13 +139,15 @@ bool PrimaryPort::parserMessage() {
     boost::system::error_code ec;
     int head_len = boost::asio::read(*socket_ptr_, boost::asio::buffer(message_head_, HEAD_LENGTH), ec);
     if (ec) {
-        ELITE_LOG_ERROR("Primary port receive package head had expection: %s", boost::system::system_error(ec).what());
+        ELITE_LOG_ERROR_THROTTLE(head_log_throttle_, 1000, "Primary port receive package head had expection: %s",
+                                 boost::system::system_error(ec).what());
         return false;
     }
+    last_receive_time_ = steady_clock::now().time_since_epoch().count();
     uint32_t package_len = 0;
     UTILS::EndianUtils::unpack(message_head_.begin(), package_len);
     if (package_len <= HEAD_LENGTH) {
-        ELITE_LOG_ERROR("Primary port package len error: %d", package_len);
+        ELITE_LOG_ERROR_THROTTLE(length_log_throttle_, 1000, "Primary port package len error: %d", package_len);
         return false;
     }
 
@@ -128,7 +161,8 @@ bool PrimaryPort::parserMessageBody(int type, int package_len) {
     // Receive package body
     boost::asio::read(*socket_ptr_, boost::asio::buffer(message_body_, body_len), ec);
     if (ec) {
-        ELITE_LOG_ERROR("Primary port receive package body had expection: %s", boost::system::system_error(ec).what());
+        ELITE_LOG_ERROR_THROTTLE(body_log_throttle_, 1000, "Primary port receive package body had expection: %s",
+                                 boost::system::system_error(ec).what());
         return false;
     }
     // If RobotState message parser others don't do anything.
@@ -152,14 +186,36 @@ bool PrimaryPort::parserMessageBody(int type, int package_len) {
 
 void PrimaryPort::socketAsyncLoop() {
     while (socket_async_thread_alive_) {
+        bool connected = false;
         try {
-            if (!parserMessage()) {
+            connected = parserMessage();
+        } catch(const std::exception& e) {
+            connected = false;
+        }
+        if (connected && reconnect_.isEnabled()) {
+            // A closed connection has nothing available to read, so the silence is the sign of a lost connection
+            auto silence = duration_cast<milliseconds>(steady_clock::now().time_since_epoch() -
+                                                       steady_clock::duration(last_receive_time_.load()));
+            if (silence.count() > reconnect_.getOptions().silence_timeout_ms) {
+                ELITE_LOG_ERROR("Primary port received nothing in %lld ms", (long long)silence.count());
+                connected = false;
+            }
+        }
+        if (!connected && socket_async_thread_alive_) {
+            auto attempt = [this]() {
+                try {
+                    return connectSocket(ip_, port_);
+                } catch (const std::exception& e) {
+                    return false;
+                }
+            };
+            bool restored = reconnect_.run(attempt, [this]() { return socket_async_thread_alive_.load(); });
+            if (!restored) {
                 socket_async_thread_alive_ = false;
+                reconnect_.setState(LinkState::DISCONNECTED);
             }
-            std::this_thread::sleep_for(10ms);
-        } catch(const std::exception& e) {
-            socket_async_thread_alive_ = false;
         }
+        std::this_thread::sleep_for(10ms);
     }
 }
 
@@ -34,6 +34,22 @@ bool PrimaryPortInterface::getPackage(std::shared_ptr<PrimaryPackage> pkg, int t
     return impl_->primary_.getPackage(pkg, timeout_ms);
 }
 
+void PrimaryPortInterface::setAutoReconnect(bool enable, const ReconnectOptions& options) {
+    impl_->primary_.setAutoReconnect(enable, options);
+}
+
+void PrimaryPortInterface::setConnectionStateCallback(std::function<void(LinkState)> cb) {
+    impl_->primary_.setConnectionStateCallback(cb);
+}
+
+LinkState PrimaryPortInterface::getConnectionState() {
+    return impl_->primary_.getConnectionState();
+}
+
+ReconnectMetrics PrimaryPortInterface::getReconnectMetrics() {
+    return impl_->primary_.getReconnectMetrics();
+}
+
 
 
 } // namespace ELITE
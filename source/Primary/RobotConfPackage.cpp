@@ -62,6 +62,22 @@ void KinematicsInfo::parser(int len, const std::vector<uint8_t>::const_iterator&
     }
 }
 
+void JointLimitsInfo::parser(int len, const std::vector<uint8_t>::const_iterator& iter) {
+    int offset = LIMIT_OFFSET;
+    for (size_t i = 0; i < 6; i++) {
+        UTILS::EndianUtils::unpack(iter + offset, limit_min_[i]);
+        offset += sizeof(double);
+        UTILS::EndianUtils::unpack(iter + offset, limit_max_[i]);
+        offset += sizeof(double);
+    }
+    for (size_t i = 0; i < 6; i++) {
+        UTILS::EndianUtils::unpack(iter + offset, max_velocity_[i]);
+        offset += sizeof(double);
+        UTILS::EndianUtils::unpack(iter + offset, max_acc_[i]);
+        offset += sizeof(double);
+    }
+}
+
 
 
 } // namespace ELITE
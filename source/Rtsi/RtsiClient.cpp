@@ -30,6 +30,10 @@ void RtsiClient::connect(const std::string& ip, int port) {
                 connection_state = ConnectionState::CONNECTED;
             }
         });
+        // A previous receive may have left the io_context in the "stopped" state
+        if (io_context_.stopped()) {
+            io_context_.restart();
+        }
         io_context_.run();
         
     } catch(const boost::system::system_error &error) {
@@ -71,12 +75,8 @@ VersionInfo RtsiClient::getControllerVersion() {
 RtsiRecipeSharedPtr RtsiClient::setupOutputRecipe(const std::vector<std::string>& recipe_list, double frequency) {
     // The first eight bytes of the payload section in the output subscription message are the frequency.
     std::vector<uint8_t> payload = EndianUtils::pack(frequency);
-    for (auto i : recipe_list) {
-        std::copy(i.begin(), i.end(), std::back_inserter(payload));
-        payload.push_back(',');
-    }
-    // Remove the last redundant ','.
-    payload.pop_back();
+    std::vector<uint8_t> names = recipePayload(recipe_list);
+    payload.insert(payload.end(), names.begin(), names.end());
     sendAll(PackageType::CONTROL_PACKAGE_SETUP_OUTPUTS, payload);
 
     RtsiRecipeInternal* recipe = new RtsiRecipeInternal(recipe_list);
@@ -88,14 +88,7 @@ RtsiRecipeSharedPtr RtsiClient::setupOutputRecipe(const std::vector<std::string>
 }
 
 RtsiRecipeSharedPtr RtsiClient::setupInputRecipe(const std::vector<std::string>& recipe_list) {
-    std::vector<uint8_t> payload;
-    for (auto i : recipe_list) {
-        std::copy(i.begin(), i.end(), std::back_inserter(payload));
-        payload.push_back(',');
-    }
-    // Remove the last redundant ','.
-    payload.pop_back();
-    sendAll(PackageType::CONTROL_PACKAGE_SETUP_INPUTS, payload);
+    sendAll(PackageType::CONTROL_PACKAGE_SETUP_INPUTS, recipePayload(recipe_list));
 
     RtsiRecipeInternal* recipe = new RtsiRecipeInternal(recipe_list);
     receive(PackageType::CONTROL_PACKAGE_SETUP_INPUTS, [&](int len, const std::vector<uint8_t>& package){
@@ -131,6 +124,79 @@ bool RtsiClient::pause() {
     return is_pause;
 }
 
+bool RtsiClient::handshake(const std::vector<std::string>& output_recipe, double frequency,
+                           const std::vector<std::string>& input_recipe, RtsiHandshakeResult& result, uint16_t version) {
+    std::vector<uint8_t> output_payload = EndianUtils::pack(frequency);
+    std::vector<uint8_t> output_names = recipePayload(output_recipe);
+    output_payload.insert(output_payload.end(), output_names.begin(), output_names.end());
+
+    // The server answers the requests in order, so all of them can be sent before the first reply comes back.
+    std::vector<uint8_t> message;
+    appendPackage(message, PackageType::REQUEST_PROTOCOL_VERSION, {(uint8_t)(version >> 8), (uint8_t)version});
+    appendPackage(message, PackageType::GET_ELITE_CONTROL_VERSION);
+    appendPackage(message, PackageType::CONTROL_PACKAGE_SETUP_INPUTS, recipePayload(input_recipe));
+    appendPackage(message, PackageType::CONTROL_PACKAGE_SETUP_OUTPUTS, output_payload);
+    appendPackage(message, PackageType::CONTROL_PACKAGE_START);
+    writeMessage(message);
+
+    // Recipes from a previous connection are set up again in place, so the values in them are kept
+    if (!result.input_recipe) {
+        result.input_recipe.reset(static_cast<RtsiRecipe*>(new RtsiRecipeInternal(input_recipe)));
+    }
+    if (!result.output_recipe) {
+        result.output_recipe.reset(static_cast<RtsiRecipe*>(new RtsiRecipeInternal(output_recipe)));
+    }
+    RtsiRecipeInternal* input = static_cast<RtsiRecipeInternal*>(result.input_recipe.get());
+    RtsiRecipeInternal* output = static_cast<RtsiRecipeInternal*>(result.output_recipe.get());
+    result.protocol_accepted = false;
+    result.started = false;
+
+    const PackageType expected[] = {PackageType::REQUEST_PROTOCOL_VERSION, PackageType::GET_ELITE_CONTROL_VERSION,
+                                    PackageType::CONTROL_PACKAGE_SETUP_INPUTS, PackageType::CONTROL_PACKAGE_SETUP_OUTPUTS,
+                                    PackageType::CONTROL_PACKAGE_START};
+    for (auto type : expected) {
+        bool received = false;
+        receive(type, [&](int len, const std::vector<uint8_t>& package) {
+            received = true;
+            switch (type) {
+                case PackageType::REQUEST_PROTOCOL_VERSION:
+                    result.protocol_accepted = package[3];
+                    break;
+                case PackageType::GET_ELITE_CONTROL_VERSION: {
+                    int offset = RTSI_HEADR_SIZE;
+                    EndianUtils::unpack(package, offset, result.controller_version.major);
+                    EndianUtils::unpack(package, offset, result.controller_version.minor);
+                    EndianUtils::unpack(package, offset, result.controller_version.bugfix);
+                    EndianUtils::unpack(package, offset, result.controller_version.build);
+                    break;
+                }
+                case PackageType::CONTROL_PACKAGE_SETUP_INPUTS:
+                    input->parserTypePackage(len, package);
+                    break;
+                case PackageType::CONTROL_PACKAGE_SETUP_OUTPUTS:
+                    output->parserTypePackage(len, package);
+                    break;
+                default:
+                    result.started = package[3];
+                    if (result.started) {
+                        connection_state = ConnectionState::STARTED;
+                    }
+                    break;
+            }
+        });
+        if (!received) {
+            return false;
+        }
+        // The later requests are meaningless if the server does not speak this version. Their replies are still
+        // pending, so close the connection instead of leaving them for the next request to read.
+        if (type == PackageType::REQUEST_PROTOCOL_VERSION && !result.protocol_accepted) {
+            disconnect();
+            break;
+        }
+    }
+    return true;
+}
+
 bool RtsiClient::isConnected() {
     return connection_state != ConnectionState::DISCONNECTED;
 }
@@ -181,18 +247,38 @@ bool RtsiClient::receiveData(RtsiRecipeSharedPtr recipe, bool read_newest) {
 }
 
 void RtsiClient::sendAll(const PackageType& cmd, const std::vector<uint8_t>& payload) {
-    std::vector<uint8_t> message(RTSI_HEADR_SIZE);
+    std::vector<uint8_t> message;
+    appendPackage(message, cmd, payload);
+    writeMessage(message);
+}
+
+void RtsiClient::appendPackage(std::vector<uint8_t>& message, const PackageType& cmd, const std::vector<uint8_t>& payload) {
     uint16_t message_len = RTSI_HEADR_SIZE + payload.size();
 
     // Build package header
-    message[0] = (uint8_t)(message_len >> 8);
-    message[1] = (uint8_t)message_len;
-    message[2] = static_cast<uint8_t>(cmd);
+    message.push_back((uint8_t)(message_len >> 8));
+    message.push_back((uint8_t)message_len);
+    message.push_back(static_cast<uint8_t>(cmd));
     // Push back payload 
-    std::copy(payload.begin(), payload.end(), std::back_inserter(message));
+    message.insert(message.end(), payload.begin(), payload.end());
+}
+
+std::vector<uint8_t> RtsiClient::recipePayload(const std::vector<std::string>& recipe_list) {
+    std::vector<uint8_t> payload;
+    for (auto& i : recipe_list) {
+        std::copy(i.begin(), i.end(), std::back_inserter(payload));
+        payload.push_back(',');
+    }
+    // Remove the last redundant ','.
+    if (!payload.empty()) {
+        payload.pop_back();
+    }
+    return payload;
+}
 
+void RtsiClient::writeMessage(const std::vector<uint8_t>& message) {
     boost::system::error_code ec;
-    socket_ptr_->write_some(boost::asio::buffer(message), ec);
+    boost::asio::write(*socket_ptr_, boost::asio::buffer(message), ec);
     if (ec == boost::asio::error::operation_aborted) {
         throw EliteException(EliteException::Code::SOCKET_OPT_CANCEL, ec.message());
     } else if (ec) {
@@ -53,6 +53,13 @@ bool RtsiClientInterface::pause() {
 }
 
 
+bool RtsiClientInterface::handshake(const std::vector<std::string>& output_recipe, double frequency,
+                                    const std::vector<std::string>& input_recipe, RtsiHandshakeResult& result,
+                                    uint16_t version) {
+    return impl_->client_.handshake(output_recipe, frequency, input_recipe, result, version);
+}
+
+
 void RtsiClientInterface::send(RtsiRecipeSharedPtr& recipe) {
     impl_->client_.send(recipe);
 }
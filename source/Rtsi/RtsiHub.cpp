@@ -0,0 +1,314 @@
+#include "RtsiHub.hpp"
+#include "RtsiClientInterface.hpp"
+#include "RtsiRecipeInternal.hpp"
+#include "EliteException.hpp"
+#include "Log.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+using namespace ELITE;
+
+void RtsiCallbackSubscription::onSample(const RtsiSamplePtr& sample) {
+    if (cb_) {
+        cb_(sample);
+    }
+}
+
+RtsiSampleQueue::RtsiSampleQueue(const std::vector<std::string>& fields, size_t capacity)
+    : RtsiSubscription(fields), ring_(std::max<size_t>(capacity, 1) + 1), head_(0), tail_(0), dropped_(0), waiting_(false) {}
+
+void RtsiSampleQueue::onSample(const RtsiSamplePtr& sample) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    size_t next = (tail + 1) % ring_.size();
+    if (next == head_.load(std::memory_order_acquire)) {
+        dropped_++;
+        return;
+    }
+    ring_[tail] = sample;
+    tail_.store(next);
+    // Pairs with the store of waiting_ in waitPop(), so either the consumer sees the new tail or the producer sees it waiting
+    if (waiting_.load()) {
+        std::lock_guard<std::mutex> lock(wait_mutex_);
+        wait_cv_.notify_one();
+    }
+}
+
+bool RtsiSampleQueue::pop(RtsiSamplePtr& sample) {
+    size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) {
+        return false;
+    }
+    sample = std::move(ring_[head]);
+    head_.store((head + 1) % ring_.size(), std::memory_order_release);
+    return true;
+}
+
+bool RtsiSampleQueue::waitPop(RtsiSamplePtr& sample, int timeout_ms) {
+    if (pop(sample)) {
+        return true;
+    }
+    {
+        std::unique_lock<std::mutex> lock(wait_mutex_);
+        waiting_.store(true);
+        wait_cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms),
+                          [this]() { return head_.load(std::memory_order_relaxed) != tail_.load(); });
+        waiting_.store(false);
+    }
+    return pop(sample);
+}
+
+size_t RtsiSampleQueue::size() const {
+    size_t head = head_.load(std::memory_order_acquire);
+    size_t tail = tail_.load(std::memory_order_acquire);
+    return (tail + ring_.size() - head) % ring_.size();
+}
+
+RtsiSamplePtr RtsiLatestSample::get() const { return std::atomic_load(&latest_); }
+
+void RtsiLatestSample::onSample(const RtsiSamplePtr& sample) { std::atomic_store(&latest_, sample); }
+
+class RtsiHub::Impl {
+   public:
+    explicit Impl(double frequency) : frequency_(frequency) {}
+
+    double frequency_;
+    RtsiClientInterface client_;
+
+    // Guards subscriptions_, pending_ and recipe_fields_
+    std::mutex mutex_;
+    std::vector<std::shared_ptr<RtsiSubscription>> subscriptions_;
+    // Subscribed since the last negotiation
+    std::vector<std::shared_ptr<RtsiSubscription>> pending_;
+    std::vector<std::string> recipe_fields_;
+    // Set when pending_ or subscriptions_ changed, cleared by the receive thread
+    std::atomic<bool> dirty_{false};
+
+    // Owned by the receive thread while it runs
+    RtsiRecipeSharedPtr recipe_;
+    std::shared_ptr<const RtsiSample::FieldIndex> index_;
+    std::vector<std::shared_ptr<RtsiSubscription>> dispatch_;
+
+    std::atomic<uint64_t> sample_count_{0};
+    std::unique_ptr<std::thread> recv_thread_;
+    std::atomic<bool> is_recv_thread_alive_{false};
+
+    static std::vector<std::string> mergeFields(std::vector<std::string> base,
+                                                const std::vector<std::shared_ptr<RtsiSubscription>>& subs) {
+        for (auto& sub : subs) {
+            for (auto& field : sub->getFields()) {
+                if (std::find(base.begin(), base.end(), field) == base.end()) {
+                    base.push_back(field);
+                }
+            }
+        }
+        return base;
+    }
+
+    bool setupRecipe(const std::vector<std::string>& fields) {
+        try {
+            recipe_ = client_.setupOutputRecipe(fields, frequency_);
+        } catch (const EliteException& e) {
+            if (e == EliteException::Code::RTSI_UNKNOW_VARIABLE_TYPE) {
+                ELITE_LOG_WARN("RTSI hub recipe rejected: %s", e.what());
+                return false;
+            }
+            throw;
+        }
+        auto index = std::make_shared<RtsiSample::FieldIndex>();
+        for (size_t i = 0; i < fields.size(); i++) {
+            (*index)[fields[i]] = i;
+        }
+        index_ = index;
+        std::lock_guard<std::mutex> lock(mutex_);
+        recipe_fields_ = fields;
+        return true;
+    }
+
+    // Set up base plus the fields of the candidates. If the controller rejects the union, find the candidates
+    // with an unknown field one by one and deactivate them, so one bad subscriber does not break the others.
+    bool negotiate(const std::vector<std::string>& base, std::vector<std::shared_ptr<RtsiSubscription>> candidates) {
+        if (setupRecipe(mergeFields(base, candidates))) {
+            return true;
+        }
+        for (auto& sub : candidates) {
+            if (!setupRecipe(mergeFields(base, {sub}))) {
+                ELITE_LOG_ERROR("RTSI hub subscription rejected, its fields are not all known by the controller");
+                sub->active_ = false;
+            }
+        }
+        candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                                        [](const std::shared_ptr<RtsiSubscription>& sub) { return !sub->isActive(); }),
+                         candidates.end());
+        return setupRecipe(mergeFields(base, candidates));
+    }
+
+    bool covers(const RtsiSubscription& sub) const {
+        for (auto& field : sub.getFields()) {
+            if (index_->find(field) == index_->end()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void rebuildDispatch() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        dispatch_.clear();
+        for (auto& sub : subscriptions_) {
+            if (sub->isActive() && covers(*sub)) {
+                dispatch_.push_back(sub);
+            }
+        }
+    }
+
+    // Called by the receive thread when subscriptions changed
+    void updateSubscriptions() {
+        std::vector<std::shared_ptr<RtsiSubscription>> pending;
+        std::vector<std::string> fields;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending.swap(pending_);
+            fields = recipe_fields_;
+        }
+        if (mergeFields(fields, pending).size() != fields.size()) {
+            // The output recipe can only be changed while the synchronization is paused
+            client_.pause();
+            if (!negotiate(fields, pending)) {
+                throw EliteException(EliteException::Code::RTSI_RECIPE_PARSER_FAIL, "set up the previous recipe again");
+            }
+            client_.start();
+        }
+        rebuildDispatch();
+    }
+
+    void recvLoop() {
+        std::vector<RtsiTypeVariant> values;
+        while (is_recv_thread_alive_) {
+            try {
+                if (dirty_.exchange(false)) {
+                    updateSubscriptions();
+                }
+                if (!client_.receiveData(recipe_, false)) {
+                    continue;
+                }
+                static_cast<RtsiRecipeInternal*>(recipe_.get())->copyValues(values);
+                // The sample is built once and shared by all subscribers
+                auto sample = std::make_shared<const RtsiSample>(index_, std::move(values), ++sample_count_,
+                                                                 std::chrono::steady_clock::now());
+                for (auto& sub : dispatch_) {
+                    if (sub->isActive()) {
+                        sub->onSample(sample);
+                    }
+                }
+            } catch (const std::exception& e) {
+                ELITE_LOG_ERROR("RTSI hub receive fail: %s", e.what());
+                is_recv_thread_alive_ = false;
+            }
+        }
+    }
+};
+
+RtsiHub::RtsiHub(double frequency) : impl_(new Impl(frequency)) {}
+
+RtsiHub::~RtsiHub() { disconnect(); }
+
+bool RtsiHub::connect(const std::string& ip) {
+    disconnect();
+    try {
+        impl_->client_.connect(ip);
+        if (!impl_->client_.isConnected()) {
+            ELITE_LOG_ERROR("RTSI hub connect to %s fail", ip.c_str());
+            return false;
+        }
+        if (!impl_->client_.negotiateProtocolVersion()) {
+            ELITE_LOG_ERROR("RTSI hub protocol version not accepted");
+            impl_->client_.disconnect();
+            return false;
+        }
+        std::vector<std::shared_ptr<RtsiSubscription>> subs;
+        {
+            std::lock_guard<std::mutex> lock(impl_->mutex_);
+            subs = impl_->subscriptions_;
+            impl_->pending_.clear();
+        }
+        impl_->dirty_ = false;
+        // The timestamp is always in the recipe, so the recipe is not empty without subscribers
+        if (!impl_->negotiate({"timestamp"}, subs) || !impl_->client_.start()) {
+            impl_->client_.disconnect();
+            return false;
+        }
+        impl_->rebuildDispatch();
+    } catch (const std::exception& e) {
+        ELITE_LOG_ERROR("RTSI hub connect fail: %s", e.what());
+        impl_->client_.disconnect();
+        return false;
+    }
+    impl_->is_recv_thread_alive_ = true;
+    impl_->recv_thread_.reset(new std::thread([this]() { impl_->recvLoop(); }));
+    return true;
+}
+
+void RtsiHub::disconnect() {
+    if (impl_->recv_thread_ && impl_->recv_thread_->joinable()) {
+        impl_->is_recv_thread_alive_ = false;
+        impl_->recv_thread_->join();
+    }
+    impl_->recv_thread_.reset();
+    if (impl_->client_.isConnected()) {
+        impl_->client_.disconnect();
+    }
+}
+
+bool RtsiHub::isConnected() { return impl_->client_.isConnected() && impl_->is_recv_thread_alive_; }
+
+void RtsiHub::subscribe(std::shared_ptr<RtsiSubscription> subscription) {
+    if (!subscription) {
+        return;
+    }
+    subscription->active_ = true;
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    impl_->subscriptions_.push_back(subscription);
+    impl_->pending_.push_back(subscription);
+    impl_->dirty_ = true;
+}
+
+void RtsiHub::unsubscribe(const std::shared_ptr<RtsiSubscription>& subscription) {
+    if (!subscription) {
+        return;
+    }
+    subscription->active_ = false;
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    auto& subs = impl_->subscriptions_;
+    subs.erase(std::remove(subs.begin(), subs.end(), subscription), subs.end());
+    auto& pending = impl_->pending_;
+    pending.erase(std::remove(pending.begin(), pending.end(), subscription), pending.end());
+    impl_->dirty_ = true;
+}
+
+std::shared_ptr<RtsiSubscription> RtsiHub::subscribe(const std::vector<std::string>& fields,
+                                                     std::function<void(const RtsiSamplePtr&)> cb) {
+    auto sub = std::make_shared<RtsiCallbackSubscription>(fields, std::move(cb));
+    subscribe(sub);
+    return sub;
+}
+
+std::shared_ptr<RtsiSampleQueue> RtsiHub::subscribeQueue(const std::vector<std::string>& fields, size_t capacity) {
+    auto sub = std::make_shared<RtsiSampleQueue>(fields, capacity);
+    subscribe(sub);
+    return sub;
+}
+
+std::shared_ptr<RtsiLatestSample> RtsiHub::subscribeLatest(const std::vector<std::string>& fields) {
+    auto sub = std::make_shared<RtsiLatestSample>(fields);
+    subscribe(sub);
+    return sub;
+}
+
+std::vector<std::string> RtsiHub::getOutputRecipe() {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    return impl_->recipe_fields_;
+}
+
+uint64_t RtsiHub::getSampleCount() { return impl_->sample_count_; }
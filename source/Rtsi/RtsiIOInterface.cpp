@@ -1,6 +1,7 @@
 #include "RtsiIOInterface.hpp"
 #include "EliteException.hpp"
 #include "Log.hpp"
+#include "ReconnectSupervisor.hpp"
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -40,7 +41,9 @@ template bool RtsiIOInterface::setInputRecipeValue<vector6int32_t>(const std::st
 RtsiIOInterface::RtsiIOInterface(const std::string& output_recipe_file, const std::string& input_recipe_file, double frequency) 
     : output_recipe_string_(readRecipe(output_recipe_file))
     , input_recipe_string_(readRecipe(input_recipe_file))
-    , target_frequency_(frequency){
+    , target_frequency_(frequency)
+    , reconnect_(std::make_unique<ReconnectSupervisor>())
+    , first_data_received_(false) {
 
 }
 
@@ -49,25 +52,52 @@ RtsiIOInterface::~RtsiIOInterface() {
 }
 
 bool RtsiIOInterface::connect(const std::string& ip) {
+    return connectImpl(ip, false);
+}
+
+std::future<bool> RtsiIOInterface::connectAsync(const std::string& ip) {
+    return std::async(std::launch::async, [this, ip]() { return connectImpl(ip, true); });
+}
+
+RtsiConnectTimings RtsiIOInterface::getConnectTimings() {
+    return connect_timings_;
+}
+
+void RtsiIOInterface::setAutoReconnect(bool enable, const ReconnectOptions& options) {
+    reconnect_->setEnabled(enable, options);
+}
+
+void RtsiIOInterface::setConnectionStateCallback(std::function<void(LinkState)> cb) {
+    reconnect_->setStateCallback(cb);
+}
+
+LinkState RtsiIOInterface::getConnectionState() {
+    return reconnect_->getState();
+}
+
+ReconnectMetrics RtsiIOInterface::getReconnectMetrics() {
+    return reconnect_->getMetrics();
+}
+
+bool RtsiIOInterface::connectImpl(const std::string& ip, bool pipelined) {
     if (isConnected() || recv_thread_) {
         disconnect();
     }
-    
-    RtsiClientInterface::connect(ip);
-    
-    if(!negotiateProtocolVersion()) {
-        ELITE_LOG_FATAL("RTSI negitiate protocol version fail.");
-        return false;
-    }
+    using namespace std::chrono;
+    connect_timings_ = RtsiConnectTimings();
+    ip_ = ip;
+    auto begin = steady_clock::now();
 
-    controller_version_ = RtsiClientInterface::getControllerVersion();
+    RtsiClientInterface::connect(ip);
+    auto socket_done = steady_clock::now();
+    connect_timings_.socket = duration_cast<microseconds>(socket_done - begin);
 
     // Setup input and output recipe. 
     // Send start signal
     try {
-        setupRecipe();
-        if (!start()) {
-            ELITE_LOG_FATAL("RTSI start signal send fail.");
+        bool success = pipelined ? pipelinedHandshake() : sequentialHandshake();
+        connect_timings_.handshake = duration_cast<microseconds>(steady_clock::now() - socket_done);
+        if (!success) {
             return false;
         }
     } catch(const EliteException& e) {
@@ -81,12 +111,88 @@ bool RtsiIOInterface::connect(const std::string& ip) {
     }
 
     // The recv thread must create after setup recipe, because 'output_recipe_' get in setup 
+    auto thread_begin = steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(first_data_mutex_);
+        first_data_received_ = false;
+    }
     is_recv_thread_alive_ = true;
     recv_thread_.reset(new std::thread([&](){
         recvLoop();
     }));
-    // Wait for recv_thread_ run
-    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    // Wait for the first data package, but not longer than the fixed 10ms wait used before
+    {
+        std::unique_lock<std::mutex> lock(first_data_mutex_);
+        first_data_cv_.wait_for(lock, milliseconds(10), [this]() { return first_data_received_.load(); });
+    }
+    auto end = steady_clock::now();
+    connect_timings_.first_data = duration_cast<microseconds>(end - thread_begin);
+    connect_timings_.total = duration_cast<microseconds>(end - begin);
+    ELITE_LOG_DEBUG("RTSI connected in %lld us (socket %lld us, handshake %lld us, first data %lld us)",
+                    (long long)connect_timings_.total.count(), (long long)connect_timings_.socket.count(),
+                    (long long)connect_timings_.handshake.count(), (long long)connect_timings_.first_data.count());
+    reconnect_->setState(LinkState::CONNECTED);
+    return true;
+}
+
+bool RtsiIOInterface::sequentialHandshake() {
+    if(!negotiateProtocolVersion()) {
+        ELITE_LOG_FATAL("RTSI negitiate protocol version fail.");
+        return false;
+    }
+
+    controller_version_ = RtsiClientInterface::getControllerVersion();
+
+    setupRecipe();
+    if (!start()) {
+        ELITE_LOG_FATAL("RTSI start signal send fail.");
+        return false;
+    }
+    return true;
+}
+
+bool RtsiIOInterface::pipelinedHandshake() {
+    RtsiHandshakeResult result;
+    if (!handshake(output_recipe_string_, target_frequency_, input_recipe_string_, result)) {
+        ELITE_LOG_FATAL("RTSI handshake timeout.");
+        return false;
+    }
+    if (!result.protocol_accepted) {
+        ELITE_LOG_FATAL("RTSI negitiate protocol version fail.");
+        return false;
+    }
+    controller_version_ = result.controller_version;
+    input_recipe_ = result.input_recipe;
+    output_recipe_ = result.output_recipe;
+    if (!result.started) {
+        ELITE_LOG_FATAL("RTSI start signal send fail.");
+        return false;
+    }
+    return true;
+}
+
+bool RtsiIOInterface::restoreConnection() {
+    try {
+        // The new socket replaces the broken one
+        RtsiClientInterface::connect(ip_);
+        RtsiHandshakeResult result;
+        result.input_recipe = input_recipe_;
+        result.output_recipe = output_recipe_;
+        if (!handshake(output_recipe_string_, target_frequency_, input_recipe_string_, result) || !result.protocol_accepted ||
+            !result.started) {
+            return false;
+        }
+        const VersionInfo& cached_version = controller_version_;
+        if (result.controller_version != cached_version) {
+            ELITE_LOG_WARN("RTSI controller version changed after reconnect: %s", result.controller_version.toString().c_str());
+            controller_version_ = result.controller_version;
+        }
+    } catch (const std::exception& e) {
+        ELITE_LOG_DEBUG("RTSI reconnect fail: %s", e.what());
+        return false;
+    }
+    // Send the input recipe values again, the controller dropped them with the old connection
+    input_new_cmd_ = true;
     return true;
 }
 
@@ -96,6 +202,7 @@ void RtsiIOInterface::disconnect() {
         recv_thread_->join();
     }
     RtsiClientInterface::disconnect();
+    reconnect_->setState(LinkState::DISCONNECTED);
 }
 
 VersionInfo RtsiIOInterface::getControllerVersion() {
@@ -610,19 +717,106 @@ void RtsiIOInterface::setupRecipe() {
     output_recipe_ = setupOutputRecipe(output_recipe_string_, target_frequency_);
 }
 
+void RtsiIOInterface::setStateMonitor(std::shared_ptr<RobotStateMonitor> monitor) {
+    std::atomic_store(&state_monitor_, monitor);
+}
+
+void RtsiIOInterface::updateStateMonitor() {
+    auto monitor = std::atomic_load(&state_monitor_);
+    if (!monitor) {
+        return;
+    }
+    // Fields which are not in the output recipe keep the last value of the monitor.
+    RobotMode robot_mode = monitor->getRobotMode();
+    SafetyMode safety_mode = monitor->getSafetyMode();
+    TaskStatus task_status = monitor->getTaskStatus();
+    int32_t mode = 0;
+    uint32_t state = 0;
+    if (getRecipeValue("robot_mode", mode)) {
+        robot_mode = static_cast<RobotMode>(mode);
+    }
+    if (getRecipeValue("safety_status", mode)) {
+        safety_mode = static_cast<SafetyMode>(mode);
+    }
+    if (getRecipeValue("runtime_state", state)) {
+        task_status = static_cast<TaskStatus>(state);
+    }
+    monitor->update(robot_mode, safety_mode, task_status);
+}
+
+void RtsiIOInterface::setStatePublisher(std::shared_ptr<RobotStatePublisher> publisher) {
+    std::atomic_store(&state_publisher_, publisher);
+}
+
+void RtsiIOInterface::updateStatePublisher() {
+    auto publisher = std::atomic_load(&state_publisher_);
+    if (!publisher) {
+        return;
+    }
+    // Fields which are not in the output recipe are zero, the states are UNKNOWN, which zero is not.
+    RobotStateSnapshot snapshot{};
+    snapshot.robot_mode = RobotMode::UNKNOWN;
+    snapshot.safety_status = SafetyMode::UNKNOWN;
+    snapshot.runtime_state = TaskStatus::UNKNOWN;
+    int32_t mode = 0;
+    uint32_t state = 0;
+    getRecipeValue("timestamp", snapshot.timestamp);
+    getRecipeValue("target_joint_positions", snapshot.target_joint_positions);
+    getRecipeValue("target_joint_speeds", snapshot.target_joint_velocity);
+    getRecipeValue("actual_joint_positions", snapshot.actual_joint_positions);
+    getRecipeValue("actual_joint_speeds", snapshot.actual_joint_velocity);
+    getRecipeValue("actual_joint_current", snapshot.actual_joint_current);
+    getRecipeValue("actual_joint_torques", snapshot.actual_joint_torques);
+    getRecipeValue("actual_TCP_pose", snapshot.actual_tcp_pose);
+    getRecipeValue("actual_TCP_speed", snapshot.actual_tcp_velocity);
+    getRecipeValue("actual_TCP_force", snapshot.actual_tcp_force);
+    getRecipeValue("target_TCP_pose", snapshot.target_tcp_pose);
+    getRecipeValue("target_TCP_speed", snapshot.target_tcp_velocity);
+    getRecipeValue("speed_scaling", snapshot.actual_speed_scaling);
+    getRecipeValue("target_speed_fraction", snapshot.target_speed_scaling);
+    getRecipeValue("actual_digital_input_bits", snapshot.digital_input_bits);
+    getRecipeValue("actual_digital_output_bits", snapshot.digital_output_bits);
+    if (getRecipeValue("robot_mode", mode)) {
+        snapshot.robot_mode = static_cast<RobotMode>(mode);
+    }
+    if (getRecipeValue("safety_status", mode)) {
+        snapshot.safety_status = static_cast<SafetyMode>(mode);
+    }
+    if (getRecipeValue("runtime_state", state)) {
+        snapshot.runtime_state = static_cast<TaskStatus>(state);
+    }
+    publisher->publish(snapshot);
+}
+
 void RtsiIOInterface::recvLoop() {
     // Calculate the ideal cycle time.
     double period_ms = (1 / target_frequency_) * 1000;
     ELITE_LOG_INFO("RTSI IO interface sync thread start, period %lfms", period_ms);
     while (is_recv_thread_alive_) {
         try {
-            receiveData(output_recipe_, false);
+            if (receiveData(output_recipe_, false) && !first_data_received_) {
+                std::lock_guard<std::mutex> lock(first_data_mutex_);
+                first_data_received_ = true;
+                first_data_cv_.notify_all();
+            }
+            if (!isConnected()) {
+                // The receive timed out and closed the socket
+                throw EliteException(EliteException::Code::SOCKET_FAIL, "receive data package timeout");
+            }
+            updateStateMonitor();
+            updateStatePublisher();
             if (input_new_cmd_) {
                 send(input_recipe_);
                 input_new_cmd_ = false;
             }
         } catch(const std::exception& e) {
-            is_recv_thread_alive_ = false;
+            ELITE_LOG_ERROR_THROTTLE(recv_log_throttle_, 1000, "RTSI IO interface receive fail: %s", e.what());
+            bool restored = reconnect_->run([this]() { return restoreConnection(); },
+                                            [this]() { return is_recv_thread_alive_.load(); });
+            if (!restored) {
+                is_recv_thread_alive_ = false;
+                reconnect_->setState(LinkState::DISCONNECTED);
+            }
         }
     }
     ELITE_LOG_INFO("RTSI IO interface sync thread dropped");
@@ -265,4 +265,12 @@ std::vector<uint8_t> RtsiRecipeInternal::packToBytes() {
 
 #endif
     return result;
-}
\ No newline at end of file
+}
+
+void RtsiRecipeInternal::copyValues(std::vector<RtsiTypeVariant>& out) {
+    std::lock_guard<std::mutex> lock(update_mutex_);
+    out.resize(recipe_list_.size());
+    for (size_t i = 0; i < recipe_list_.size(); i++) {
+        out[i] = value_table_[recipe_list_[i]];
+    }
+}
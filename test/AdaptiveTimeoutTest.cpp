@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include "Elite/AdaptiveTimeout.hpp"
+
+using namespace ELITE;
+using namespace std::chrono;
+
+TEST(AdaptiveTimeoutTest, follows_the_interval_percentile) {
+    AdaptiveTimeoutOptions options;
+    options.percentile = 0.99;
+    options.scale = 1.5;
+    options.margin_ms = 2;
+    options.min_timeout_ms = 1;
+    options.min_samples = 100;
+    AdaptiveTimeout timeout(options);
+    steady_clock::time_point now;
+    // The requested timeout until enough intervals are measured
+    for (int i = 0; i < 100; i++) {
+        EXPECT_EQ(timeout.update(now, 100), 100);
+        now += microseconds(4000);
+    }
+    // 4 ms sends, every 50th one 10 ms late
+    for (int i = 0; i < 1000; i++) {
+        timeout.update(now, 100);
+        now += microseconds(i % 50 == 0 ? 14000 : 4000);
+    }
+    AdaptiveTimeoutStatistics statistics = timeout.getStatistics();
+    EXPECT_TRUE(statistics.adapted);
+    EXPECT_EQ(statistics.intervals, 1099);
+    // 2% of the intervals are 14 ms, so the 99th percentile is one of them
+    EXPECT_EQ(statistics.percentile_interval, microseconds(14100));
+    EXPECT_EQ(statistics.timeout_ms, 24);
+    EXPECT_EQ(statistics.max_interval, microseconds(14000));
+    EXPECT_NEAR(statistics.mean_interval.count(), 4182, 1);
+
+    // Without the late sends the timeout shrinks
+    for (int i = 0; i < 10000; i++) {
+        timeout.update(now, 100);
+        now += microseconds(4000);
+    }
+    statistics = timeout.getStatistics();
+    EXPECT_EQ(statistics.percentile_interval, microseconds(4100));
+    EXPECT_EQ(statistics.timeout_ms, 9);
+    EXPECT_EQ(statistics.max_interval, microseconds(4000));
+}
+
+TEST(AdaptiveTimeoutTest, late_sends_and_restart) {
+    AdaptiveTimeoutOptions options;
+    options.min_samples = 10;
+    AdaptiveTimeout timeout(options);
+    steady_clock::time_point now;
+    for (int i = 0; i < 100; i++) {
+        timeout.update(now, 20);
+        now += milliseconds(2);
+    }
+    // 2 ms * 1.5 + 5 ms, raised to the minimum
+    EXPECT_EQ(timeout.getStatistics().timeout_ms, options.min_timeout_ms);
+
+    // A stall longer than the timeout
+    now += milliseconds(50);
+    timeout.update(now, 20);
+    EXPECT_EQ(timeout.getStatistics().late, 1);
+
+    // A pause after a restart, e.g. a change of mode, is not measured
+    timeout.restart();
+    now += milliseconds(500);
+    timeout.update(now, 20);
+    AdaptiveTimeoutStatistics statistics = timeout.getStatistics();
+    EXPECT_EQ(statistics.late, 1);
+    EXPECT_EQ(statistics.intervals, 100);
+
+    // A blocking read is passed through, and the pause after it is not measured
+    EXPECT_EQ(timeout.update(now, 0), 0);
+    EXPECT_EQ(timeout.getStatistics().timeout_ms, 0);
+    now += milliseconds(500);
+    EXPECT_EQ(timeout.update(now, 20), options.min_timeout_ms);
+    statistics = timeout.getStatistics();
+    EXPECT_EQ(statistics.late, 1);
+    EXPECT_EQ(statistics.intervals, 100);
+
+    timeout.reset();
+    statistics = timeout.getStatistics();
+    EXPECT_EQ(statistics.intervals, 0);
+    EXPECT_FALSE(statistics.adapted);
+    EXPECT_EQ(timeout.update(now, 30), 30);
+}
+
+TEST(AdaptiveTimeoutTest, bounds) {
+    AdaptiveTimeoutOptions options;
+    options.min_samples = 10;
+    options.max_timeout_ms = 200;
+    AdaptiveTimeout timeout(options);
+    steady_clock::time_point now;
+    // Intervals beyond the histogram
+    for (int i = 0; i < 20; i++) {
+        timeout.update(now, 20);
+        now += milliseconds(300);
+    }
+    EXPECT_EQ(timeout.getStatistics().timeout_ms, 200);
+
+    options.percentile = 0;
+    EXPECT_ANY_THROW(AdaptiveTimeout invalid(options));
+    options.percentile = 0.99;
+    options.min_timeout_ms = 300;
+    EXPECT_ANY_THROW(AdaptiveTimeout invalid(options));
+}
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+
+#include "Elite/CartesianSpeedConverter.hpp"
+
+using namespace ELITE;
+
+static const double PI = std::acos(-1.0);
+
+// Nominal DH parameters of a 6-axis CS arm
+static const vector6d_t DH_A = {0, -0.427, -0.3905, 0, 0, 0};
+static const vector6d_t DH_D = {0.1632, 0, 0, 0.1545, 0.1165, 0.1035};
+static const vector6d_t DH_ALPHA = {PI / 2, 0, 0, PI / 2, -PI / 2, 0};
+
+// A configuration well away from every singularity
+static const vector6d_t REGULAR = {0.3, -1.2, 1.4, -0.5, 1.1, 0.2};
+
+static vector6d_t multiply(const Matrix6d& m, const vector6d_t& v) {
+    vector6d_t r{};
+    for (int row = 0; row < 6; row++) {
+        for (int k = 0; k < 6; k++) {
+            r[row] += m[row * 6 + k] * v[k];
+        }
+    }
+    return r;
+}
+
+TEST(CartesianSpeedConverterTest, exact_away_from_singularities) {
+    Kinematics kin(DH_A, DH_D, DH_ALPHA);
+    kin.setTcpOffset({0, 0, 0.1, 0, 0, 0});
+    CartesianSpeedConverter converter(kin);
+    vector6d_t tcp_speed = {0.05, -0.02, 0.03, 0.1, 0, -0.2};
+    SingularityMetrics metrics;
+    vector6d_t speed = converter.toJointSpeed(REGULAR, tcp_speed, &metrics);
+    EXPECT_EQ(metrics.damping, 0);
+    EXPECT_EQ(metrics.speed_scale, 1);
+    EXPECT_GT(metrics.manipulability, converter.getOptions().manipulability_threshold);
+    // J q' gives back the TCP velocity
+    vector6d_t back = multiply(kin.jacobian(REGULAR), speed);
+    for (int i = 0; i < 6; i++) {
+        EXPECT_NEAR(back[i], tcp_speed[i], 1e-9);
+    }
+}
+
+TEST(CartesianSpeedConverterTest, metrics) {
+    Kinematics kin(DH_A, DH_D, DH_ALPHA);
+    CartesianSpeedConverter converter(kin);
+    // For the CS geometry |det J| is the product of the three terms and the elbow link lengths
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> dist(-PI, PI);
+    for (int n = 0; n < 100; n++) {
+        vector6d_t q;
+        for (auto& v : q) {
+            v = dist(rng);
+        }
+        SingularityMetrics m = converter.singularity(q);
+        EXPECT_NEAR(m.manipulability, std::fabs(DH_A[1] * DH_A[2]) * m.wrist * m.elbow * m.shoulder, 1e-9);
+    }
+
+    vector6d_t wrist = REGULAR;
+    wrist[4] = 0;
+    EXPECT_NEAR(converter.singularity(wrist).wrist, 0, 1e-12);
+    EXPECT_NEAR(converter.singularity(wrist).manipulability, 0, 1e-12);
+    vector6d_t elbow = REGULAR;
+    elbow[2] = 0;
+    EXPECT_NEAR(converter.singularity(elbow).elbow, 0, 1e-12);
+    EXPECT_NEAR(converter.singularity(elbow).manipulability, 0, 1e-12);
+}
+
+TEST(CartesianSpeedConverterTest, bounded_at_singularity) {
+    Kinematics kin(DH_A, DH_D, DH_ALPHA);
+    CartesianSpeedConverter converter(kin);
+    // Approach the wrist singularity; the joint speeds stay bounded and the damping grows
+    double previous_damping = 0;
+    for (double q5 : {1e-2, 1e-3, 1e-5, 0.0}) {
+        vector6d_t q = REGULAR;
+        q[4] = q5;
+        SingularityMetrics metrics;
+        vector6d_t speed = converter.toJointSpeed(q, {0.05, 0.05, 0, 0, 0.1, 0}, &metrics);
+        EXPECT_GE(metrics.damping, previous_damping);
+        previous_damping = metrics.damping;
+        for (double v : speed) {
+            EXPECT_TRUE(std::isfinite(v));
+            EXPECT_LT(std::fabs(v), 10);
+        }
+    }
+    EXPECT_NEAR(previous_damping, converter.getOptions().max_damping, 1e-12);
+
+    // Without damping the plain inverse is unbounded, and exactly at the singularity nothing moves
+    CartesianSpeedOptions options;
+    options.max_damping = 0;
+    CartesianSpeedConverter undamped(kin, options);
+    vector6d_t near = REGULAR;
+    near[4] = 1e-5;
+    vector6d_t speed = undamped.toJointSpeed(near, {0.05, 0.05, 0, 0, 0.1, 0});
+    EXPECT_GT(std::fabs(speed[3]) + std::fabs(speed[5]), 10);
+}
+
+TEST(CartesianSpeedConverterTest, joint_speed_limit) {
+    Kinematics kin(DH_A, DH_D, DH_ALPHA);
+    CartesianSpeedOptions options;
+    options.max_joint_speed = {0.5, 0.5, 0.5, 0.5, 0.5, 0.5};
+    CartesianSpeedConverter limited(kin, options);
+    CartesianSpeedConverter free(kin);
+    vector6d_t tcp_speed = {0.5, 0, 0.3, 0, 0, 1.0};
+    vector6d_t unlimited = free.toJointSpeed(REGULAR, tcp_speed);
+    SingularityMetrics metrics;
+    vector6d_t speed = limited.toJointSpeed(REGULAR, tcp_speed, &metrics);
+    ASSERT_LT(metrics.speed_scale, 1);
+    double fastest = 0;
+    for (int i = 0; i < 6; i++) {
+        fastest = std::max(fastest, std::fabs(speed[i]));
+        // Same direction
+        EXPECT_NEAR(speed[i], unlimited[i] * metrics.speed_scale, 1e-12);
+    }
+    EXPECT_NEAR(fastest, 0.5, 1e-12);
+}
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
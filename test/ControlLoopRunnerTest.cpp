@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "Elite/ControlLoopRunner.hpp"
+#include "FakeRtsiServer.hpp"
+
+using namespace ELITE;
+using namespace std::chrono;
+
+// Records the commands instead of sending them to a robot
+class CommandRecorder {
+   public:
+    explicit CommandRecorder(int delay_us = 0) : delay_us_(delay_us) {}
+
+    ControlLoopRunner::Sender sender() {
+        return [this](const ControlLoopCommand& command, int timeout_ms) {
+            if (delay_us_ > 0) {
+                std::this_thread::sleep_for(microseconds(delay_us_));
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            commands_.push_back(command);
+            return true;
+        };
+    }
+
+    std::vector<ControlLoopCommand> commands() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return commands_;
+    }
+
+   private:
+    int delay_us_;
+    std::mutex mutex_;
+    std::vector<ControlLoopCommand> commands_;
+};
+
+TEST(ControlLoopRunnerTest, servo_cycle) {
+    FakeRtsiServer server;
+    RtsiHub hub(250);
+    ASSERT_TRUE(hub.connect("127.0.0.1"));
+    CommandRecorder recorder;
+    ControlLoopRunner runner(hub, recorder.sender());
+    std::atomic<int> cycles{0};
+    // Generous deadline, the test may run on a loaded machine
+    ControlLoopOptions options;
+    options.deadline_us = 20000;
+    ASSERT_TRUE(runner.start({"actual_joint_positions"}, [&](const RtsiSample& state) {
+        ControlLoopCommand command;
+        if (++cycles > 20) {
+            command.action = ControlLoopAction::STOP;
+            return command;
+        }
+        state.getValue("actual_joint_positions", command.target);
+        command.target[5] += 0.01;
+        command.action = ControlLoopAction::SERVOJ;
+        return command;
+    }, options));
+    EXPECT_FALSE(runner.start({}, [](const RtsiSample&) { return ControlLoopCommand(); }));
+
+    auto deadline = steady_clock::now() + 2s;
+    while (runner.isRunning() && steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(10ms);
+    }
+    EXPECT_FALSE(runner.isRunning());
+
+    auto commands = recorder.commands();
+    ASSERT_EQ(commands.size(), 21);
+    for (int i = 0; i < 20; i++) {
+        EXPECT_EQ(commands[i].action, ControlLoopAction::SERVOJ);
+        EXPECT_DOUBLE_EQ(commands[i].target[5], commands[i].target[0] + 0.01);
+    }
+    EXPECT_EQ(commands.back().action, ControlLoopAction::STOP);
+
+    ControlLoopStatistics stats = runner.getStatistics();
+    EXPECT_EQ(stats.cycles, 20);
+    EXPECT_EQ(stats.overruns, 0);
+    EXPECT_EQ(stats.send_failures, 0);
+    uint64_t histogram_total = 0;
+    for (auto count : stats.latency_histogram) {
+        histogram_total += count;
+    }
+    EXPECT_EQ(histogram_total, stats.cycles);
+    EXPECT_LE(stats.mean_latency, stats.max_latency);
+    EXPECT_LE(stats.max_latency.count(), options.deadline_us);
+    EXPECT_LE(stats.percentile(0.5), stats.percentile(1.0));
+    EXPECT_GE(stats.percentile(1.0), stats.max_latency);
+
+    // No command after the loop stopped
+    std::this_thread::sleep_for(50ms);
+    EXPECT_EQ(recorder.commands().size(), 21);
+    runner.resetStatistics();
+    EXPECT_EQ(runner.getStatistics().cycles, 0);
+    hub.disconnect();
+}
+
+TEST(ControlLoopRunnerTest, overrun_stop) {
+    FakeRtsiServer server;
+    RtsiHub hub(250);
+    ASSERT_TRUE(hub.connect("127.0.0.1"));
+    // Every command takes longer than the deadline
+    CommandRecorder recorder(2000);
+    ControlLoopRunner runner(hub, recorder.sender());
+    ControlLoopOptions options;
+    options.deadline_us = 500;
+    options.max_consecutive_overruns = 3;
+    ASSERT_TRUE(runner.start({"speed_scaling"}, [](const RtsiSample&) {
+        ControlLoopCommand command;
+        command.action = ControlLoopAction::SPEEDJ;
+        return command;
+    }, options));
+
+    auto deadline = steady_clock::now() + 2s;
+    while (runner.isRunning() && steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(10ms);
+    }
+    EXPECT_FALSE(runner.isRunning());
+    // isRunning() turns false before the STOP command is sent, stop() waits for that cycle
+    runner.stop();
+    ControlLoopStatistics stats = runner.getStatistics();
+    EXPECT_EQ(stats.cycles, 3);
+    EXPECT_EQ(stats.overruns, 3);
+    EXPECT_GE(stats.max_latency.count(), 2000);
+    auto commands = recorder.commands();
+    ASSERT_EQ(commands.size(), 4);
+    EXPECT_EQ(commands.back().action, ControlLoopAction::STOP);
+    hub.disconnect();
+}
+
+TEST(ControlLoopRunnerTest, stop_from_other_thread) {
+    FakeRtsiServer server;
+    RtsiHub hub(250);
+    ASSERT_TRUE(hub.connect("127.0.0.1"));
+    CommandRecorder recorder;
+    {
+        ControlLoopRunner runner(hub, recorder.sender());
+        ASSERT_TRUE(runner.start({"speed_scaling"}, [](const RtsiSample&) {
+            ControlLoopCommand command;
+            command.action = ControlLoopAction::SPEEDL;
+            return command;
+        }));
+        std::this_thread::sleep_for(50ms);
+        EXPECT_TRUE(runner.isRunning());
+        runner.stop();
+        EXPECT_FALSE(runner.isRunning());
+    }
+    size_t sent = recorder.commands().size();
+    EXPECT_GT(sent, 0);
+    // The runner is destroyed while the hub keeps running
+    std::this_thread::sleep_for(50ms);
+    EXPECT_EQ(recorder.commands().size(), sent);
+    EXPECT_TRUE(hub.isConnected());
+    hub.disconnect();
+}
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -1,4 +1,6 @@
 #include <gtest/gtest.h>
+#include <atomic>
+#include <boost/asio.hpp>
 #include <string>
 #include <thread>
 #include "Dashboard/DashboardClient.hpp"
@@ -64,6 +66,131 @@ TEST_F(DashboardClientTest, log_and_getters)
     EXPECT_TRUE(dashboard_client_->log("Program state: " + std::to_string((int)status)));
 }
 
+TEST_F(DashboardClientTest, pipeline) {
+    EXPECT_TRUE(dashboard_client_->connect(s_robot_ip));
+    std::vector<std::string> responses = dashboard_client_->sendAndReceivePipelined({"echo", "robotMode", "echo"});
+    ASSERT_EQ(responses.size(), 3);
+    EXPECT_EQ(responses[0], "Hello ELITE ROBOTS.\r\n");
+    EXPECT_EQ(responses[1].find("robotMode:"), 0);
+    EXPECT_EQ(responses[2], "Hello ELITE ROBOTS.\r\n");
+
+    int callback_count = 0;
+    dashboard_client_->setPipelineDepth(2);
+    auto first = dashboard_client_->pipelineCommand("echo", [&](bool success, const std::string& response) {
+        EXPECT_TRUE(success);
+        callback_count++;
+    });
+    auto second = dashboard_client_->pipelineCommand("echo");
+    auto third = dashboard_client_->pipelineCommand("echo");
+    EXPECT_LE(dashboard_client_->pipelineInFlight(), 2);
+    // Blocking command is answered after the pipelined commands
+    EXPECT_TRUE(dashboard_client_->echo());
+    EXPECT_EQ(dashboard_client_->pipelineInFlight(), 0);
+    EXPECT_EQ(first.get(), "Hello ELITE ROBOTS.\r\n");
+    EXPECT_EQ(second.get(), "Hello ELITE ROBOTS.\r\n");
+    EXPECT_EQ(third.get(), "Hello ELITE ROBOTS.\r\n");
+    EXPECT_EQ(callback_count, 1);
+}
+
+TEST(DashboardClientAsyncTest, shared_executor) {
+    auto executor = std::make_shared<DashboardExecutor>();
+    DashboardClient first(executor);
+    DashboardClient second(executor);
+    auto first_connect = first.connectAsync(s_robot_ip);
+    auto second_connect = second.connectAsync(s_robot_ip);
+    ASSERT_TRUE(first_connect.get());
+    ASSERT_TRUE(second_connect.get());
+
+    auto mode = first.robotModeAsync();
+    auto echo = second.echoAsync();
+    EXPECT_NE(mode.get(), RobotMode::UNKNOWN);
+    EXPECT_TRUE(echo.get());
+    // Blocking functions wait for the executor
+    EXPECT_TRUE(first.echo());
+
+    DashboardAsyncOptions options;
+    options.cancel_token = DashboardClient::makeCancelToken();
+    auto version = second.versionAsync(options);
+    second.cancel(options.cancel_token);
+    try {
+        EXPECT_FALSE(version.get().empty());
+    } catch (const EliteException& e) {
+        EXPECT_TRUE(e == EliteException::Code::SOCKET_OPT_CANCEL);
+    }
+    // The cancelled response is dropped, the next response still matches its command
+    EXPECT_EQ(second.sendAndReceiveAsync("echo").get(), "Hello ELITE ROBOTS.\r\n");
+}
+
+TEST(DashboardClientAsyncTest, connect_fail) {
+    DashboardClient client;
+    try {
+        client.connect("not an ip");
+        FAIL() << "connect() should throw for an invalid IP";
+    } catch (const EliteException& e) {
+        EXPECT_TRUE(e == EliteException::Code::SOCKET_CONNECT_FAIL);
+    }
+    // Nothing listens on the port
+    EXPECT_FALSE(client.connect("127.0.0.1", 1));
+}
+
+TEST(DashboardClientAsyncTest, state_wait_on_monitor) {
+    // A local dashboard server which accepts power on and counts the robot mode polls
+    boost::asio::io_context io_context;
+    boost::asio::ip::tcp::acceptor acceptor(io_context, boost::asio::ip::tcp::endpoint(boost::asio::ip::tcp::v4(), 0));
+    int port = acceptor.local_endpoint().port();
+    std::atomic<int> mode_polls(0);
+    std::thread server([&]() {
+        boost::asio::ip::tcp::socket socket(io_context);
+        acceptor.accept(socket);
+        boost::system::error_code ec;
+        boost::asio::write(socket, boost::asio::buffer(std::string("Connected: Elite Robot Dashboard Server\r\n")), ec);
+        boost::asio::streambuf buffer;
+        while (!ec) {
+            boost::asio::read_until(socket, buffer, '\n', ec);
+            if (ec) {
+                break;
+            }
+            std::istream stream(&buffer);
+            std::string line;
+            std::getline(stream, line);
+            if (line == "robotControl -on") {
+                boost::asio::write(socket, boost::asio::buffer(std::string("Powering on\r\n")), ec);
+            } else if (line == "robotMode") {
+                mode_polls++;
+                boost::asio::write(socket, boost::asio::buffer(std::string("robotMode: POWER_OFF\r\n")), ec);
+            }
+        }
+    });
+
+    auto monitor = std::make_shared<RobotStateMonitor>();
+    monitor->updateRobotMode(RobotMode::POWER_OFF);
+    std::atomic<bool> feeding(true);
+    std::atomic<bool> powered(false);
+    std::thread feeder([&]() {
+        while (feeding) {
+            monitor->updateRobotMode(powered ? RobotMode::IDLE : RobotMode::POWER_OFF);
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+    });
+    {
+        DashboardClient client(std::make_shared<DashboardExecutor>());
+        client.setStateMonitor(monitor);
+        ASSERT_TRUE(client.connectAsync("127.0.0.1", port).get());
+        auto power_on = client.powerOnAsync();
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        EXPECT_EQ(power_on.wait_for(std::chrono::seconds(0)), std::future_status::timeout);
+        powered = true;
+        ASSERT_EQ(power_on.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+        EXPECT_TRUE(power_on.get());
+        // The updates of the monitor woke the wait, the dashboard is not polled
+        EXPECT_EQ(mode_polls, 0);
+        client.disconnect();
+    }
+    feeding = false;
+    feeder.join();
+    server.join();
+}
+
 int main(int argc, char** argv) {
     if(argc >= 2) {
         s_robot_ip = argv[1];
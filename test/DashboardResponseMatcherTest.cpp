@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include "Dashboard/DashboardResponseMatcher.hpp"
+
+using namespace ELITE;
+
+static const std::vector<std::string> s_patterns = {
+    "Hello ELITE ROBOTS.\r\n",
+    "robotMode:.*",
+    "robotMode: RUNNING\r\n",
+    "robotMode: (RUNNING|IDLE)\r\n",
+    "Safety status:.*",
+    "Task is .*",
+    "Brake (Releasing.*|is released).*",
+    "closing .* dialog\r\n",
+    "Relative path:test.task\r\n",
+};
+
+static const std::vector<std::string> s_responses = {
+    "Hello ELITE ROBOTS.\r\n",
+    "Hello ELITE ROBOTSx\r\n",
+    "Hello ELITE ROBOTS\r\r\n",
+    "robotMode: RUNNING\r\n",
+    "robotMode: IDLE\r\n",
+    "robotMode: POWER_OFF\r\n",
+    "xx robotMode: RUNNING",
+    "Safety status: NORMAL\r\n",
+    "Task is running\r\n",
+    "Task is \r\n",
+    "Brake is released\r\n",
+    "Brake Releasing\r\n",
+    "closing safety dialog\r\n",
+    "Relative path:test.task\r\n",
+    "Relative path:testxtask\r\n",
+    "",
+};
+
+TEST(DASHBOARD_RESPONSE_MATCHER, same_as_regex) {
+    for (auto& pattern : s_patterns) {
+        DashboardResponseMatcher matcher(pattern);
+        std::regex regex(pattern);
+        for (auto& response : s_responses) {
+            std::smatch regex_match;
+            bool regex_found = std::regex_search(response, regex_match, regex);
+            std::string matched;
+            EXPECT_EQ(matcher.search(response, matched), regex_found) << pattern << " / " << response;
+            if (regex_found) {
+                EXPECT_EQ(matched, regex_match[0].str()) << pattern << " / " << response;
+            }
+            EXPECT_EQ(matcher.match(response), std::regex_match(response, regex)) << pattern << " / " << response;
+        }
+    }
+}
+
+TEST(DASHBOARD_RESPONSE_MATCHER, cache) {
+    auto first = DashboardResponseMatcher::get("robotMode:.*");
+    auto second = DashboardResponseMatcher::get("robotMode:.*");
+    EXPECT_EQ(first.get(), second.get());
+}
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
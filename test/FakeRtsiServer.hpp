@@ -0,0 +1,273 @@
+#ifndef __FAKE_RTSI_SERVER_HPP__
+#define __FAKE_RTSI_SERVER_HPP__
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/asio.hpp>
+
+#include "Utils.hpp"
+
+// A local RTSI server on port 30004 for the tests that need no robot.
+// Answers the handshake requests and the recipe setups of a few known fields, and sends data packages of the latest
+// output recipe after start. In the package n every double is n * 0.004, unless fixed by setDouble(), and "robot_mode"
+// is 7. Accepts a new connection after the previous one is closed.
+class FakeRtsiServer {
+   public:
+    FakeRtsiServer() : acceptor_(io_context_, boost::asio::ip::tcp::endpoint(boost::asio::ip::tcp::v4(), 30004)) {
+        thread_ = std::thread([this]() { serve(); });
+    }
+
+    ~FakeRtsiServer() {
+        is_alive_ = false;
+        // Wake up the blocking accept
+        boost::system::error_code ec;
+        boost::asio::ip::tcp::socket waker(io_context_);
+        waker.connect(boost::asio::ip::tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"), 30004), ec);
+        acceptor_.close(ec);
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    // Send a fixed value for a DOUBLE field instead of n * 0.004
+    void setDouble(const std::string& field, double value) {
+        std::lock_guard<std::mutex> lock(recipe_mutex_);
+        fixed_doubles_[field] = value;
+    }
+
+    // The number of output recipe setups, of all connections
+    int outputSetups() { return output_setups_; }
+
+    // The number of requests already received when the first one of the connection is answered
+    int firstBurst() { return first_burst_; }
+
+    // Shut down the current connection, as if the cable is unplugged and plugged in again
+    void dropClient() {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        if (client_) {
+            boost::system::error_code ec;
+            client_->shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+        }
+    }
+
+    int connections() { return connections_; }
+
+    // Reject the protocol version requests, the other requests are still answered
+    void setProtocolAccepted(bool accepted) { protocol_accepted_ = accepted; }
+
+    // The number of input data packages received in the current connection
+    int inputPackages() { return input_packages_; }
+
+   private:
+    boost::asio::io_context io_context_;
+    boost::asio::ip::tcp::acceptor acceptor_;
+    std::thread thread_;
+    std::atomic<bool> is_alive_{true};
+    std::atomic<bool> protocol_accepted_{true};
+    std::atomic<int> output_setups_{0};
+    std::atomic<int> first_burst_{0};
+    std::atomic<int> connections_{0};
+    std::atomic<int> input_packages_{0};
+    std::mutex write_mutex_;
+    boost::asio::ip::tcp::socket* client_ = nullptr;
+    std::mutex recipe_mutex_;
+    uint8_t next_recipe_id_ = 0;
+    uint8_t output_recipe_id_ = 0;
+    std::vector<std::string> output_recipe_;
+    std::map<std::string, double> fixed_doubles_;
+
+    const std::map<std::string, std::string> known_types_ = {
+        {"timestamp", "DOUBLE"},
+        {"speed_scaling", "DOUBLE"},
+        {"actual_joint_positions", "VECTOR6D"},
+        {"robot_mode", "INT32"},
+        {"speed_slider_mask", "UINT32"},
+    };
+
+    bool write(boost::asio::ip::tcp::socket& socket, char type, const std::vector<uint8_t>& payload) {
+        std::vector<uint8_t> message = {(uint8_t)((payload.size() + 3) >> 8), (uint8_t)(payload.size() + 3), (uint8_t)type};
+        message.insert(message.end(), payload.begin(), payload.end());
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        boost::system::error_code ec;
+        boost::asio::write(socket, boost::asio::buffer(message), ec);
+        return !ec;
+    }
+
+    template <typename T>
+    static void append(std::vector<uint8_t>& payload, T value) {
+        auto bytes = ELITE::UTILS::EndianUtils::pack(value);
+        payload.insert(payload.end(), bytes.begin(), bytes.end());
+    }
+
+    // Answer a recipe setup with the recipe id and the types, the id is 0 if a field is unknown
+    std::vector<uint8_t> setupRecipe(const std::string& names, bool output) {
+        std::vector<std::string> fields = ELITE::UTILS::StringUtils::splitString(names, ",");
+        std::string types;
+        bool known = true;
+        for (auto& field : fields) {
+            auto iter = known_types_.find(field);
+            known = known && iter != known_types_.end();
+            types += (types.empty() ? "" : ",") + (iter == known_types_.end() ? "NOT_FOUND" : iter->second);
+        }
+        std::vector<uint8_t> payload;
+        {
+            std::lock_guard<std::mutex> lock(recipe_mutex_);
+            uint8_t id = 0;
+            if (known) {
+                id = ++next_recipe_id_;
+                if (output) {
+                    output_recipe_id_ = id;
+                    output_recipe_ = fields;
+                }
+            }
+            payload.push_back(id);
+        }
+        payload.insert(payload.end(), types.begin(), types.end());
+        return payload;
+    }
+
+    void serve() {
+        while (is_alive_) {
+            boost::system::error_code ec;
+            boost::asio::ip::tcp::socket socket(io_context_);
+            acceptor_.accept(socket, ec);
+            if (ec || !is_alive_) {
+                return;
+            }
+            socket.set_option(boost::asio::ip::tcp::no_delay(true));
+            {
+                std::lock_guard<std::mutex> lock(write_mutex_);
+                client_ = &socket;
+            }
+            connections_++;
+            input_packages_ = 0;
+            serveClient(socket);
+            std::lock_guard<std::mutex> lock(write_mutex_);
+            client_ = nullptr;
+        }
+    }
+
+    void serveClient(boost::asio::ip::tcp::socket& socket) {
+        boost::system::error_code ec;
+        std::atomic<bool> started{false};
+        std::thread data_thread;
+        bool first = true;
+        while (is_alive_) {
+            uint8_t head[3];
+            boost::asio::read(socket, boost::asio::buffer(head), ec);
+            if (ec) {
+                break;
+            }
+            std::vector<uint8_t> body(((head[0] << 8) | head[1]) - 3);
+            boost::asio::read(socket, boost::asio::buffer(body), ec);
+            if (ec) {
+                break;
+            }
+            if (first) {
+                // Give the client time to send the following requests
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                size_t available = socket.available();
+                int count = 1;
+                std::vector<uint8_t> pending(available);
+                boost::asio::read(socket, boost::asio::buffer(pending), ec);
+                for (size_t i = 0; i + 3 <= pending.size(); i += (pending[i] << 8) | pending[i + 1]) {
+                    count++;
+                }
+                first_burst_ = count;
+                first = false;
+                // Put the pending requests back in order
+                handle(socket, head[2], body, started, data_thread);
+                for (size_t i = 0; i + 3 <= pending.size(); i += (pending[i] << 8) | pending[i + 1]) {
+                    size_t len = (pending[i] << 8) | pending[i + 1];
+                    handle(socket, pending[i + 2],
+                           std::vector<uint8_t>(pending.begin() + i + 3, pending.begin() + i + len), started, data_thread);
+                }
+                continue;
+            }
+            handle(socket, head[2], body, started, data_thread);
+        }
+        started = false;
+        if (data_thread.joinable()) {
+            data_thread.join();
+        }
+    }
+
+    void handle(boost::asio::ip::tcp::socket& socket, uint8_t type, const std::vector<uint8_t>& body,
+                std::atomic<bool>& started, std::thread& data_thread) {
+        switch (type) {
+            case 'V':
+                write(socket, 'V', {(uint8_t)(protocol_accepted_ ? 1 : 0)});
+                break;
+            case 'v': {
+                std::vector<uint8_t> payload;
+                for (uint32_t v : {2u, 14u, 3u, 100u}) {
+                    append(payload, v);
+                }
+                write(socket, 'v', payload);
+                break;
+            }
+            case 'I':
+                write(socket, 'I', setupRecipe(std::string(body.begin(), body.end()), false));
+                break;
+            case 'O':
+                // 8 bytes of frequency, then the comma separated names
+                write(socket, 'O', setupRecipe(std::string(body.begin() + 8, body.end()), true));
+                output_setups_++;
+                break;
+            case 'S':
+                write(socket, 'S', {1});
+                started = true;
+                data_thread = std::thread([this, &socket, &started]() {
+                    double count = 0;
+                    while (started) {
+                        count += 1;
+                        std::vector<uint8_t> payload;
+                        {
+                            std::lock_guard<std::mutex> lock(recipe_mutex_);
+                            payload.push_back(output_recipe_id_);
+                            for (auto& field : output_recipe_) {
+                                const std::string& type = known_types_.at(field);
+                                auto fixed = fixed_doubles_.find(field);
+                                if (type == "DOUBLE") {
+                                    append(payload, fixed == fixed_doubles_.end() ? count * 0.004 : fixed->second);
+                                } else if (type == "VECTOR6D") {
+                                    for (int i = 0; i < 6; i++) {
+                                        append(payload, count * 0.004);
+                                    }
+                                } else if (type == "UINT32") {
+                                    append(payload, (uint32_t)0);
+                                } else {
+                                    append(payload, (int32_t)7);
+                                }
+                            }
+                        }
+                        if (!write(socket, 'U', payload)) {
+                            break;
+                        }
+                        std::this_thread::sleep_for(std::chrono::milliseconds(4));
+                    }
+                });
+                break;
+            case 'U':
+                input_packages_++;
+                break;
+            case 'P':
+                started = false;
+                if (data_thread.joinable()) {
+                    data_thread.join();
+                }
+                write(socket, 'P', {1});
+                break;
+            default:
+                break;
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "Elite/JointLimitValidator.hpp"
+
+using namespace ELITE;
+
+static const vector6d_t LIMIT_MIN = {-6.28, -6.28, -3.14, -6.28, -6.28, -6.28};
+static const vector6d_t LIMIT_MAX = {6.28, 6.28, 3.14, 6.28, 6.28, 6.28};
+static const vector6d_t MAX_VELOCITY = {2.0, 2.0, 3.0, 3.0, 3.0, 3.0};
+static const vector6d_t MAX_ACC = {10, 10, 10, 20, 20, 20};
+
+// A smooth motion well inside the limits
+static vector6d_t sinePoint(double t) {
+    return {0.5 * std::sin(t), -1.0 + 0.3 * std::cos(t), 1.2, 0.02 * t, 0.1, -0.5 * std::sin(2 * t)};
+}
+
+static Vector6dBatch sineStream(size_t count, double period) {
+    Vector6dBatch points(count);
+    for (size_t i = 0; i < count; i++) {
+        points.set(i, sinePoint(i * period));
+    }
+    return points;
+}
+
+static void packDouble(std::vector<uint8_t>& bytes, double value) {
+    uint8_t raw[8];
+    std::memcpy(raw, &value, 8);
+    // Big-endian on the wire
+    for (int i = 7; i >= 0; i--) {
+        bytes.push_back(raw[i]);
+    }
+}
+
+TEST(JointLimitValidatorTest, parse_limits) {
+    std::vector<uint8_t> bytes = {0, 0, 0, 0, 6};
+    for (int j = 0; j < 6; j++) {
+        packDouble(bytes, LIMIT_MIN[j]);
+        packDouble(bytes, LIMIT_MAX[j]);
+    }
+    for (int j = 0; j < 6; j++) {
+        packDouble(bytes, MAX_VELOCITY[j]);
+        packDouble(bytes, MAX_ACC[j]);
+    }
+    JointLimitsInfo info;
+    info.parser((int)bytes.size(), bytes.cbegin());
+    EXPECT_EQ(info.limit_min_, LIMIT_MIN);
+    EXPECT_EQ(info.limit_max_, LIMIT_MAX);
+    EXPECT_EQ(info.max_velocity_, MAX_VELOCITY);
+    EXPECT_EQ(info.max_acc_, MAX_ACC);
+
+    JointLimitValidator validator(info);
+    EXPECT_EQ(validator.getMaxVelocity(), MAX_VELOCITY);
+}
+
+TEST(JointLimitValidatorTest, servo_stream) {
+    JointLimitValidator validator(LIMIT_MIN, LIMIT_MAX, MAX_VELOCITY, MAX_ACC);
+    const double period = 0.004;
+    Vector6dBatch points = sineStream(10000, period);
+    EXPECT_TRUE(validator.validate(points, period).isValid());
+    EXPECT_TRUE(validator.validate(points, period, sinePoint(-period)).isValid());
+    // From standstill the first step is too sudden
+    EXPECT_EQ(validator.validate(points, period, points.get(0)).type, LimitViolation::Type::ACCELERATION);
+
+    // Violations at block edges and at the ends, each found at its own index
+    for (size_t index : {(size_t)0, (size_t)1, (size_t)2, (size_t)255, (size_t)256, (size_t)257, (size_t)9999}) {
+        Vector6dBatch bad = points;
+        bad.values[2][index] = 3.2;
+        LimitViolation v = validator.validate(bad, period);
+        EXPECT_EQ(v.type, LimitViolation::Type::POSITION) << index;
+        EXPECT_EQ(v.index, index);
+        EXPECT_EQ(v.joint, 2);
+        EXPECT_EQ(v.value, 3.2);
+        EXPECT_EQ(v.limit, LIMIT_MAX[2]);
+    }
+
+    // A step of 0.01 rad in one period is 2.5 rad/s
+    Vector6dBatch step = points;
+    for (size_t i = 5000; i < step.size(); i++) {
+        step.values[0][i] += 0.01;
+    }
+    LimitViolation v = validator.validate(step, period);
+    EXPECT_EQ(v.type, LimitViolation::Type::VELOCITY);
+    EXPECT_EQ(v.index, 5000);
+    EXPECT_EQ(v.joint, 0);
+
+    // A small step passes the velocity limit but not the acceleration limit
+    Vector6dBatch kink = points;
+    for (size_t i = 7000; i < kink.size(); i++) {
+        kink.values[4][i] += 0.001 * (i - 6999);
+    }
+    v = validator.validate(kink, period);
+    EXPECT_EQ(v.type, LimitViolation::Type::ACCELERATION);
+    EXPECT_EQ(v.index, 7000);
+    EXPECT_EQ(v.joint, 4);
+
+    // The first point is checked against the start
+    vector6d_t start = sinePoint(-period);
+    start[1] += 0.1;
+    v = validator.validate(points, period, start);
+    EXPECT_EQ(v.type, LimitViolation::Type::VELOCITY);
+    EXPECT_EQ(v.index, 0);
+    EXPECT_EQ(v.joint, 1);
+}
+
+TEST(JointLimitValidatorTest, matches_frame_by_frame) {
+    JointLimitValidator validator(LIMIT_MIN, LIMIT_MAX, MAX_VELOCITY, MAX_ACC);
+    const double period = 0.002;
+    std::mt19937 rng(6);
+    std::uniform_int_distribution<size_t> where(0, 2999);
+    std::uniform_int_distribution<int> joint(0, 5);
+    std::uniform_real_distribution<double> size(-0.02, 0.02);
+    for (int n = 0; n < 50; n++) {
+        Vector6dBatch points = sineStream(3000, period);
+        points.values[joint(rng)][where(rng)] += size(rng);
+        vector6d_t start = sinePoint(-period);
+        LimitViolation batch = validator.validate(points, period, start);
+
+        LimitViolation frame;
+        validator.reset(start);
+        for (size_t i = 0; i < points.size() && frame.isValid(); i++) {
+            frame = validator.checkServo(points.get(i), period);
+        }
+        EXPECT_EQ(batch.type, frame.type);
+        EXPECT_EQ(batch.index, frame.index);
+        EXPECT_EQ(batch.joint, frame.joint);
+    }
+}
+
+TEST(JointLimitValidatorTest, check_servo_keeps_last_accepted) {
+    JointLimitValidator validator(LIMIT_MIN, LIMIT_MAX, MAX_VELOCITY, {0, 0, 0, 0, 0, 0});
+    validator.reset({0, 0, 0, 0, 0, 0});
+    EXPECT_TRUE(validator.checkServo({0.001, 0, 0, 0, 0, 0}, 0.002).isValid());
+    LimitViolation v = validator.checkServo({0.5, 0, 0, 0, 0, 0}, 0.002);
+    EXPECT_EQ(v.type, LimitViolation::Type::VELOCITY);
+    EXPECT_EQ(v.index, 1);
+    // Checked against the last accepted frame, not the rejected one
+    EXPECT_TRUE(validator.checkServo({0.002, 0, 0, 0, 0, 0}, 0.002).isValid());
+}
+
+TEST(JointLimitValidatorTest, trajectory_points) {
+    JointLimitValidator validator(LIMIT_MIN, LIMIT_MAX, MAX_VELOCITY, MAX_ACC);
+    vector6d_t start = {0, -1, 1, 0, 0, 0};
+    std::vector<TrajectoryWaypoint> points(3);
+    points[0].positions = {0.5, -1, 1, 0, 0, 0};
+    points[0].time = 1;
+    points[1].positions = {1.0, -1, 1, 0, 0, 0};
+    points[1].time = 0.5;
+    points[2].positions = {1.0, -1, 1, 0.5, 0, 0};
+    points[2].time = 1;
+    EXPECT_TRUE(validator.validate(points, start).isValid());
+
+    // 1 rad in 0.25 s is beyond 2 rad/s
+    points[1].positions[0] = 1.5;
+    points[1].time = 0.25;
+    LimitViolation v = validator.validate(points, start);
+    EXPECT_EQ(v.type, LimitViolation::Type::VELOCITY);
+    EXPECT_EQ(v.index, 1);
+    EXPECT_DOUBLE_EQ(v.value, 4);
+
+    points[1].positions[0] = 1.0;
+    points[1].time = 0;
+    EXPECT_EQ(validator.validate(points, start).type, LimitViolation::Type::VELOCITY);
+}
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
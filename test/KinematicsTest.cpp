@@ -0,0 +1,244 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+
+#include "Elite/Kinematics.hpp"
+
+using namespace ELITE;
+
+static const double PI = std::acos(-1.0);
+
+// Nominal DH parameters of a 6-axis CS arm
+static const vector6d_t DH_A = {0, -0.427, -0.3905, 0, 0, 0};
+static const vector6d_t DH_D = {0.1632, 0, 0, 0.1545, 0.1165, 0.1035};
+static const vector6d_t DH_ALPHA = {PI / 2, 0, 0, PI / 2, -PI / 2, 0};
+
+// Plain 4x4 DH chain, independent of the implementation
+static std::array<double, 16> referenceForward(const vector6d_t& q) {
+    std::array<double, 16> t = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+    for (int i = 0; i < 6; i++) {
+        double ct = std::cos(q[i]), st = std::sin(q[i]), ca = std::cos(DH_ALPHA[i]), sa = std::sin(DH_ALPHA[i]);
+        std::array<double, 16> link = {ct, -st * ca, st * sa, DH_A[i] * ct, st, ct * ca, -ct * sa, DH_A[i] * st,
+                                       0,  sa,       ca,      DH_D[i],      0,  0,       0,        1};
+        std::array<double, 16> r{};
+        for (int row = 0; row < 4; row++) {
+            for (int col = 0; col < 4; col++) {
+                for (int k = 0; k < 4; k++) {
+                    r[row * 4 + col] += t[row * 4 + k] * link[k * 4 + col];
+                }
+            }
+        }
+        t = r;
+    }
+    return t;
+}
+
+static vector6d_t randomJoints(std::mt19937& rng) {
+    std::uniform_real_distribution<double> dist(-PI, PI);
+    vector6d_t q;
+    for (auto& v : q) {
+        v = dist(rng);
+    }
+    return q;
+}
+
+TEST(KinematicsTest, zero_configuration) {
+    Kinematics kin(DH_A, DH_D, DH_ALPHA);
+    vector6d_t pose = kin.forward({0, 0, 0, 0, 0, 0});
+    EXPECT_NEAR(pose[0], DH_A[1] + DH_A[2], 1e-12);
+    EXPECT_NEAR(pose[1], -(DH_D[3] + DH_D[5]), 1e-12);
+    EXPECT_NEAR(pose[2], DH_D[0] - DH_D[4], 1e-12);
+}
+
+TEST(KinematicsTest, scalar_matches_reference) {
+    Kinematics kin(DH_A, DH_D, DH_ALPHA);
+    std::mt19937 rng(1);
+    for (int n = 0; n < 1000; n++) {
+        vector6d_t q = randomJoints(rng);
+        auto expect = referenceForward(q);
+        Transform3d t = kin.forwardTransform(q);
+        for (int e = 0; e < 12; e++) {
+            EXPECT_NEAR(t[e], expect[e], 1e-12);
+        }
+        // The pose converts back to the same transform
+        Transform3d back = Kinematics::poseToTransform(kin.forward(q));
+        for (int e = 0; e < 12; e++) {
+            EXPECT_NEAR(back[e], expect[e], 1e-9);
+        }
+    }
+}
+
+TEST(KinematicsTest, pose_conversion_near_pi) {
+    for (double angle : {PI, PI - 1e-5, PI - 1e-3, 1e-8, 0.0}) {
+        vector6d_t pose = {0.1, 0.2, 0.3, 0, 0, 0};
+        double axis[3] = {0.48, -0.6, 0.64};
+        for (int i = 0; i < 3; i++) {
+            pose[3 + i] = axis[i] * angle;
+        }
+        Transform3d t = Kinematics::poseToTransform(pose);
+        Transform3d back = Kinematics::poseToTransform(Kinematics::transformToPose(t));
+        for (int e = 0; e < 12; e++) {
+            EXPECT_NEAR(back[e], t[e], 1e-9) << "angle " << angle;
+        }
+    }
+}
+
+TEST(KinematicsTest, batch_matches_scalar) {
+    Kinematics kin(DH_A, DH_D, DH_ALPHA);
+    kin.setTcpOffset({0.01, -0.02, 0.15, 0.1, 0.2, -0.3});
+    std::mt19937 rng(2);
+    // Not a multiple of the block size
+    Vector6dBatch joints(1000);
+    for (size_t i = 0; i < joints.size(); i++) {
+        joints.set(i, randomJoints(rng));
+    }
+    Vector6dBatch poses;
+    kin.forward(joints, poses);
+    ASSERT_EQ(poses.size(), joints.size());
+    for (size_t i = 0; i < joints.size(); i++) {
+        Transform3d expect = kin.forwardTransform(joints.get(i));
+        Transform3d t = Kinematics::poseToTransform(poses.get(i));
+        for (int e = 0; e < 12; e++) {
+            EXPECT_NEAR(t[e], expect[e], 1e-9);
+        }
+    }
+}
+
+TEST(KinematicsTest, tcp_offset) {
+    Kinematics kin(DH_A, DH_D, DH_ALPHA);
+    vector6d_t q = {0.3, -1.2, 1.1, -0.5, 0.7, 0.2};
+    Transform3d flange = kin.forwardTransform(q);
+    kin.setTcpOffset({0, 0, 0.2, 0, 0, 0});
+    Transform3d tcp = kin.forwardTransform(q);
+    // 0.2 m along the flange z axis
+    for (int row = 0; row < 3; row++) {
+        EXPECT_NEAR(tcp[row * 4 + 3], flange[row * 4 + 3] + 0.2 * flange[row * 4 + 2], 1e-12);
+    }
+}
+
+TEST(KinematicsTest, jacobian_matches_finite_difference) {
+    Kinematics kin(DH_A, DH_D, DH_ALPHA);
+    kin.setTcpOffset({0.01, -0.02, 0.15, 0.1, 0.2, -0.3});
+    std::mt19937 rng(4);
+    const double h = 1e-6;
+    for (int n = 0; n < 100; n++) {
+        vector6d_t q = randomJoints(rng);
+        Matrix6d j = kin.jacobian(q);
+        Transform3d t = kin.forwardTransform(q);
+        for (int i = 0; i < 6; i++) {
+            vector6d_t moved = q;
+            moved[i] += h;
+            Transform3d tm = kin.forwardTransform(moved);
+            // Linear part from the position, angular part from dR R^T, a skew-symmetric matrix
+            double dr[9];
+            for (int row = 0; row < 3; row++) {
+                EXPECT_NEAR(j[row * 6 + i], (tm[row * 4 + 3] - t[row * 4 + 3]) / h, 1e-5);
+                for (int col = 0; col < 3; col++) {
+                    double sum = 0;
+                    for (int k = 0; k < 3; k++) {
+                        sum += (tm[row * 4 + k] - t[row * 4 + k]) * t[col * 4 + k];
+                    }
+                    dr[row * 3 + col] = sum / h;
+                }
+            }
+            EXPECT_NEAR(j[18 + i], dr[7], 1e-5);
+            EXPECT_NEAR(j[24 + i], dr[2], 1e-5);
+            EXPECT_NEAR(j[30 + i], dr[3], 1e-5);
+        }
+    }
+}
+
+static double angleDistance(double a, double b) { return std::fabs(std::remainder(a - b, 2 * PI)); }
+
+static void expectSamePose(const Transform3d& t, const Transform3d& expect, double tolerance) {
+    for (int e = 0; e < 12; e++) {
+        EXPECT_NEAR(t[e], expect[e], tolerance);
+    }
+}
+
+TEST(KinematicsTest, inverse_round_trip) {
+    Kinematics kin(DH_A, DH_D, DH_ALPHA);
+    ASSERT_TRUE(kin.isAnalyticInverseSupported());
+    std::mt19937 rng(3);
+    for (int n = 0; n < 1000; n++) {
+        vector6d_t q = randomJoints(rng);
+        Transform3d expect = kin.forwardTransform(q);
+        auto solutions = kin.inverse(kin.forward(q));
+        ASSERT_FALSE(solutions.empty());
+        EXPECT_LE(solutions.size(), (size_t)Kinematics::MAX_IK_SOLUTIONS);
+        // Every branch reaches the pose, one of them is the original configuration
+        bool found = false;
+        for (auto& s : solutions) {
+            expectSamePose(kin.forwardTransform(s), expect, 1e-9);
+            bool same = true;
+            for (int j = 0; j < 6; j++) {
+                same = same && angleDistance(s[j], q[j]) < 1e-6;
+            }
+            found = found || same;
+        }
+        EXPECT_TRUE(found);
+    }
+}
+
+TEST(KinematicsTest, inverse_seed_and_tcp) {
+    Kinematics kin(DH_A, DH_D, DH_ALPHA);
+    kin.setTcpOffset({0.01, -0.02, 0.15, 0.1, 0.2, -0.3});
+    vector6d_t q = {0.3, -1.2, 1.1, -0.5, 0.7, 0.2};
+    vector6d_t pose = kin.forward(q);
+    vector6d_t result;
+    // A seed near the configuration gives it back, with the turns of the seed
+    ASSERT_TRUE(kin.inverse(pose, {0.35, -1.1, 1.0, -0.4, 0.75, 0.25 + 2 * PI}, result));
+    for (int j = 0; j < 5; j++) {
+        EXPECT_NEAR(result[j], q[j], 1e-9);
+    }
+    EXPECT_NEAR(result[5], q[5] + 2 * PI, 1e-9);
+    expectSamePose(kin.forwardTransform(result), kin.forwardTransform(q), 1e-9);
+
+    // Out of reach
+    EXPECT_TRUE(kin.inverse({3, 0, 0, 0, 0, 0}).empty());
+    EXPECT_FALSE(kin.inverse({3, 0, 0, 0, 0, 0}, q, result));
+
+    // At the wrist singularity the last joint keeps the seed
+    vector6d_t singular = {0.3, -1.2, 1.1, -0.5, 0, 0.2};
+    ASSERT_TRUE(kin.inverse(kin.forward(singular), {0.3, -1.2, 1.1, -0.5, 0, 1.0}, result));
+    EXPECT_NEAR(result[5], 1.0, 1e-9);
+    expectSamePose(kin.forwardTransform(result), kin.forwardTransform(singular), 1e-9);
+}
+
+TEST(KinematicsTest, inverse_path) {
+    Kinematics kin(DH_A, DH_D, DH_ALPHA);
+    // A smooth joint path, crossing +-pi on the last joint
+    const size_t count = 20000;
+    Vector6dBatch path(count);
+    for (size_t i = 0; i < count; i++) {
+        double s = (double)i / (count - 1);
+        path.set(i, {0.5 * std::sin(2 * PI * s), -1.3 + 0.4 * s, 1.2 - 0.3 * s, -0.6, 0.8 + 0.2 * s, 2.5 + 1.5 * s});
+    }
+    Vector6dBatch poses, joints;
+    kin.forward(path, poses);
+    ASSERT_EQ(kin.inverse(poses, path.get(0), joints, 4), count);
+    ASSERT_EQ(joints.size(), count);
+    // Stays on the branch of the original path, without jumps of 2 pi
+    for (size_t i = 0; i < count; i++) {
+        for (int j = 0; j < 6; j++) {
+            EXPECT_NEAR(joints.values[j][i], path.values[j][i], 1e-6);
+        }
+    }
+
+    // Stops at the first point out of reach
+    poses.set(count / 2, {3, 0, 0, 0, 0, 0});
+    EXPECT_EQ(kin.inverse(poses, path.get(0), joints, 4), count / 2);
+}
+
+TEST(KinematicsTest, inverse_unsupported_geometry) {
+    vector6d_t dh_a = DH_A;
+    dh_a[4] = 0.05;
+    Kinematics kin(dh_a, DH_D, DH_ALPHA);
+    EXPECT_FALSE(kin.isAnalyticInverseSupported());
+    EXPECT_ANY_THROW(kin.inverse({0.3, 0.1, 0.4, 0, 0, 0}));
+}
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,184 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Elite/Log.hpp"
+
+using namespace ELITE;
+
+class CountLogHandler : public LogHandler {
+   public:
+    CountLogHandler(std::atomic<int>& count, std::thread::id& thread_id) : count_(count), thread_id_(thread_id) {}
+
+    void log(const char* file, int line, LogLevel loglevel, const char* log) override {
+        thread_id_ = std::this_thread::get_id();
+        if (std::string(log).find("log test") == 0) {
+            count_++;
+        }
+    }
+
+   private:
+    std::atomic<int>& count_;
+    std::thread::id& thread_id_;
+};
+
+class BlockLogHandler : public LogHandler {
+   public:
+    BlockLogHandler(std::mutex& mutex) : mutex_(mutex) {}
+    void log(const char* file, int line, LogLevel loglevel, const char* log) override { std::lock_guard<std::mutex> lock(mutex_); }
+
+   private:
+    std::mutex& mutex_;
+};
+
+class CollectLogHandler : public LogHandler {
+   public:
+    CollectLogHandler(std::vector<std::string>& messages) : messages_(messages) {}
+    void log(const char* file, int line, LogLevel loglevel, const char* log) override { messages_.push_back(log); }
+
+   private:
+    std::vector<std::string>& messages_;
+};
+
+TEST(LogTest, async_log) {
+    std::atomic<int> count(0);
+    std::thread::id handler_thread;
+    registerLogHandler(std::unique_ptr<LogHandler>(new CountLogHandler(count, handler_thread)));
+    enableAsyncLog(4096);
+
+    const int THREADS = 4;
+    const int MESSAGES = 500;
+    std::vector<std::thread> producers;
+    for (int t = 0; t < THREADS; t++) {
+        producers.emplace_back([t]() {
+            for (int i = 0; i < MESSAGES; i++) {
+                ELITE_LOG_INFO("log test %d %d", t, i);
+            }
+        });
+    }
+    for (auto& p : producers) {
+        p.join();
+    }
+    flushLog();
+    EXPECT_EQ(count + getDroppedLogCount(), THREADS * MESSAGES);
+    EXPECT_EQ(getDroppedLogCount(), 0);
+    EXPECT_NE(handler_thread, std::this_thread::get_id());
+
+    disableAsyncLog();
+    ELITE_LOG_INFO("log test sync");
+    EXPECT_EQ(handler_thread, std::this_thread::get_id());
+    unregisterLogHandler();
+}
+
+TEST(LogTest, drop_when_full) {
+    std::mutex block;
+    registerLogHandler(std::unique_ptr<LogHandler>(new BlockLogHandler(block)));
+    enableAsyncLog(16);
+    uint64_t dropped = getDroppedLogCount();
+    {
+        // The handler is blocked, the ring fills up and the producer must not block.
+        // The ring of the previous test may be reused, so push more than its capacity.
+        std::lock_guard<std::mutex> lock(block);
+        for (int i = 0; i < 10000; i++) {
+            ELITE_LOG_INFO("log test %d", i);
+        }
+        EXPECT_GT(getDroppedLogCount(), dropped);
+    }
+    disableAsyncLog();
+    unregisterLogHandler();
+}
+
+TEST(LogTest, deferred_format) {
+    std::vector<std::string> messages;
+    registerLogHandler(std::unique_ptr<LogHandler>(new CollectLogHandler(messages)));
+    enableAsyncLog();
+    std::string text = "text";
+    const void* pointer = &messages;
+    ELITE_LOG_INFO("%d %5.2f %s %-6s| %x %c %lu %lld %%", -3, 3.14159, text.c_str(), "left", 255u, 'e', 42ul, -7ll);
+    ELITE_LOG_INFO("%*d %.3e %p", 5, 12, 0.000123, pointer);
+    ELITE_LOG_INFO("no argument");
+    flushLog();
+    disableAsyncLog();
+    unregisterLogHandler();
+
+    char expected[256];
+    ASSERT_EQ(messages.size(), 3);
+    snprintf(expected, sizeof(expected), "%d %5.2f %s %-6s| %x %c %lu %lld %%", -3, 3.14159, text.c_str(), "left", 255u, 'e', 42ul,
+             -7ll);
+    EXPECT_EQ(messages[0], expected);
+    snprintf(expected, sizeof(expected), "%*d %.3e %p", 5, 12, 0.000123, pointer);
+    EXPECT_EQ(messages[1], expected);
+    EXPECT_EQ(messages[2], "no argument");
+}
+
+TEST(LogTest, binary_log) {
+    const std::string path = "log_test.elog";
+    ASSERT_TRUE(enableBinaryLog(path));
+    for (int i = 0; i < 100; i++) {
+        ELITE_LOG_INFO("binary %d %.1f %s", i, i * 0.5, "done");
+    }
+    log(__FILE__, __LINE__, LogLevel::ELI_WARN, "preformatted %d", 1);
+    disableBinaryLog();
+
+    std::vector<std::string> messages;
+    CollectLogHandler handler(messages);
+    ASSERT_TRUE(decodeBinaryLog(path, handler));
+    ASSERT_EQ(messages.size(), 101);
+    // Each message starts with the timestamp
+    EXPECT_NE(messages[10].find("] binary 10 5.0 done"), std::string::npos);
+    EXPECT_NE(messages[100].find("] preformatted 1"), std::string::npos);
+    std::remove(path.c_str());
+}
+
+TEST(LogTest, disabled_level_skips_arguments) {
+    int evaluated = 0;
+    setLogLevel(LogLevel::ELI_ERROR);
+    ELITE_LOG_INFO("log test %d", ++evaluated);
+    EXPECT_EQ(evaluated, 0);
+    setLogLevel(LogLevel::ELI_INFO);
+}
+
+TEST(LogTest, throttle) {
+    std::vector<std::string> messages;
+    registerLogHandler(std::unique_ptr<LogHandler>(new CollectLogHandler(messages)));
+    LogThrottle throttle;
+    auto logBurst = [&throttle](int count) {
+        for (int i = 0; i < count; i++) {
+            ELITE_LOG_INFO_THROTTLE(throttle, 200, "throttle %d", i);
+        }
+    };
+    logBurst(1000);
+    ASSERT_EQ(messages.size(), 1);
+    EXPECT_EQ(messages[0], "throttle 0");
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    logBurst(1);
+    ASSERT_EQ(messages.size(), 3);
+    EXPECT_EQ(messages[1], "throttle 0");
+    EXPECT_EQ(messages[2], "The message above was suppressed 999 times");
+
+    // Another throttle, e.g. of another instance, is not suppressed
+    messages.clear();
+    LogThrottle other;
+    ELITE_LOG_INFO_THROTTLE(other, 200, "other");
+    logBurst(1);
+    ASSERT_EQ(messages.size(), 1);
+    EXPECT_EQ(messages[0], "other");
+
+    messages.clear();
+    for (int i = 0; i < 10; i++) {
+        ELITE_LOG_INFO_ONCE("once %d", i);
+    }
+    ASSERT_EQ(messages.size(), 1);
+    EXPECT_EQ(messages[0], "once 0");
+    unregisterLogHandler();
+}
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -3,6 +3,9 @@
 #include "Elite/Log.hpp"
 
 #include <gtest/gtest.h>
+#include <boost/asio.hpp>
+#include <atomic>
+#include <mutex>
 #include <string>
 #include <memory>
 #include <thread>
@@ -59,6 +62,91 @@ TEST(PrimaryPortTest, get_package) {
 }
 
 
+// Sends a package which is not 'RobotState' every 20ms
+class FakePrimaryServer {
+public:
+    explicit FakePrimaryServer(int port)
+        : acceptor_(io_context_, boost::asio::ip::tcp::endpoint(boost::asio::ip::tcp::v4(), port)) {
+        thread_ = std::thread([this]() {
+            while (is_alive_) {
+                boost::system::error_code ec;
+                boost::asio::ip::tcp::socket socket(io_context_);
+                acceptor_.accept(socket, ec);
+                if (ec || !is_alive_) {
+                    return;
+                }
+                connections_++;
+                std::vector<uint8_t> package = {0, 0, 0, 10, 20, 0, 0, 0, 0, 0};
+                while (is_alive_ && !drop_) {
+                    boost::asio::write(socket, boost::asio::buffer(package), ec);
+                    if (ec) {
+                        break;
+                    }
+                    std::this_thread::sleep_for(20ms);
+                }
+                drop_ = false;
+            }
+        });
+    }
+
+    ~FakePrimaryServer() {
+        is_alive_ = false;
+        // Wake up the blocking accept
+        boost::system::error_code ec;
+        boost::asio::ip::tcp::socket waker(io_context_);
+        int port = acceptor_.local_endpoint(ec).port();
+        waker.connect(boost::asio::ip::tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"), port), ec);
+        acceptor_.close(ec);
+        thread_.join();
+    }
+
+    // Close the current connection and accept the next one
+    void dropClient() { drop_ = true; }
+
+    int connections() { return connections_; }
+
+private:
+    boost::asio::io_context io_context_;
+    boost::asio::ip::tcp::acceptor acceptor_;
+    std::thread thread_;
+    std::atomic<bool> is_alive_{true};
+    std::atomic<bool> drop_{false};
+    std::atomic<int> connections_{0};
+};
+
+TEST(PrimaryPortTest, auto_reconnect) {
+    FakePrimaryServer server(30101);
+    PrimaryPort primary;
+    std::mutex states_mutex;
+    std::vector<LinkState> states;
+    primary.setConnectionStateCallback([&](LinkState state) {
+        std::lock_guard<std::mutex> lock(states_mutex);
+        states.push_back(state);
+    });
+    ReconnectOptions options;
+    options.silence_timeout_ms = 100;
+    primary.setAutoReconnect(true, options);
+    ASSERT_TRUE(primary.connect("127.0.0.1", 30101));
+
+    server.dropClient();
+    auto deadline = steady_clock::now() + 3s;
+    while ((primary.getReconnectMetrics().reconnects < 1 || server.connections() < 2) && steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(5ms);
+    }
+    EXPECT_EQ(primary.getReconnectMetrics().reconnects, 1);
+    EXPECT_EQ(server.connections(), 2);
+    EXPECT_EQ(primary.getConnectionState(), LinkState::CONNECTED);
+    // Still connected after the silence timeout
+    std::this_thread::sleep_for(200ms);
+    EXPECT_EQ(primary.getReconnectMetrics().reconnects, 1);
+
+    primary.disconnect();
+    std::lock_guard<std::mutex> lock(states_mutex);
+    std::vector<LinkState> expected = {LinkState::CONNECTED, LinkState::RECONNECTING, LinkState::CONNECTED,
+                                       LinkState::DISCONNECTED};
+    EXPECT_EQ(states, expected);
+}
+
 int main(int argc, char** argv) {
     setLogLevel(LogLevel::ELI_DEBUG);
     if(argc >= 2) {
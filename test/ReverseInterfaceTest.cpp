@@ -117,6 +117,122 @@ TEST(REVERSE_INTERFACE, joint_idle_command) {
 
 }
 
+TEST(REVERSE_INTERFACE, pose_command) {
+    std::unique_ptr<ReverseInterface> reverse_ins = std::make_unique<ReverseInterface>(REVERSE_INTERFACE_TEST_PORT);
+    std::unique_ptr<TcpClient> client = std::make_unique<TcpClient>();
+    // The server starts listening in its own thread
+    std::this_thread::sleep_for(50ms);
+
+    EXPECT_NO_THROW(client->connect("127.0.0.1", REVERSE_INTERFACE_TEST_PORT));
+
+    std::this_thread::sleep_for(100ms);
+
+    // Pose in meters and radians, the rotation vector may be negative
+    vector6d_t pose = {0.5, -0.25, 0.125, 3.0, -1.5, 0.0};
+    reverse_ins->writeJointCommand(pose, ControlMode::MODE_POSE, 100);
+
+    int32_t buffer[ReverseInterface::REVERSE_DATA_SIZE];
+    int recv_num = client->socket_ptr->read_some(boost::asio::buffer(buffer, sizeof(buffer)));
+
+    client->socket_ptr->close();
+
+    EXPECT_EQ(recv_num, sizeof(buffer));
+    EXPECT_EQ(::htonl(buffer[0]), 100);
+    for (int i = 0; i < 6; i++) {
+        EXPECT_EQ((int32_t)::htonl(buffer[i + 1]), (int32_t)(pose[i] * CONTROL::POS_ZOOM_RATIO));
+    }
+    EXPECT_EQ(::htonl(buffer[7]), (int)ControlMode::MODE_POSE);
+}
+
+TEST(REVERSE_INTERFACE, latency_echo) {
+    std::unique_ptr<ReverseInterface> reverse_ins = std::make_unique<ReverseInterface>(REVERSE_INTERFACE_TEST_PORT);
+    std::unique_ptr<TcpClient> client = std::make_unique<TcpClient>();
+    std::this_thread::sleep_for(50ms);
+
+    EXPECT_NO_THROW(client->connect("127.0.0.1", REVERSE_INTERFACE_TEST_PORT));
+
+    std::this_thread::sleep_for(100ms);
+
+    vector6d_t joints = {0.1, 0.2, 0.3, 0.4, 0.5, 0.6};
+    int32_t buffer[ReverseInterface::REVERSE_DATA_SIZE];
+    // Without the measurement the frame is not to be echoed
+    reverse_ins->writeJointCommand(joints, ControlMode::MODE_SERVOJ, 100);
+    boost::asio::read(*client->socket_ptr, boost::asio::buffer(buffer, sizeof(buffer)));
+    EXPECT_EQ(::htonl(buffer[ReverseInterface::REVERSE_SEQUENCE_INDEX]), 0);
+
+    reverse_ins->setLatencyMeasurement(true);
+    reverse_ins->writeJointCommand(joints, ControlMode::MODE_SERVOJ, 100);
+    boost::asio::read(*client->socket_ptr, boost::asio::buffer(buffer, sizeof(buffer)));
+    EXPECT_EQ(::htonl(buffer[ReverseInterface::REVERSE_MODE_INDEX]), (int)ControlMode::MODE_SERVOJ);
+    int32_t sequence = ::htonl(buffer[ReverseInterface::REVERSE_SEQUENCE_INDEX]);
+    EXPECT_NE(sequence, 0);
+
+    // Echo as the script does, split over two writes
+    int32_t echo[ReverseInterface::REVERSE_ECHO_SIZE] = {(int32_t)::htonl(sequence), (int32_t)::htonl(100),
+                                                         (int32_t)::htonl(4000)};
+    boost::asio::write(*client->socket_ptr, boost::asio::buffer(echo, 5));
+    std::this_thread::sleep_for(20ms);
+    boost::asio::write(*client->socket_ptr, boost::asio::buffer((uint8_t*)echo + 5, sizeof(echo) - 5));
+    std::this_thread::sleep_for(50ms);
+
+    ReverseLatencyStatistics statistics = reverse_ins->getLatencyStatistics();
+    EXPECT_EQ(statistics.sent, 1);
+    EXPECT_EQ(statistics.echoed, 1);
+    EXPECT_EQ(statistics.round_trip.samples, 1);
+    EXPECT_EQ(statistics.step_time, microseconds(4000));
+    EXPECT_TRUE(reverse_ins->isRobotConnect());
+
+    client->socket_ptr->close();
+}
+
+TEST(REVERSE_INTERFACE, adaptive_timeout_modes) {
+    std::unique_ptr<ReverseInterface> reverse_ins = std::make_unique<ReverseInterface>(REVERSE_INTERFACE_TEST_PORT);
+    std::unique_ptr<TcpClient> client = std::make_unique<TcpClient>();
+    std::this_thread::sleep_for(50ms);
+
+    EXPECT_NO_THROW(client->connect("127.0.0.1", REVERSE_INTERFACE_TEST_PORT));
+
+    std::this_thread::sleep_for(100ms);
+
+    AdaptiveTimeoutOptions options;
+    options.min_samples = 10;
+    reverse_ins->enableAdaptiveTimeout(options);
+    vector6d_t joints = {0.1, 0.2, 0.3, 0.4, 0.5, 0.6};
+    int32_t buffer[ReverseInterface::REVERSE_DATA_SIZE];
+    auto sendAndRead = [&](const vector6d_t* pos, ControlMode mode, int timeout) {
+        EXPECT_TRUE(reverse_ins->writeJointCommand(pos, mode, timeout));
+        boost::asio::read(*client->socket_ptr, boost::asio::buffer(buffer, sizeof(buffer)));
+        return (int)::htonl(buffer[0]);
+    };
+    for (int i = 0; i < 20; i++) {
+        sendAndRead(&joints, ControlMode::MODE_SERVOJ, 500);
+        std::this_thread::sleep_for(2ms);
+    }
+    AdaptiveTimeoutStatistics statistics = reverse_ins->getAdaptiveTimeoutStatistics();
+    EXPECT_TRUE(statistics.adapted);
+    EXPECT_EQ(statistics.intervals, 19);
+    EXPECT_LT(statistics.timeout_ms, 500);
+    uint64_t late = statistics.late;
+
+    // Not a streaming mode, the given timeout is sent, and idle 0 still blocks
+    EXPECT_EQ(sendAndRead(&joints, ControlMode::MODE_POSE, 100), 100);
+    EXPECT_EQ(sendAndRead(nullptr, ControlMode::MODE_IDLE, 0), 0);
+    // Back to servoj, the pause in the other modes is not measured
+    std::this_thread::sleep_for(100ms);
+    EXPECT_EQ(sendAndRead(&joints, ControlMode::MODE_SERVOJ, 500), statistics.timeout_ms);
+    statistics = reverse_ins->getAdaptiveTimeoutStatistics();
+    EXPECT_EQ(statistics.intervals, 19);
+    EXPECT_EQ(statistics.late, late);
+
+    // A blocking servoj is sent as is and not measured either
+    EXPECT_EQ(sendAndRead(&joints, ControlMode::MODE_SERVOJ, 0), 0);
+    std::this_thread::sleep_for(100ms);
+    sendAndRead(&joints, ControlMode::MODE_SERVOJ, 500);
+    EXPECT_EQ(reverse_ins->getAdaptiveTimeoutStatistics().intervals, 19);
+
+    client->socket_ptr->close();
+}
+
 TEST(REVERSE_INTERFACE, joint_command_send_nullptr) {
     std::unique_ptr<ReverseInterface> reverse_ins = std::make_unique<ReverseInterface>(REVERSE_INTERFACE_TEST_PORT);
     std::unique_ptr<TcpClient> client = std::make_unique<TcpClient>();
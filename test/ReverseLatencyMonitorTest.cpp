@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+
+#include "Elite/ReverseLatencyMonitor.hpp"
+
+using namespace ELITE;
+using namespace std::chrono;
+
+static steady_clock::time_point hostTime(double us) { return steady_clock::time_point() + microseconds((int64_t)us); }
+
+TEST(ReverseLatencyMonitorTest, latency_and_clock_offset) {
+    ReverseLatencyMonitor monitor(500);
+    std::mt19937 rng(0);
+    // 1 ms each way, plus up to 0.5 ms of jitter
+    std::uniform_real_distribution<double> jitter(0, 500);
+    const int step_us = 4000;
+    const double offset_us = 123456789;
+    // The host sends slightly slower than the robot cycle, so the frames meet every phase of the cycle
+    double send = 1e6;
+    for (int i = 0; i < 5000; i++, send += 4010) {
+        int32_t sequence = monitor.onSend(hostTime(send));
+        double read = send + 1000 + jitter(rng);
+        int32_t cycle = (int32_t)std::floor((read + offset_us) / step_us);
+        monitor.onEcho(sequence, cycle, step_us, hostTime(read + 1000 + jitter(rng)));
+    }
+    ReverseLatencyStatistics statistics = monitor.getStatistics();
+    EXPECT_EQ(statistics.sent, 5000);
+    EXPECT_EQ(statistics.echoed, 5000);
+    EXPECT_EQ(statistics.lost, 0);
+    EXPECT_EQ(statistics.step_time, microseconds(step_us));
+    EXPECT_EQ(statistics.round_trip.samples, 5000);
+    EXPECT_NEAR(statistics.round_trip.mean.count(), 2500, 20);
+    EXPECT_GE(statistics.round_trip.min.count(), 2000);
+    EXPECT_LE(statistics.round_trip.max.count(), 3000);
+    EXPECT_EQ(statistics.round_trip.percentile(0.5), microseconds(4000));
+    // The controller time is known to a cycle, so the single samples spread, but the means are right
+    EXPECT_NEAR(statistics.uplink.mean.count(), 1250, 150);
+    EXPECT_NEAR(statistics.downlink.mean.count(), 1250, 150);
+    // The host clock starts at the first send
+    EXPECT_NEAR(statistics.clock_offset.count(), offset_us + 1e6, 300);
+}
+
+TEST(ReverseLatencyMonitorTest, lost_skipped_and_missed) {
+    ReverseLatencyMonitor monitor;
+    double now = 0;
+    int32_t sequence[8];
+    for (auto& s : sequence) {
+        s = monitor.onSend(hostTime(now += 1000));
+    }
+    EXPECT_EQ(sequence[0], 1);
+    EXPECT_EQ(sequence[7], 8);
+    monitor.onEcho(sequence[0], 10, 4000, hostTime(now));
+    monitor.onEcho(sequence[1], 11, 4000, hostTime(now));
+    // Read in the same cycle as the one before, which the motion never used
+    monitor.onEcho(sequence[2], 11, 4000, hostTime(now));
+    // sequence[3] is lost
+    monitor.onEcho(sequence[4], 14, 4000, hostTime(now));
+    // Two cycles without a frame
+    monitor.onEcho(sequence[5], 17, 4000, hostTime(now));
+    ReverseLatencyStatistics statistics = monitor.getStatistics();
+    EXPECT_EQ(statistics.echoed, 5);
+    EXPECT_EQ(statistics.lost, 1);
+    EXPECT_EQ(statistics.skipped, 1);
+    EXPECT_EQ(statistics.missed_cycles, 2);
+
+    // A new script counts cycles from 0
+    monitor.restart();
+    monitor.onEcho(sequence[7], 0, 4000, hostTime(now));
+    statistics = monitor.getStatistics();
+    EXPECT_EQ(statistics.lost, 1);
+    EXPECT_EQ(statistics.missed_cycles, 2);
+    EXPECT_EQ(statistics.echoed, 6);
+
+    // Not a sequence number
+    monitor.onEcho(0, 1, 4000, hostTime(now));
+    EXPECT_EQ(monitor.getStatistics().echoed, 6);
+
+    monitor.reset();
+    EXPECT_EQ(monitor.getStatistics().sent, 0);
+    EXPECT_EQ(monitor.getStatistics().round_trip.percentile(0.99), microseconds(0));
+}
+
+TEST(ReverseLatencyMonitorTest, stale_echo) {
+    ReverseLatencyMonitor monitor;
+    double now = 0;
+    int32_t first = monitor.onSend(hostTime(now += 1000));
+    // Enough frames to reuse the slot of the first one
+    for (int i = 0; i < 4096; i++) {
+        monitor.onSend(hostTime(now += 1000));
+    }
+    monitor.onEcho(first, 1, 4000, hostTime(now));
+    ReverseLatencyStatistics statistics = monitor.getStatistics();
+    EXPECT_EQ(statistics.echoed, 1);
+    // Its send time is gone, no latency is taken from the frame in the slot
+    EXPECT_EQ(statistics.round_trip.samples, 0);
+
+    monitor.onEcho(first + 4096, 2, 4000, hostTime(now + 500));
+    statistics = monitor.getStatistics();
+    EXPECT_EQ(statistics.round_trip.samples, 1);
+    EXPECT_EQ(statistics.round_trip.last, microseconds(500));
+}
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "Elite/RobotStateBus.hpp"
+#include "EliteException.hpp"
+
+#if defined(__linux__)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace ELITE;
+using namespace std::chrono;
+
+static const char* BUS_NAME = "elite_robot_state_bus_test";
+
+// Every field holds the same value, so a torn read is visible
+static RobotStateSnapshot makeSnapshot(double value) {
+    RobotStateSnapshot snapshot{};
+    snapshot.timestamp = value;
+    vector6d_t* vectors[] = {&snapshot.target_joint_positions, &snapshot.target_joint_velocity,
+                             &snapshot.actual_joint_positions, &snapshot.actual_joint_velocity,
+                             &snapshot.actual_joint_current,   &snapshot.actual_joint_torques,
+                             &snapshot.actual_tcp_pose,        &snapshot.actual_tcp_velocity,
+                             &snapshot.actual_tcp_force,       &snapshot.target_tcp_pose,
+                             &snapshot.target_tcp_velocity};
+    for (auto v : vectors) {
+        v->fill(value);
+    }
+    snapshot.actual_speed_scaling = value;
+    snapshot.target_speed_scaling = value;
+    snapshot.digital_input_bits = (uint32_t)value;
+    snapshot.digital_output_bits = (uint32_t)value;
+    return snapshot;
+}
+
+static bool isConsistent(const RobotStateSnapshot& snapshot) {
+    const vector6d_t* vectors[] = {&snapshot.target_joint_positions, &snapshot.target_joint_velocity,
+                                   &snapshot.actual_joint_positions, &snapshot.actual_joint_velocity,
+                                   &snapshot.actual_joint_current,   &snapshot.actual_joint_torques,
+                                   &snapshot.actual_tcp_pose,        &snapshot.actual_tcp_velocity,
+                                   &snapshot.actual_tcp_force,       &snapshot.target_tcp_pose,
+                                   &snapshot.target_tcp_velocity};
+    for (auto v : vectors) {
+        for (auto x : *v) {
+            if (x != snapshot.timestamp) {
+                return false;
+            }
+        }
+    }
+    return snapshot.actual_speed_scaling == snapshot.timestamp && snapshot.target_speed_scaling == snapshot.timestamp &&
+           snapshot.digital_input_bits == (uint32_t)snapshot.timestamp &&
+           snapshot.digital_output_bits == (uint32_t)snapshot.timestamp;
+}
+
+TEST(RobotStateBusTest, publish_read) {
+    RobotStatePublisher publisher(BUS_NAME);
+    RobotStateReader reader(BUS_NAME);
+    RobotStateSnapshot snapshot;
+    EXPECT_FALSE(reader.read(snapshot));
+    EXPECT_EQ(reader.getSequence(), 0);
+
+    RobotStateSnapshot published = makeSnapshot(1);
+    published.robot_mode = RobotMode::RUNNING;
+    published.safety_status = SafetyMode::NORMAL;
+    published.runtime_state = TaskStatus::PLAYING;
+    publisher.publish(published);
+    EXPECT_EQ(publisher.getSequence(), 1);
+    EXPECT_EQ(reader.getSequence(), 1);
+    ASSERT_TRUE(reader.read(snapshot));
+    EXPECT_TRUE(isConsistent(snapshot));
+    EXPECT_EQ(snapshot.timestamp, 1);
+    EXPECT_EQ(snapshot.robot_mode, RobotMode::RUNNING);
+    EXPECT_EQ(snapshot.safety_status, SafetyMode::NORMAL);
+    EXPECT_EQ(snapshot.runtime_state, TaskStatus::PLAYING);
+
+    publisher.publish(makeSnapshot(2));
+    EXPECT_EQ(reader.getSequence(), 2);
+    ASSERT_TRUE(reader.read(snapshot));
+    EXPECT_EQ(snapshot.timestamp, 2);
+}
+
+TEST(RobotStateBusTest, open_missing) {
+    EXPECT_THROW(RobotStateReader("elite_robot_state_bus_missing"), EliteException);
+    {
+        RobotStatePublisher publisher(BUS_NAME);
+    }
+    // The publisher removes the segment
+    EXPECT_THROW(RobotStateReader reader(BUS_NAME), EliteException);
+}
+
+TEST(RobotStateBusTest, concurrent_read) {
+    RobotStatePublisher publisher(BUS_NAME);
+    std::atomic<bool> running(true);
+    std::thread writer([&]() {
+        double value = 1;
+        while (running) {
+            publisher.publish(makeSnapshot(value));
+            value += 1;
+        }
+    });
+    RobotStateReader reader(BUS_NAME);
+    RobotStateSnapshot snapshot;
+    int reads = 0;
+    double last = 0;
+    auto deadline = steady_clock::now() + 200ms;
+    while (steady_clock::now() < deadline) {
+        if (reader.read(snapshot)) {
+            ASSERT_TRUE(isConsistent(snapshot)) << "torn read at " << snapshot.timestamp;
+            ASSERT_GE(snapshot.timestamp, last);
+            last = snapshot.timestamp;
+            reads++;
+        }
+    }
+    running = false;
+    writer.join();
+    EXPECT_GT(reads, 0);
+    EXPECT_GT(last, 1);
+}
+
+#if defined(__linux__)
+TEST(RobotStateBusTest, other_process) {
+    RobotStatePublisher publisher(BUS_NAME);
+    publisher.publish(makeSnapshot(42));
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        int code = 1;
+        try {
+            RobotStateReader reader(BUS_NAME);
+            RobotStateSnapshot snapshot;
+            if (reader.read(snapshot) && isConsistent(snapshot) && snapshot.timestamp == 42) {
+                code = 0;
+            }
+        } catch (...) {
+        }
+        _exit(code);
+    }
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    ASSERT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+}
+#endif
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
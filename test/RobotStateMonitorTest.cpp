@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+
+#include "Elite/RobotStateMonitor.hpp"
+
+using namespace ELITE;
+using namespace std::chrono;
+
+TEST(RobotStateMonitorTest, wake_on_update) {
+    RobotStateMonitor monitor;
+    monitor.update(RobotMode::POWER_OFF, SafetyMode::NORMAL, TaskStatus::STOPPED);
+    EXPECT_TRUE(monitor.isUpdating());
+
+    std::thread feeder([&]() {
+        for (int i = 0; i < 20; i++) {
+            std::this_thread::sleep_for(2ms);
+            monitor.updateTaskStatus(TaskStatus::STOPPED);
+        }
+        monitor.updateRobotMode(RobotMode::IDLE);
+    });
+    auto start = steady_clock::now();
+    EXPECT_TRUE(monitor.waitRobotMode({RobotMode::RUNNING, RobotMode::IDLE}, 5000));
+    EXPECT_LT(steady_clock::now() - start, 1s);
+    EXPECT_EQ(monitor.getRobotMode(), RobotMode::IDLE);
+    feeder.join();
+
+    // Already reached
+    EXPECT_TRUE(monitor.waitTaskStatus(TaskStatus::STOPPED, 0));
+    EXPECT_TRUE(monitor.waitSafetyMode(SafetyMode::NORMAL, 0));
+}
+
+TEST(RobotStateMonitorTest, stale) {
+    RobotStateMonitor monitor;
+    EXPECT_FALSE(monitor.isUpdating());
+    EXPECT_FALSE(monitor.waitRobotMode({RobotMode::RUNNING}, 1000));
+
+    monitor.setStaleTimeout(50);
+    monitor.updateRobotMode(RobotMode::IDLE);
+    // No more update, the wait returns once the monitor is stale instead of waiting for the whole timeout.
+    auto start = steady_clock::now();
+    EXPECT_FALSE(monitor.waitRobotMode({RobotMode::RUNNING}, 5000));
+    EXPECT_LT(steady_clock::now() - start, 1s);
+    EXPECT_FALSE(monitor.isUpdating());
+}
+
+TEST(RobotStateMonitorTest, listener) {
+    RobotStateMonitor monitor;
+    int calls = 0;
+    int id = monitor.addListener([&]() {
+        calls++;
+        EXPECT_EQ(monitor.getRobotMode(), RobotMode::IDLE);
+    });
+    monitor.updateRobotMode(RobotMode::IDLE);
+    monitor.update(RobotMode::IDLE, SafetyMode::NORMAL, TaskStatus::STOPPED);
+    EXPECT_EQ(calls, 2);
+    monitor.removeListener(id);
+    monitor.updateTaskStatus(TaskStatus::PLAYING);
+    EXPECT_EQ(calls, 2);
+}
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "Rtsi/RtsiHub.hpp"
+#include "FakeRtsiServer.hpp"
+
+using namespace ELITE;
+using namespace std::chrono;
+
+TEST(RtsiHubTest, fan_out) {
+    FakeRtsiServer server;
+    RtsiHub hub(250);
+    std::atomic<int> callback_count{0};
+    std::atomic<bool> callback_ok{true};
+    auto callback = hub.subscribe({"speed_scaling"}, [&](const RtsiSamplePtr& sample) {
+        double scaling = 0, timestamp = 0;
+        callback_ok = callback_ok && sample->getValue("speed_scaling", scaling) && sample->getValue("timestamp", timestamp) &&
+                      scaling == timestamp;
+        callback_count++;
+    });
+    auto queue = hub.subscribeQueue({"actual_joint_positions"}, 4);
+    auto latest = hub.subscribeLatest({"robot_mode", "speed_scaling"});
+    EXPECT_EQ(latest->get(), nullptr);
+
+    ASSERT_TRUE(hub.connect("127.0.0.1"));
+    // One recipe for all subscribers, duplicated fields merged
+    EXPECT_EQ(hub.getOutputRecipe(),
+              std::vector<std::string>({"timestamp", "speed_scaling", "actual_joint_positions", "robot_mode"}));
+    EXPECT_EQ(server.outputSetups(), 1);
+
+    RtsiSamplePtr sample;
+    ASSERT_TRUE(queue->waitPop(sample, 1000));
+    vector6d_t joints;
+    ASSERT_TRUE(sample->getValue("actual_joint_positions", joints));
+    double timestamp = 0;
+    ASSERT_TRUE(sample->getValue("timestamp", timestamp));
+    EXPECT_DOUBLE_EQ(joints[5], timestamp);
+    // Wrong type
+    double mode_double = 0;
+    EXPECT_FALSE(sample->getValue("robot_mode", mode_double));
+
+    std::this_thread::sleep_for(milliseconds(100));
+    EXPECT_GT(callback_count, 10);
+    EXPECT_TRUE(callback_ok);
+    // The queue was not read, so it dropped
+    EXPECT_EQ(queue->size(), 4);
+    EXPECT_GT(queue->getDropped(), 0);
+    uint64_t last = 0;
+    while (queue->pop(sample)) {
+        EXPECT_GT(sample->getSequence(), last);
+        last = sample->getSequence();
+    }
+
+    RtsiSamplePtr newest = latest->get();
+    ASSERT_NE(newest, nullptr);
+    int32_t mode = 0;
+    EXPECT_TRUE(newest->getValue("robot_mode", mode));
+    EXPECT_EQ(mode, 7);
+    EXPECT_GE(newest->getSequence(), last);
+
+    hub.unsubscribe(callback);
+    std::this_thread::sleep_for(milliseconds(20));
+    int stopped_count = callback_count;
+    std::this_thread::sleep_for(milliseconds(50));
+    EXPECT_EQ(callback_count, stopped_count);
+    EXPECT_FALSE(callback->isActive());
+    hub.disconnect();
+}
+
+TEST(RtsiHubTest, subscribe_while_connected) {
+    FakeRtsiServer server;
+    RtsiHub hub(250);
+    auto first = hub.subscribeLatest({"speed_scaling"});
+    ASSERT_TRUE(hub.connect("127.0.0.1"));
+    EXPECT_EQ(hub.getOutputRecipe(), std::vector<std::string>({"timestamp", "speed_scaling"}));
+
+    // A known field is added to the recipe without disconnect
+    auto second = hub.subscribeQueue({"actual_joint_positions"}, 16);
+    RtsiSamplePtr sample;
+    ASSERT_TRUE(second->waitPop(sample, 1000));
+    vector6d_t joints;
+    EXPECT_TRUE(sample->getValue("actual_joint_positions", joints));
+    EXPECT_EQ(hub.getOutputRecipe(),
+              std::vector<std::string>({"timestamp", "speed_scaling", "actual_joint_positions"}));
+
+    // An unknown field is rejected, the others keep receiving
+    auto bad = hub.subscribeQueue({"no_such_field"}, 16);
+    std::this_thread::sleep_for(milliseconds(100));
+    EXPECT_FALSE(bad->isActive());
+    EXPECT_EQ(bad->size(), 0);
+    EXPECT_TRUE(hub.isConnected());
+    uint64_t count = hub.getSampleCount();
+    std::this_thread::sleep_for(milliseconds(50));
+    EXPECT_GT(hub.getSampleCount(), count);
+    double scaling = 0;
+    ASSERT_NE(first->get(), nullptr);
+    EXPECT_TRUE(first->get()->getValue("speed_scaling", scaling));
+    hub.disconnect();
+    EXPECT_FALSE(hub.isConnected());
+}
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
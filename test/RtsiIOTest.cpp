@@ -2,13 +2,138 @@
 #include <string>
 #include <cstdint>
 #include <chrono>
+#include <fstream>
+#include <mutex>
+#include <thread>
 
+#include "Elite/RobotStateBus.hpp"
 #include "Elite/RtsiIOInterface.hpp"
+#include "FakeRtsiServer.hpp"
 
 using namespace ELITE;
 
 static std::string s_robot_ip;
 
+static void writeFakeRecipes() {
+    std::ofstream output("fake_output_recipe.txt");
+    output << "timestamp\nspeed_scaling";
+    std::ofstream input("fake_input_recipe.txt");
+    input << "speed_slider_mask";
+}
+
+TEST(RtsiIOTest, sequential_connect) {
+    writeFakeRecipes();
+    FakeRtsiServer server;
+    server.setDouble("speed_scaling", 0.5);
+    RtsiIOInterface io_interface("fake_output_recipe.txt", "fake_input_recipe.txt", 250);
+    ASSERT_TRUE(io_interface.connect("127.0.0.1"));
+    // Every request waits for the previous reply
+    EXPECT_EQ(server.firstBurst(), 1);
+    EXPECT_EQ(io_interface.getControllerVersion().minor, 14);
+    EXPECT_DOUBLE_EQ(io_interface.getActualSpeedScaling(), 0.5);
+    io_interface.disconnect();
+}
+
+TEST(RtsiIOTest, state_publisher_missing_fields) {
+    writeFakeRecipes();
+    FakeRtsiServer server;
+    server.setDouble("speed_scaling", 0.5);
+    RtsiIOInterface io_interface("fake_output_recipe.txt", "fake_input_recipe.txt", 250);
+    io_interface.setStatePublisher(std::make_shared<RobotStatePublisher>("elite_rtsi_io_test"));
+    RobotStateReader reader("elite_rtsi_io_test");
+    ASSERT_TRUE(io_interface.connect("127.0.0.1"));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    RobotStateSnapshot snapshot;
+    ASSERT_TRUE(reader.read(snapshot));
+    EXPECT_DOUBLE_EQ(snapshot.actual_speed_scaling, 0.5);
+    // The states are not in the recipe, they must not read as DISCONNECTED or any other real state
+    EXPECT_EQ(snapshot.robot_mode, RobotMode::UNKNOWN);
+    EXPECT_EQ(snapshot.safety_status, SafetyMode::UNKNOWN);
+    EXPECT_EQ(snapshot.runtime_state, TaskStatus::UNKNOWN);
+    io_interface.disconnect();
+}
+
+TEST(RtsiIOTest, handshake_protocol_rejected) {
+    FakeRtsiServer server;
+    server.setProtocolAccepted(false);
+    RtsiClientInterface client;
+    client.connect("127.0.0.1");
+    RtsiHandshakeResult result;
+    EXPECT_TRUE(client.handshake({"timestamp"}, 250, {"speed_slider_mask"}, result));
+    EXPECT_FALSE(result.protocol_accepted);
+    // The other replies are still pending, so the connection is closed
+    EXPECT_FALSE(client.isConnected());
+
+    // A fallback on a new connection reads its own replies
+    server.setProtocolAccepted(true);
+    client.connect("127.0.0.1");
+    EXPECT_TRUE(client.negotiateProtocolVersion());
+    EXPECT_EQ(client.getControllerVersion().minor, 14);
+    client.disconnect();
+}
+
+TEST(RtsiIOTest, auto_reconnect) {
+    writeFakeRecipes();
+    FakeRtsiServer server;
+    server.setDouble("speed_scaling", 0.5);
+    RtsiIOInterface io_interface("fake_output_recipe.txt", "fake_input_recipe.txt", 250);
+    std::mutex states_mutex;
+    std::vector<LinkState> states;
+    io_interface.setConnectionStateCallback([&](LinkState state) {
+        std::lock_guard<std::mutex> lock(states_mutex);
+        states.push_back(state);
+    });
+    io_interface.setAutoReconnect(true);
+    ASSERT_TRUE(io_interface.connectAsync("127.0.0.1").get());
+    EXPECT_EQ(io_interface.getConnectionState(), LinkState::CONNECTED);
+    // The input value is sent again after reconnect
+    EXPECT_TRUE(io_interface.setInputRecipeValue("speed_slider_mask", (uint32_t)1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_GE(server.inputPackages(), 1);
+
+    server.dropClient();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+    while (io_interface.getReconnectMetrics().reconnects < 1 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    ReconnectMetrics metrics = io_interface.getReconnectMetrics();
+    ASSERT_EQ(metrics.reconnects, 1);
+    EXPECT_EQ(server.connections(), 2);
+    EXPECT_GT(metrics.last_duration.count(), 0);
+    EXPECT_EQ(io_interface.getConnectionState(), LinkState::CONNECTED);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_GE(server.inputPackages(), 1);
+    EXPECT_DOUBLE_EQ(io_interface.getActualSpeedScaling(), 0.5);
+
+    io_interface.disconnect();
+    EXPECT_EQ(io_interface.getConnectionState(), LinkState::DISCONNECTED);
+    std::lock_guard<std::mutex> lock(states_mutex);
+    std::vector<LinkState> expected = {LinkState::CONNECTED, LinkState::RECONNECTING, LinkState::CONNECTED,
+                                       LinkState::DISCONNECTED};
+    EXPECT_EQ(states, expected);
+}
+
+TEST(RtsiIOTest, pipelined_connect) {
+    writeFakeRecipes();
+    FakeRtsiServer server;
+    server.setDouble("speed_scaling", 0.5);
+    RtsiIOInterface io_interface("fake_output_recipe.txt", "fake_input_recipe.txt", 250);
+    std::future<bool> connected = io_interface.connectAsync("127.0.0.1");
+    ASSERT_TRUE(connected.get());
+    // All five handshake requests are sent before the first reply
+    EXPECT_EQ(server.firstBurst(), 5);
+    EXPECT_TRUE(io_interface.isStarted());
+    EXPECT_EQ(io_interface.getControllerVersion().major, 2);
+    EXPECT_EQ(io_interface.getControllerVersion().build, 100);
+    EXPECT_DOUBLE_EQ(io_interface.getActualSpeedScaling(), 0.5);
+    EXPECT_GT(io_interface.getTimestamp(), 0);
+
+    RtsiConnectTimings timings = io_interface.getConnectTimings();
+    EXPECT_GT(timings.total.count(), 0);
+    EXPECT_GE(timings.total, timings.socket + timings.handshake + timings.first_data);
+    io_interface.disconnect();
+}
+
 
 
 TEST(RtsiIOTest, rw_io) {
@@ -22,6 +22,7 @@ enum Cmd{
     SET_TOOL_VOLTAGE = 2,
     START_FORCE_MODE = 3,
     END_FORCE_MODE = 4,
+    SET_SERVO_PARAMS = 5,
 };
 
 
@@ -171,6 +172,18 @@ TEST(ScriptCommandInterfaceTest, SendAndReceive) {
     int32_t end_force_mode_buffer[ScriptCommandInterface::SCRIPT_COMMAND_DATA_SIZE] = {0};
     end_force_mode_buffer[0] = htonl(Cmd::END_FORCE_MODE);
     ARRAY_EQUAL_ASSERT(buffer, end_force_mode_buffer);
+
+    // setServojParams() interface test
+    script_cmd->setServojParams(0.004, 0.1, 500);
+    memset(buffer, 0, sizeof(buffer));
+    recv_len = client->socket_ptr->read_some(boost::asio::buffer(buffer));
+    ASSERT_EQ(recv_len / sizeof(int32_t), ScriptCommandInterface::SCRIPT_COMMAND_DATA_SIZE);
+    int32_t set_servoj_params_buffer[ScriptCommandInterface::SCRIPT_COMMAND_DATA_SIZE] = {0};
+    set_servoj_params_buffer[0] = htonl(Cmd::SET_SERVO_PARAMS);
+    set_servoj_params_buffer[1] = htonl(4000);
+    set_servoj_params_buffer[2] = htonl(100000);
+    set_servoj_params_buffer[3] = htonl(500);
+    ARRAY_EQUAL_ASSERT(buffer, set_servoj_params_buffer);
 }
 
 int main(int argc, char** argv) {
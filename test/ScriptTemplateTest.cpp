@@ -0,0 +1,83 @@
+#include "Control/ScriptTemplate.hpp"
+#include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using namespace ELITE;
+
+static std::string s_script_file = "external_control.script";
+
+// The find-and-replace rendering used before the template
+static std::string replaceAll(std::string text, const std::string& from, const std::string& to) {
+    while (text.find(from) != std::string::npos) {
+        text.replace(text.find(from), from.length(), to);
+    }
+    return text;
+}
+
+TEST(ScriptTemplateTest, render) {
+    ScriptTemplate script("a = {{A}}\nb = {{B}}, {{A}}\n\nc = {{C}}");
+    EXPECT_EQ(script.slotCount(), 3);
+    EXPECT_TRUE(script.setValue("A", "1"));
+    EXPECT_TRUE(script.setValue("B", "two"));
+    EXPECT_FALSE(script.setValue("D", "4"));
+    // A placeholder without value is kept
+    EXPECT_EQ(script.render(), "a = 1\nb = two, 1\n\nc = {{C}}");
+    EXPECT_EQ(script.render("\t"), "\ta = 1\n\tb = two, 1\n\t\n\tc = {{C}}");
+    EXPECT_TRUE(script.setValue("C", "3.0"));
+    EXPECT_EQ(script.render(), "a = 1\nb = two, 1\n\nc = 3.0");
+}
+
+TEST(ScriptTemplateTest, no_placeholder) {
+    ScriptTemplate script("line 1\nline 2\n");
+    EXPECT_EQ(script.slotCount(), 0);
+    EXPECT_EQ(script.render(), "line 1\nline 2\n");
+    // No indent after the trailing newline
+    EXPECT_EQ(script.render("  "), "  line 1\n  line 2\n");
+    EXPECT_EQ(ScriptTemplate("").render("\t"), "");
+}
+
+TEST(ScriptTemplateTest, same_as_replace) {
+    std::ifstream ifs(s_script_file);
+    ASSERT_TRUE(ifs.is_open()) << "Script file not found: " << s_script_file;
+    std::string content((std::istreambuf_iterator<char>(ifs)), (std::istreambuf_iterator<char>()));
+    const std::vector<std::pair<std::string, std::string>> values = {
+        {"SERVER_IP_REPLACE", "192.168.1.2"},
+        {"REVERSE_PORT_REPLACE", "50001"},
+        {"TRAJECTORY_SERVER_PORT_REPLACE", "50003"},
+        {"SCRIPT_COMMAND_PORT_REPLACE", "50004"},
+        {"SERVO_J_TIME_REPLACE", "0.008"},
+        {"SERVO_J_LOOKAHEAD_TIME_REPLACE", "0.1"},
+        {"SERVO_J_GAIN_REPLACE", "300"},
+        {"STOP_J_REPLACE", "8.000000"},
+    };
+    ScriptTemplate script(content);
+    std::string expected = content;
+    for (auto& v : values) {
+        EXPECT_TRUE(script.setValue(v.first, v.second));
+        expected = replaceAll(expected, "{{" + v.first + "}}", v.second);
+    }
+    EXPECT_EQ(script.render(), expected);
+
+    // Headless mode indented every line
+    std::string indented;
+    std::istringstream stream(expected);
+    std::string line;
+    while (std::getline(stream, line)) {
+        indented += "\t" + line + "\n";
+    }
+    std::string rendered = script.render("\t");
+    if (!rendered.empty() && rendered.back() != '\n') {
+        rendered += '\n';
+    }
+    EXPECT_EQ(rendered, indented);
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 2) {
+        s_script_file = argv[1];
+    }
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+#include <cmath>
+
+#include "Elite/ServoInterpolator.hpp"
+
+using namespace ELITE;
+
+// The planned motion, a waypoint every 10 ms
+static vector6d_t motion(double t) {
+    return {0.5 * std::sin(2 * t), -1 + 0.3 * std::cos(3 * t), 1.2, 0.4 * t, 0.2 * std::sin(5 * t), 0};
+}
+
+static const double WAYPOINT_PERIOD = 0.01;
+
+static double distance(const vector6d_t& a, const vector6d_t& b) {
+    double sum = 0;
+    for (int j = 0; j < 6; j++) {
+        sum += (a[j] - b[j]) * (a[j] - b[j]);
+    }
+    return std::sqrt(sum);
+}
+
+// Runs the servo loop for 2 s. Each waypoint is added lead seconds before its time, unless drop says otherwise.
+// Returns the largest distance of a setpoint from the motion at its sample time.
+template <typename Drop>
+static double run(ServoInterpolator& interpolator, double lead, double latency, Drop drop) {
+    interpolator.reset(motion(0), 0);
+    size_t next_waypoint = 1;
+    double worst = 0;
+    for (int step = 1; step <= 500; step++) {
+        double now = step * 0.004;
+        while (next_waypoint * WAYPOINT_PERIOD - lead <= now) {
+            if (!drop(next_waypoint)) {
+                interpolator.addWaypoint(next_waypoint * WAYPOINT_PERIOD, motion(next_waypoint * WAYPOINT_PERIOD));
+            }
+            next_waypoint++;
+        }
+        vector6d_t setpoint;
+        EXPECT_TRUE(interpolator.sample(now, setpoint));
+        // Skip the start, where the interpolator accelerates from rest
+        if (step == 25) {
+            interpolator.resetMetrics();
+        }
+        if (step > 25) {
+            worst = std::max(worst, distance(setpoint, motion(now + latency)));
+        }
+    }
+    return worst;
+}
+
+TEST(ServoInterpolatorTest, upsample_follows_the_motion) {
+    ServoInterpolator quintic;
+    double error = run(quintic, 0.02, 0, [](size_t) { return false; });
+    EXPECT_LT(error, 1e-4);
+    ServoInterpolatorMetrics metrics = quintic.getMetrics();
+    EXPECT_EQ(metrics.samples, 475);
+    EXPECT_EQ(metrics.predicted, 0);
+    // The jerk of the motion itself peaks at about 27
+    EXPECT_LT(metrics.max_jerk, 40);
+
+    ServoInterpolatorOptions options;
+    options.spline = ServoSplineType::CUBIC;
+    ServoInterpolator cubic(options);
+    EXPECT_LT(run(cubic, 0.02, 0, [](size_t) { return false; }), 1e-4);
+    // The cubic spline has steps of acceleration at the waypoints
+    EXPECT_GT(cubic.getMetrics().max_jerk, metrics.max_jerk);
+}
+
+TEST(ServoInterpolatorTest, latency_is_sampled_ahead) {
+    ServoInterpolatorOptions options;
+    options.latency = 0.008;
+    ServoInterpolator interpolator(options);
+    EXPECT_LT(run(interpolator, 0.02, 0.008, [](size_t) { return false; }), 1e-4);
+
+    // Without the compensation the setpoints lag
+    ServoInterpolator lagging;
+    EXPECT_GT(run(lagging, 0.02, 0.008, [](size_t) { return false; }), 1e-3);
+}
+
+TEST(ServoInterpolatorTest, missing_waypoints) {
+    ServoInterpolator interpolator;
+    // Waypoints arrive just in time, and 3 in a row are lost
+    double error = run(interpolator, 0.0, 0, [](size_t i) { return i >= 100 && i < 103; });
+    ServoInterpolatorMetrics metrics = interpolator.getMetrics();
+    EXPECT_GT(metrics.predicted, 0);
+    EXPECT_GT(metrics.max_deviation, 0);
+    EXPECT_LT(metrics.max_deviation, 0.01);
+    EXPECT_LT(error, 0.01);
+
+    // The same waypoints without losses
+    ServoInterpolator reference;
+    run(reference, 0.0, 0, [](size_t) { return false; });
+    // Recovering from the gap costs some smoothness, but stays bounded
+    EXPECT_LT(metrics.max_jerk, 100 * reference.getMetrics().max_jerk + 1e3);
+}
+
+TEST(ServoInterpolatorTest, waypoint_order_and_next) {
+    ServoInterpolatorOptions options;
+    options.period = 0.002;
+    ServoInterpolator interpolator(options);
+    // No setpoint before the start, the output is left alone
+    vector6d_t setpoint = {1, 2, 3, 4, 5, 6};
+    EXPECT_FALSE(interpolator.sample(0, setpoint));
+    EXPECT_FALSE(interpolator.next(setpoint));
+    EXPECT_EQ(setpoint, vector6d_t({1, 2, 3, 4, 5, 6}));
+    EXPECT_TRUE(interpolator.addWaypoint(1.0, {0, 0, 0, 0, 0, 0}));
+    EXPECT_TRUE(interpolator.addWaypoint(1.1, {0.1, 0, 0, 0, 0, 0}));
+    EXPECT_FALSE(interpolator.addWaypoint(1.1, {0.2, 0, 0, 0, 0, 0}));
+    EXPECT_FALSE(interpolator.addWaypoint(1.05, {0.2, 0, 0, 0, 0, 0}));
+    // next() steps from the first waypoint at the period and reaches the second one after 50 steps
+    double previous = 0;
+    for (int i = 0; i < 50; i++) {
+        EXPECT_TRUE(interpolator.next(setpoint));
+        EXPECT_GE(setpoint[0], previous);
+        previous = setpoint[0];
+    }
+    EXPECT_NEAR(setpoint[0], 0.1, 1e-9);
+    EXPECT_EQ(interpolator.getMetrics().samples, 50);
+}
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
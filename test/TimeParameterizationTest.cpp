@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+#include "Elite/JointLimitValidator.hpp"
+#include "Elite/TimeParameterization.hpp"
+
+using namespace ELITE;
+
+static const vector6d_t MAX_VELOCITY = {1.0, 1.0, 1.5, 2.0, 2.0, 2.0};
+static const vector6d_t MAX_ACC = {2.0, 2.0, 3.0, 5.0, 5.0, 5.0};
+
+// Joint 0 from 0 to length, in count points
+static Vector6dBatch line(double length, size_t count) {
+    Vector6dBatch path(count);
+    for (size_t i = 0; i < count; i++) {
+        path.set(i, {length * i / (count - 1), -1, 1, 0, 0, 0});
+    }
+    return path;
+}
+
+static Vector6dBatch curve(size_t count) {
+    Vector6dBatch path(count);
+    const double pi = std::acos(-1.0);
+    for (size_t i = 0; i < count; i++) {
+        double s = (double)i / (count - 1);
+        path.set(i, {2 * s, 0.8 * std::sin(2 * pi * s), 1 - std::cos(pi * s), 0.5 * s, -0.3 * std::sin(4 * pi * s), 0});
+    }
+    return path;
+}
+
+static double total(const std::vector<double>& times) { return std::accumulate(times.begin(), times.end(), 0.0); }
+
+TEST(TimeParameterizationTest, straight_line_matches_bang_coast_bang) {
+    TimeParameterization timing(MAX_VELOCITY, MAX_ACC);
+    // Accelerate for 0.5 s, cruise at 1 rad/s, decelerate for 0.5 s
+    EXPECT_NEAR(total(timing.parameterize(line(2.0, 2001))), 2.5, 0.01);
+    // The same with only the ends given
+    std::vector<double> times = timing.parameterize(line(2.0, 2));
+    ASSERT_EQ(times.size(), 2);
+    EXPECT_EQ(times[0], 0);
+    EXPECT_NEAR(times[1], 2.5, 0.01);
+    // Too short to reach the velocity limit: 2 * sqrt(L / a)
+    EXPECT_NEAR(total(timing.parameterize(line(0.2, 2))), 2 * std::sqrt(0.1), 0.01);
+}
+
+TEST(TimeParameterizationTest, within_limits) {
+    TimeParameterization timing(MAX_VELOCITY, MAX_ACC);
+    Vector6dBatch path = curve(10000);
+    std::vector<double> times = timing.parameterize(path);
+    ASSERT_EQ(times.size(), path.size());
+
+    // The average velocity between points never exceeds a limit, and some joint is at its limit most of the way
+    double fastest = 0;
+    for (size_t i = 1; i < path.size(); i++) {
+        ASSERT_GT(times[i], 0);
+        double ratio = 0;
+        for (int j = 0; j < 6; j++) {
+            ratio = std::max(ratio, std::fabs(path.values[j][i] - path.values[j][i - 1]) / times[i] / MAX_VELOCITY[j]);
+        }
+        EXPECT_LE(ratio, 1 + 1e-9) << i;
+        fastest = std::max(fastest, ratio);
+    }
+    EXPECT_GT(fastest, 0.999);
+
+    // The servo stream passes the validator, with a little room for the finite differences of the samples
+    const double period = 0.004;
+    Vector6dBatch samples = timing.resample(path, period);
+    EXPECT_NEAR(samples.size() * period, total(times), period);
+    vector6d_t acc = MAX_ACC;
+    for (auto& a : acc) {
+        a *= 1.05;
+    }
+    vector6d_t velocity = MAX_VELOCITY;
+    for (auto& v : velocity) {
+        v *= 1.001;
+    }
+    vector6d_t limit_min, limit_max;
+    limit_min.fill(-10);
+    limit_max.fill(10);
+    JointLimitValidator validator(limit_min, limit_max, velocity, acc);
+    LimitViolation v = validator.validate(samples, period, path.get(0));
+    EXPECT_TRUE(v.isValid()) << (int)v.type << " at " << v.index << " joint " << v.joint << ": " << v.value;
+    for (int j = 0; j < 6; j++) {
+        EXPECT_EQ(samples.values[j].back(), path.values[j].back());
+    }
+}
+
+TEST(TimeParameterizationTest, repeated_points_and_options) {
+    Vector6dBatch path = line(1.0, 5);
+    // Point 2 twice
+    Vector6dBatch repeated(6);
+    for (size_t i = 0, k = 0; i < 5; i++) {
+        repeated.set(k++, path.get(i));
+        if (i == 2) {
+            repeated.set(k++, path.get(i));
+        }
+    }
+    TimeParameterization timing(MAX_VELOCITY, MAX_ACC);
+    std::vector<double> times = timing.parameterize(repeated);
+    EXPECT_EQ(times[3], 0);
+    EXPECT_NEAR(total(times), total(timing.parameterize(path)), 1e-9);
+
+    // Half the limits take longer
+    TimeParameterizationOptions options;
+    options.velocity_scale = 0.5;
+    options.acc_scale = 0.5;
+    TimeParameterization slow(MAX_VELOCITY, MAX_ACC, options);
+    EXPECT_GT(total(slow.parameterize(path)), 1.5 * total(times));
+
+    vector6d_t zero = MAX_ACC;
+    zero[3] = 0;
+    EXPECT_ANY_THROW(TimeParameterization(MAX_VELOCITY, zero));
+}
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "Elite/TrajectoryCompressor.hpp"
+
+using namespace ELITE;
+
+// Dense joint path: joint 0 moves linearly, joint 1 follows a sine
+static std::vector<TrajectoryWaypoint> sinePath(size_t count, double dt) {
+    std::vector<TrajectoryWaypoint> points(count);
+    for (size_t i = 0; i < count; i++) {
+        double s = (double)i / (count - 1);
+        points[i].positions = {s, 0.2 * std::sin(2 * std::acos(-1.0) * s), 0, 0, 0, 0};
+        points[i].time = (float)dt;
+    }
+    return points;
+}
+
+// Every input point must be within the tolerance of the polyline of the kept points
+static void expectWithinTolerance(const TrajectoryCompressor& compressor, const std::vector<TrajectoryWaypoint>& points,
+                                  const std::vector<size_t>& kept, double tolerance) {
+    for (size_t k = 0; k + 1 < kept.size(); k++) {
+        for (size_t i = kept[k]; i <= kept[k + 1]; i++) {
+            EXPECT_LE(compressor.deviation(points[i].positions, points[kept[k]].positions, points[kept[k + 1]].positions),
+                      tolerance);
+        }
+    }
+}
+
+TEST(TrajectoryCompressorTest, collinear) {
+    std::vector<TrajectoryWaypoint> points(1000);
+    for (size_t i = 0; i < points.size(); i++) {
+        points[i].positions = {i * 0.001, i * -0.002, 0.5, 0, 0, i * 0.0005};
+        points[i].time = 0.01f;
+    }
+    TrajectoryCompressor compressor;
+    auto result = compressor.compress(points);
+    ASSERT_EQ(result.size(), 2);
+    EXPECT_EQ(result.front().positions, points.front().positions);
+    EXPECT_EQ(result.back().positions, points.back().positions);
+    // The time of the removed points moves to the next kept point
+    EXPECT_NEAR(result.back().time, 999 * 0.01, 1e-3);
+    EXPECT_EQ(result.back().blend_radius, 0);
+}
+
+TEST(TrajectoryCompressorTest, joint_tolerance) {
+    auto points = sinePath(5000, 0.004);
+    TrajectoryCompressionOptions options;
+    options.tolerance = 0.001;
+    TrajectoryCompressor compressor(options);
+    auto kept = compressor.simplify(points);
+    EXPECT_EQ(kept.front(), 0);
+    EXPECT_EQ(kept.back(), points.size() - 1);
+    EXPECT_LT(kept.size(), points.size() / 20);
+    expectWithinTolerance(compressor, points, kept, options.tolerance / 2);
+
+    auto result = compressor.compress(points);
+    ASSERT_EQ(result.size(), kept.size());
+    double total = 0;
+    for (size_t k = 1; k < result.size(); k++) {
+        total += result[k].time;
+    }
+    EXPECT_NEAR(total, (points.size() - 1) * 0.004, 1e-3);
+    // Blends do not overlap
+    auto distance = [](const vector6d_t& a, const vector6d_t& b) {
+        double d2 = 0;
+        for (int i = 0; i < 6; i++) {
+            d2 += (a[i] - b[i]) * (a[i] - b[i]);
+        }
+        return std::sqrt(d2);
+    };
+    for (size_t k = 1; k + 1 < result.size(); k++) {
+        EXPECT_GT(result[k].blend_radius, 0);
+        double shorter = std::min(distance(result[k].positions, result[k - 1].positions),
+                                  distance(result[k].positions, result[k + 1].positions));
+        EXPECT_LE(result[k].blend_radius, options.max_blend_ratio * shorter * options.joint_blend_scale + 1e-6);
+    }
+}
+
+TEST(TrajectoryCompressorTest, parallel) {
+    auto points = sinePath(40000, 0.001);
+    TrajectoryCompressionOptions options;
+    options.tolerance = 0.0005;
+    options.parallel_threshold = 10000;
+    options.threads = 4;
+    TrajectoryCompressor parallel(options);
+    auto kept = parallel.simplify(points);
+    expectWithinTolerance(parallel, points, kept, options.tolerance / 2);
+    for (size_t k = 1; k < kept.size(); k++) {
+        EXPECT_GT(kept[k], kept[k - 1]);
+    }
+
+    options.threads = 1;
+    TrajectoryCompressor serial(options);
+    // The chunk boundaries cost at most a few points
+    EXPECT_LE(kept.size(), serial.simplify(points).size() + 2 * 4);
+}
+
+TEST(TrajectoryCompressorTest, cartesian_rotation) {
+    // A straight line with a fixed orientation, except a twist about z in the middle
+    std::vector<TrajectoryWaypoint> points(201);
+    for (size_t i = 0; i < points.size(); i++) {
+        double rz = (i == 100) ? 0.05 : 0.0;
+        points[i].positions = {0.3 + i * 0.001, 0.1, 0.4, 0, 0, rz};
+        points[i].time = 0.01f;
+    }
+    TrajectoryCompressionOptions options;
+    options.cartesian = true;
+    options.tolerance = 0.001;
+    options.rotation_tolerance = 0.01;
+    TrajectoryCompressor compressor(options);
+    auto kept = compressor.simplify(points);
+    EXPECT_NE(std::find(kept.begin(), kept.end(), 100), kept.end());
+
+    // Without the twist only the ends are kept
+    points[100].positions[5] = 0;
+    EXPECT_EQ(compressor.simplify(points).size(), 2);
+}
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -98,6 +98,46 @@ TEST(TRAJECTORY_INTERFACE, write_point) {
 
 }
 
+TEST(TRAJECTORY_INTERFACE, write_spline_point) {
+    std::unique_ptr<TrajectoryInterface> trajectory_ins = std::make_unique<TrajectoryInterface>(TRAJECTORY_INTERFACE_TEST_PORT);
+    std::unique_ptr<TcpClient> client = std::make_unique<TcpClient>();
+    // The server starts listening in its own thread
+    std::this_thread::sleep_for(50ms);
+
+    EXPECT_NO_THROW(client->connect("127.0.0.1", TRAJECTORY_INTERFACE_TEST_PORT));
+
+    std::this_thread::sleep_for(50ms);
+
+    vector6d_t positions = {0.5, -0.25, 1.0, -1.5, 0.125, 2.0};
+    vector6d_t velocities = {0.1, -0.2, 0.3, -0.4, 0.5, -0.6};
+    vector6d_t accelerations = {-1.0, 2.0, -3.0, 4.0, -5.0, 6.0};
+    int32_t buffer[TrajectoryInterface::TRAJECTORY_MESSAGE_LEN];
+
+    // Cubic, the accelerations are zero
+    EXPECT_TRUE(trajectory_ins->writeTrajectorySplinePoint(positions, velocities, 0.5));
+    int recv_len = boost::asio::read(*client->socket_ptr, boost::asio::buffer(buffer, sizeof(buffer)));
+    EXPECT_EQ(recv_len, sizeof(buffer));
+    for (int i = 0; i < 6; i++) {
+        EXPECT_EQ((int32_t)::htonl(buffer[i]), (int32_t)(positions[i] * CONTROL::POS_ZOOM_RATIO));
+        EXPECT_EQ((int32_t)::htonl(buffer[i + 6]), (int32_t)(velocities[i] * CONTROL::POS_ZOOM_RATIO));
+        EXPECT_EQ(::htonl(buffer[i + 12]), 0);
+    }
+    EXPECT_EQ(::htonl(buffer[18]), 0.5 * CONTROL::TIME_ZOOM_RATIO);
+    EXPECT_EQ(::htonl(buffer[19]), (int)TrajectorySplineType::CUBIC);
+    EXPECT_EQ(::htonl(buffer[20]), (int)TrajectoryMotionType::SPLINE);
+
+    // Quintic
+    EXPECT_TRUE(trajectory_ins->writeTrajectorySplinePoint(positions, velocities, accelerations, 0.5));
+    recv_len = boost::asio::read(*client->socket_ptr, boost::asio::buffer(buffer, sizeof(buffer)));
+    EXPECT_EQ(recv_len, sizeof(buffer));
+    for (int i = 0; i < 6; i++) {
+        EXPECT_EQ((int32_t)::htonl(buffer[i + 6]), (int32_t)(velocities[i] * CONTROL::POS_ZOOM_RATIO));
+        EXPECT_EQ((int32_t)::htonl(buffer[i + 12]), (int32_t)(accelerations[i] * CONTROL::POS_ZOOM_RATIO));
+    }
+    EXPECT_EQ(::htonl(buffer[19]), (int)TrajectorySplineType::QUINTIC);
+    EXPECT_EQ(::htonl(buffer[20]), (int)TrajectoryMotionType::SPLINE);
+}
+
 TEST(TRAJECTORY_INTERFACE, disconnect) { 
     std::unique_ptr<TrajectoryInterface> trajectory_ins;
 